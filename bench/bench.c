@@ -0,0 +1,567 @@
+/**
+ * \file bench.c
+ * \date 16 October 2026
+ * \brief Benchmarks of the control path.
+ *
+ * Every benchmark runs one function of the control path in a loop: the checksum, the static message schedules, packing the
+ * frames for the Panda, a whole control tick, and a whole loop (tick, send and receive) against the loopback transport.
+ * The number of iterations is calibrated so one run takes about BENCH_RUN_NS, the result is the median of all runs.
+ * The process is pinned to one CPU, and where the kernel allows it the cycles, instructions, branch and cache misses are
+ * counted with perf_event_open().
+ *
+ * The results are written as JSON, and can be compared with the results of another commit:
+ * \code
+ * make bench                                       Run all benchmarks, write bench/results.json
+ * make bench BENCH_BASELINE=old.json               Also compare with old.json, fail if a benchmark got slower
+ * bench/bench [-c <cpu>] [-n <runs>] [-f <Hz>] [-m <filter>] [-r <revision>] [-o <out.json>] [-b <baseline.json>] [-t <percent>]
+ * \endcode
+ * The control path is set up for the rate of -f, like driveCar -f, so the ramps and the schedules of 200 or 500 Hz are measured:
+ * \code
+ * make bench BENCH_ARGS="-f 500"
+ * \endcode
+ */
+
+#define _GNU_SOURCE     // sched_setaffinity() and strcasestr()
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "canFrame.h"
+#include "canRing.h"
+#include "canCache.h"
+#include "checksum.h"
+#include "control.h"
+#include "joystick.h"
+#include "panda.h"
+#include "profile.h"
+#include "toyotaRav4.h"
+#include "transport.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+#define DEFAULT_PROFILE     "profiles/toyotaRav4.profile"
+#define DEFAULT_RATE        100         //!< The default rate of the control loop in Hz, the default of driveCar.
+#define MAX_RATE            1000        //!< The highest rate of the control loop in Hz, as driveCar.
+#define BENCH_RUN_NS        10000000    //!< The target duration of one run.
+#define BENCH_RUNS          15          //!< The default number of runs per benchmark.
+#define BENCH_MAX_RUNS      101         //!< The maximum number of runs per benchmark.
+#define BENCH_MAX_RESULTS   32          //!< The maximum number of benchmarks, also in the baseline.
+#define BENCH_THRESHOLD     10.0        //!< The default slowdown in percent that counts as a regression.
+#define BENCH_COUNTERS      4           //!< The number of perf counters.
+#define BENCH_BATCH         64          //!< The number of frames of the batched benchmarks.
+#define BENCH_RX_RING       1024        //!< The size of the receive ring of the loop benchmark.
+
+/**
+ * \brief Defines one benchmark.
+ */
+typedef struct {
+    const char *name;                           //!< The name in the results.
+    void (*run)(uint64_t iterations);           //!< Run the benchmark a number of times.
+    const char *unit;                           //!< What one iteration is.
+} Benchmark;
+
+/**
+ * \brief Contains the result of one benchmark.
+ */
+typedef struct {
+    char name[64];                              //!< The name of the benchmark.
+    uint64_t iterations;                        //!< The number of iterations per run.
+    double median_ns;                           //!< The median time of one iteration.
+    double min_ns;                              //!< The fastest time of one iteration.
+    double max_ns;                              //!< The slowest time of one iteration.
+    double counters[BENCH_COUNTERS];            //!< The perf counters per iteration, negative if not available.
+} BenchResult;
+
+/**
+ * \brief Contains the perf counters, read as one group.
+ */
+typedef struct {
+    int fd[BENCH_COUNTERS];                     //!< The counters, -1 if not available. fd[0] is the group leader.
+    int available;                              //!< Whether the counters could be opened.
+} BenchCounters;
+
+static const char *counterNames[BENCH_COUNTERS] = {"cycles", "instructions", "branch_misses", "cache_misses"};
+static const uint64_t counterConfigs[BENCH_COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_BRANCH_MISSES,
+    PERF_COUNT_HW_CACHE_MISSES
+};
+
+/* The state shared by the benchmarks, set up once in main(). */
+static CANFrame frames[CONTROL_MAX_FRAMES];
+static FrameArena arena;
+static Control control;
+static Joystick js;
+static Transport loopback;
+static CANRing rx_ring;
+static CANRingReader rx_reader;
+static CANCache rx_cache;
+static ChecksumIdSet rx_checksum;
+static unsigned char packed[PANDA_TX_MAX_FRAMES * PANDA_FRAME_SIZE];
+static int tickLength;
+static uint32_t tick_us = 1000000 / DEFAULT_RATE;     //!< The period of the control loop, set with -f.
+static volatile uint64_t sink;  //!< Keeps the compiler from removing the benchmarked code.
+
+static uint64_t bench_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/* Fill the frames with the messages of a whole tick, with all buttons and axes in use. */
+static void bench_fill_frames(void) {
+    js.axes[0].x = 12000;
+    js.buttons[1] = 1;
+    control_setup(&control, 1, 1, tick_us);
+    tickLength = control_tick(&control, &js, &arena);
+    for(int i = 0; i < tickLength; i++)
+        arena_get(&arena, i, &frames[i]);
+    for(int i = tickLength; i < CONTROL_MAX_FRAMES; i++)
+        frames[i] = frames[i % tickLength];
+}
+
+static void bench_create_checksum(uint64_t iterations) {
+    uint64_t sum = 0;
+
+    for(uint64_t i = 0; i < iterations; i++)
+        sum += create_checksum(&frames[i % tickLength]);
+    sink = sum;
+}
+
+static void bench_checksum_fill(uint64_t iterations) {
+    for(uint64_t i = 0; i < iterations; i++)
+        checksum_toyota_fill(frames, BENCH_BATCH);
+    sink = frames[0].data[7];
+}
+
+static void bench_checksum_verify(uint64_t iterations) {
+    uint64_t sum = 0;
+
+    for(uint64_t i = 0; i < iterations; i++)
+        sum += checksum_toyota_verify(frames, BENCH_BATCH, sizeof(CANFrame), NULL);
+    sink = sum;
+}
+
+static void bench_static_cam(uint64_t iterations) {
+    uint64_t sum = 0;
+
+    for(uint64_t i = 0; i < iterations; i++) {
+        arena_reset(&arena);
+        sum += sendStaticCam(&arena, i);
+    }
+    sink = sum;
+}
+
+static void bench_static_dsu(uint64_t iterations) {
+    uint64_t sum = 0;
+
+    for(uint64_t i = 0; i < iterations; i++) {
+        arena_reset(&arena);
+        sum += sendStaticDsu(&arena, i);
+    }
+    sink = sum;
+}
+
+static void bench_static_video(uint64_t iterations) {
+    uint64_t sum = 0;
+
+    for(uint64_t i = 0; i < iterations; i++) {
+        arena_reset(&arena);
+        sum += sendStaticVideo(&arena, i);
+    }
+    sink = sum;
+}
+
+static void bench_pack_frames(uint64_t iterations) {
+    uint64_t sum = 0;
+
+    for(uint64_t i = 0; i < iterations; i++)
+        sum += panda_pack_frames(packed, frames, tickLength);
+    sink = sum;
+}
+
+static void bench_control_tick(uint64_t iterations) {
+    uint64_t sum = 0;
+
+    /* The counter of every tick, like pipeline_build(), so the messages keep their own cadence. */
+    for(uint64_t i = 0; i < iterations; i++) {
+        control.count = (uint32_t)i;
+        arena_reset(&arena);
+        sum += control_tick(&control, &js, &arena);
+    }
+    sink = sum;
+}
+
+/* One tick of the main loop: build the frames, send them, and handle everything that was received. */
+static void bench_loop(uint64_t iterations) {
+    const CANRxFrame *next;
+    uint64_t sum = 0;
+
+    for(uint64_t i = 0; i < iterations; i++) {
+        control.count = (uint32_t)i;
+        control_tick(&control, &js, &arena);
+        transport_send_arena(&loopback, &arena);
+        while((next = canring_peek(&rx_reader)) != NULL) {
+            sum += next->frame.ID;
+            canring_release(&rx_reader);
+        }
+    }
+    sink = sum;
+}
+
+static const Benchmark benchmarks[] = {
+    {"create_checksum",         bench_create_checksum,  "frame"},
+    {"checksum_toyota_fill",    bench_checksum_fill,    "64 frames"},
+    {"checksum_toyota_verify",  bench_checksum_verify,  "64 frames"},
+    {"sendStaticCam",           bench_static_cam,       "tick"},
+    {"sendStaticDsu",           bench_static_dsu,       "tick"},
+    {"sendStaticVideo",         bench_static_video,     "tick"},
+    {"panda_pack_frames",       bench_pack_frames,      "tick"},
+    {"control_tick",            bench_control_tick,     "tick"},
+    {"loop_loopback",           bench_loop,             "tick"}
+};
+
+static int bench_pin(int cpu) {
+    cpu_set_t set;
+
+    if(cpu < 0) {
+        /* The last CPU we are allowed on, the first one usually handles the most interrupts. */
+        if(sched_getaffinity(0, sizeof(set), &set) < 0)
+            return -1;
+        for(int i = CPU_SETSIZE - 1; i >= 0; i--) {
+            if(CPU_ISSET(i, &set)) {
+                cpu = i;
+                break;
+            }
+        }
+    }
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if(sched_setaffinity(0, sizeof(set), &set) < 0)
+        return -1;
+
+    return cpu;
+}
+
+static void bench_counters_open(BenchCounters *bc) {
+    struct perf_event_attr attr;
+
+    bc->available = 0;
+    for(int i = 0; i < BENCH_COUNTERS; i++) {
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = counterConfigs[i];
+        attr.disabled = (i == 0);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+
+        bc->fd[i] = syscall(SYS_perf_event_open, &attr, 0, -1, (i == 0) ? -1 : bc->fd[0], 0);
+        if(i == 0 && bc->fd[0] < 0)
+            return;
+    }
+    bc->available = 1;
+}
+
+static void bench_counters_close(BenchCounters *bc) {
+    for(int i = 0; bc->available && i < BENCH_COUNTERS; i++) {
+        if(bc->fd[i] >= 0)
+            close(bc->fd[i]);
+    }
+}
+
+static void bench_counters_start(BenchCounters *bc) {
+    if(!bc->available)
+        return;
+    ioctl(bc->fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(bc->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+/* Add the counts since bench_counters_start() to values, a counter that could not be opened becomes negative. */
+static void bench_counters_stop(BenchCounters *bc, double values[]) {
+    uint64_t buffer[1 + BENCH_COUNTERS];
+    int n = 0;
+
+    if(!bc->available) {
+        for(int i = 0; i < BENCH_COUNTERS; i++)
+            values[i] = -1;
+        return;
+    }
+
+    ioctl(bc->fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    if(read(bc->fd[0], buffer, sizeof(buffer)) < (ssize_t)sizeof(uint64_t))
+        buffer[0] = 0;
+
+    for(int i = 0; i < BENCH_COUNTERS; i++) {
+        if(bc->fd[i] < 0 || n >= (int)buffer[0])
+            values[i] = -1;
+        else if(values[i] >= 0)
+            values[i] += buffer[1 + n++];
+    }
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+static void bench_run(const Benchmark *b, BenchCounters *bc, int runs, BenchResult *result) {
+    double times[BENCH_MAX_RUNS];
+    uint64_t iterations = 1;
+    uint64_t start, elapsed;
+
+    /* Calibrate, also warms up the caches and the branch predictor. */
+    while(1) {
+        start = bench_now();
+        b->run(iterations);
+        elapsed = bench_now() - start;
+        if(elapsed >= BENCH_RUN_NS / 2 || iterations >= (1ULL << 40))
+            break;
+        iterations *= (elapsed < BENCH_RUN_NS / 64) ? 8 : 2;
+    }
+    iterations = (elapsed > 0) ? iterations * BENCH_RUN_NS / elapsed : iterations;
+    if(iterations == 0)
+        iterations = 1;
+
+    memset(result, 0, sizeof(BenchResult));
+    snprintf(result->name, sizeof(result->name), "%s", b->name);
+    result->iterations = iterations;
+
+    for(int r = 0; r < runs; r++) {
+        bench_counters_start(bc);
+        start = bench_now();
+        b->run(iterations);
+        elapsed = bench_now() - start;
+        bench_counters_stop(bc, result->counters);
+        times[r] = (double)elapsed / iterations;
+    }
+
+    for(int i = 0; i < BENCH_COUNTERS; i++) {
+        if(result->counters[i] >= 0)
+            result->counters[i] /= (double)iterations * runs;
+    }
+
+    qsort(times, runs, sizeof(double), compare_doubles);
+    result->median_ns = times[runs / 2];
+    result->min_ns = times[0];
+    result->max_ns = times[runs - 1];
+}
+
+static void bench_print(const Benchmark *b, const BenchResult *r) {
+    printf("%-24s %12.1f %12.1f %12.1f", r->name, r->median_ns, r->min_ns, r->max_ns);
+    if(r->counters[0] >= 0 && r->counters[1] >= 0)
+        printf(" %10.0f %10.0f %6.2f", r->counters[0], r->counters[1],
+               (r->counters[0] > 0) ? r->counters[1] / r->counters[0] : 0.0);
+    printf("   /%s\n", b->unit);
+}
+
+static int bench_write(const char *path, const char *revision, int cpu, int runs, const BenchResult results[], int n) {
+    FILE *f = fopen(path, "w");
+
+    if(f == NULL) {
+        terminalColor(31);
+        printf("Could not write %s\n", path);
+        terminalColor(0);
+        return -1;
+    }
+
+    fprintf(f, "{\"revision\": \"%s\", \"cpu\": %d, \"runs\": %d, \"rate_hz\": %u, \"benchmarks\": [\n", revision, cpu, runs,
+            1000000 / tick_us);
+    for(int i = 0; i < n; i++) {
+        fprintf(f, "  {\"name\": \"%s\", \"ns_per_op\": %.3f, \"min_ns\": %.3f, \"max_ns\": %.3f, \"iterations\": %llu",
+                results[i].name, results[i].median_ns, results[i].min_ns, results[i].max_ns,
+                (unsigned long long)results[i].iterations);
+        for(int k = 0; k < BENCH_COUNTERS; k++) {
+            if(results[i].counters[k] >= 0)
+                fprintf(f, ", \"%s\": %.3f", counterNames[k], results[i].counters[k]);
+            else
+                fprintf(f, ", \"%s\": null", counterNames[k]);
+        }
+        fprintf(f, "}%s\n", (i < n - 1) ? "," : "");
+    }
+    fprintf(f, "]}\n");
+
+    fclose(f);
+    return 0;
+}
+
+/* Read a file written by bench_write(), one benchmark per line. */
+static int bench_read(const char *path, BenchResult results[]) {
+    FILE *f = fopen(path, "r");
+    char line[1024];
+    int n = 0;
+
+    if(f == NULL) {
+        terminalColor(31);
+        printf("Could not read %s\n", path);
+        terminalColor(0);
+        return -1;
+    }
+
+    while(n < BENCH_MAX_RESULTS && fgets(line, sizeof(line), f) != NULL) {
+        if(sscanf(line, " {\"name\": \"%63[^\"]\", \"ns_per_op\": %lf", results[n].name, &results[n].median_ns) == 2)
+            n++;
+    }
+
+    fclose(f);
+    return n;
+}
+
+/* Compare with a baseline, returns the number of regressions. */
+static int bench_compare(const char *path, const BenchResult results[], int n, double threshold) {
+    BenchResult baseline[BENCH_MAX_RESULTS];
+    int nrBaseline = bench_read(path, baseline);
+    int regressions = 0;
+    double change;
+
+    if(nrBaseline < 0)
+        return -1;
+
+    printf("\nCompared with %s (threshold %.1f%%)\n", path, threshold);
+    for(int i = 0; i < n; i++) {
+        for(int k = 0; k < nrBaseline; k++) {
+            if(strcmp(results[i].name, baseline[k].name) != 0 || baseline[k].median_ns <= 0)
+                continue;
+
+            change = (results[i].median_ns - baseline[k].median_ns) * 100.0 / baseline[k].median_ns;
+            if(change > threshold) {
+                regressions++;
+                terminalColor(31);
+            } else if(change < -threshold) {
+                terminalColor(32);
+            }
+            printf("%-24s %12.1f -> %12.1f ns  %+7.1f%%\n", results[i].name, baseline[k].median_ns, results[i].median_ns, change);
+            terminalColor(0);
+        }
+    }
+
+    return regressions;
+}
+
+static int bench_setup(void) {
+    static VehicleProfile profile;
+
+    if(profile_load(&profile, DEFAULT_PROFILE, tick_us) < 0)
+        return -1;
+    if(setupToyotaRav4(&profile) < 0 || arena_init(&arena) < 0)
+        return -1;
+
+    bench_fill_frames();
+
+    if(transport_open(&loopback, "loopback") < 0)
+        return -1;
+    if(canring_setup(&rx_ring, BENCH_RX_RING) < 0)
+        return -1;
+    cancache_setup(&rx_cache);
+    setupToyotaRav4Checksums(&rx_checksum);
+    transport_rx_verify(&loopback, &rx_checksum);
+    canring_reader_setup(&rx_reader, &rx_ring);
+
+    return transport_rx_start(&loopback, &rx_ring, &rx_cache);
+}
+
+int main(int argc, char *argv[]) {
+    BenchResult results[BENCH_MAX_RESULTS];
+    BenchCounters counters;
+    const char *output = NULL, *baseline = NULL, *filter = NULL, *revision = "";
+    double threshold = BENCH_THRESHOLD;
+    int runs = BENCH_RUNS;
+    int cpu = -1;
+    int n = 0;
+    int ret = 0;
+    long rate;
+    char *end;
+    int opt;
+
+    while((opt = getopt(argc, argv, "c:n:f:m:r:o:b:t:")) != -1) {
+        switch(opt) {
+            case 'c': cpu = atoi(optarg); break;
+            case 'n': runs = atoi(optarg); break;
+            case 'f':
+                rate = strtol(optarg, &end, 10);
+                if(*end != '\0' || rate <= 0 || rate > MAX_RATE) {
+                    terminalColor(31);
+                    printf("The rate must be 1 to %d Hz\n", MAX_RATE);
+                    terminalColor(0);
+                    return 2;
+                }
+                tick_us = 1000000 / rate;
+                break;
+            case 'm': filter = optarg; break;
+            case 'r': revision = optarg; break;
+            case 'o': output = optarg; break;
+            case 'b': baseline = optarg; break;
+            case 't': threshold = atof(optarg); break;
+            default:
+                printf("%s [-c <cpu>] [-n <runs>] [-f <Hz>] [-m <filter>] [-r <revision>] [-o <out.json>] [-b <baseline.json>] [-t <percent>]\n",
+                       argv[0]);
+                return 2;
+        }
+    }
+    if(runs < 1 || runs > BENCH_MAX_RUNS)
+        runs = BENCH_RUNS;
+
+    cpu = bench_pin(cpu);
+    if(cpu < 0) {
+        terminalColor(31);
+        printf("Could not pin to a CPU, results will be noisy\n");
+        terminalColor(0);
+    }
+
+    if(bench_setup() < 0) {
+        terminalColor(31);
+        printf("Could not set up the benchmarks\n");
+        terminalColor(0);
+        return 2;
+    }
+
+    bench_counters_open(&counters);
+    printf("CPU %d, %d runs, %u Hz, perf counters %s\n", cpu, runs, 1000000 / tick_us, counters.available ? "enabled" : "not available");
+    printf("%-24s %12s %12s %12s %10s %10s %6s\n", "benchmark", "median ns", "min ns", "max ns", "cycles", "instr", "IPC");
+
+    for(unsigned int i = 0; i < ARRAY_LENGTH(benchmarks) && n < BENCH_MAX_RESULTS; i++) {
+        if(filter != NULL && strcasestr(benchmarks[i].name, filter) == NULL)
+            continue;
+
+        bench_run(&benchmarks[i], &counters, runs, &results[n]);
+        bench_print(&benchmarks[i], &results[n]);
+        n++;
+    }
+
+    bench_counters_close(&counters);
+    transport_close(&loopback);
+    canring_free(&rx_ring);
+    arena_free(&arena);
+    closeToyotaRav4();
+
+    if(output != NULL && bench_write(output, revision, cpu, runs, results, n) < 0)
+        ret = 2;
+    if(baseline != NULL) {
+        int regressions = bench_compare(baseline, results, n, threshold);
+
+        if(regressions < 0) {
+            ret = 2;
+        } else if(regressions > 0) {
+            terminalColor(31);
+            printf("%d benchmark(s) got slower\n", regressions);
+            terminalColor(0);
+            ret = (ret != 0) ? ret : 1;
+        }
+    }
+
+    return ret;
+}
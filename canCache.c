@@ -0,0 +1,69 @@
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "canCache.h"
+
+_Static_assert(sizeof(CANCacheSlot) == 64, "A cache slot must be one cache line");
+
+void cancache_setup(CANCache *c) {
+    memset(c, 0, sizeof(CANCache));
+}
+
+static inline CANCacheSlot *cancache_slot(const CANCache *c, uint8_t bus, uint16_t id) {
+    uint8_t echo = (bus & CAN_BUS_RETURNED) != 0;
+
+    bus &= ~CAN_BUS_RETURNED;
+    if(bus >= CAN_CACHE_BUSSES)
+        return NULL;
+
+    return (CANCacheSlot*)&c->slots[echo][bus][id & (CAN_CACHE_SIZE - 1)];
+}
+
+void cancache_update(CANCache *c, const CANRxFrame *rx) {
+    CANCacheSlot *slot = cancache_slot(c, rx->frame.bus, rx->frame.ID);
+    uint32_t seq;
+
+    if(slot == NULL) {
+        atomic_fetch_add_explicit(&c->uncached, 1, memory_order_relaxed);
+        return;
+    }
+
+    seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    slot->length = rx->frame.length;
+    memcpy(slot->data, rx->frame.data, 8);
+    slot->timestamp_ns = rx->timestamp_ns;
+
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+}
+
+uint32_t cancache_read(const CANCache *c, uint8_t bus, uint16_t id, CANRxFrame *rx) {
+    const CANCacheSlot *slot = cancache_slot(c, bus, id);
+    uint32_t seq1, seq2;
+
+    if(slot == NULL)
+        return 0;
+
+    do {
+        seq1 = atomic_load_explicit((_Atomic uint32_t *)&slot->seq, memory_order_acquire);
+        if(seq1 == 0)
+            return 0;
+
+        rx->frame.ID = id;
+        rx->frame.bus = bus;
+        rx->frame.length = slot->length;
+        rx->frame.freq = 0;
+        memcpy(rx->frame.data, slot->data, 8);
+        rx->timestamp_ns = slot->timestamp_ns;
+        rx->device_time = 0;
+
+        atomic_thread_fence(memory_order_acquire);
+        seq2 = atomic_load_explicit((_Atomic uint32_t *)&slot->seq, memory_order_relaxed);
+    } while((seq1 & 1) || seq1 != seq2);
+
+    return seq1 / 2;
+}
@@ -0,0 +1,63 @@
+/**
+ * \file canCache.h
+ * \date 16 October 2026
+ * \brief File containing the cache of the latest received frame of every CAN ID on every bus.
+ *
+ * This file contains the function declarations of a table with one slot per 11 bit CAN ID, per bus.
+ * The receive path writes every frame in its slot, the control code reads the newest value of an ID without searching.
+ * The echoes of sent frames (CAN_BUS_RETURNED) have their own slots, so they never hide a frame of the car with the same ID.
+ * Frames of a bus from CAN_CACHE_BUSSES on are not cached.
+ */
+
+#ifndef CAN_CACHE
+#define CAN_CACHE
+    #include <stdint.h>
+    #include <stdatomic.h>
+    #include "canFrame.h"
+
+    #define CAN_CACHE_SIZE      2048    //!< One slot for every 11 bit CAN ID.
+    #define CAN_CACHE_BUSSES    12      //!< The number of busses that are cached, all logical busses of a pool (PANDA_POOL_MAX_BUSSES).
+
+    /**
+     * \brief Defines the slot of one CAN ID, exactly one cache line.
+     *
+     * The slot is protected by a seqlock: the sequence is odd while the slot is written.
+     */
+    typedef struct {
+        _Atomic uint32_t seq;   //!< The seqlock sequence, also the number of updates times 2.
+        uint8_t length;         //!< The number of data bytes.
+        uint8_t data[8];        //!< The data of the newest frame.
+        uint64_t timestamp_ns;  //!< The CLOCK_MONOTONIC time the newest frame was received.
+    } __attribute__((aligned(64))) CANCacheSlot;
+
+    /**
+     * \brief Defines the cache, indexed by echo, bus and CAN ID.
+     */
+    typedef struct {
+        CANCacheSlot slots[2][CAN_CACHE_BUSSES][CAN_CACHE_SIZE];   //!< The slots of the received frames [0] and the echoes [1].
+        _Atomic uint64_t uncached;                                  //!< The number of frames on a bus that is not cached.
+    } CANCache;
+
+    /**
+     * \fn void cancache_setup(CANCache *c)
+     * \brief Clear the cache.
+     * \param c Pointer to CANCache struct.
+     *
+     * \fn void cancache_update(CANCache *c, const CANRxFrame *rx)
+     * \brief Store a received frame. Only to be called by the receive path (one writer per bus).
+     * \param c Pointer to CANCache struct.
+     * \param rx The received frame.
+     *
+     * \fn uint32_t cancache_read(const CANCache *c, uint8_t bus, uint16_t id, CANRxFrame *rx)
+     * \brief Get the newest frame of an ID, never blocks the writer.
+     * \param c Pointer to CANCache struct.
+     * \param bus The bus, with CAN_BUS_RETURNED set to read the echo of a sent frame.
+     * \param id The CAN ID to read.
+     * \param rx The newest frame of the ID.
+     * \return The number of frames received with this ID on this bus (0: never received, rx is not set).
+     */
+
+    void cancache_setup(CANCache *c);
+    void cancache_update(CANCache *c, const CANRxFrame *rx);
+    uint32_t cancache_read(const CANCache *c, uint8_t bus, uint16_t id, CANRxFrame *rx);
+#endif
@@ -0,0 +1,43 @@
+/**
+ * \file canFrame.h
+ * \date 16 October 2026
+ * \brief File containing the device independent CAN frame definitions.
+ *
+ * This file contains the definition of the CANFrame struct, as well as the received variant with timestamps.
+ */
+
+#ifndef CAN_FRAME
+#define CAN_FRAME
+    #include <stdint.h>
+
+    /**
+     * \brief Defines a standard CAN frame
+     *
+     * This struct defines a standard CAN frame, so that the software can be used with different CAN devices with different drivers.
+     *
+     */
+    typedef struct {
+        uint16_t ID;        //!< The CAN frame ID.
+        uint8_t data[8];    //!< The Data sent with the frame, max. 8 Bytes.
+        uint8_t bus;        //!< Which bus to send the data on. For using multiple CAN busses.
+        uint8_t length;     //!< The number of bytes te be sent.
+        uint16_t freq;      //!< How frequent to send the frame.
+    } CANFrame;
+
+    #define CAN_BUS_RETURNED 0x80   //!< Set in the bus of a received frame that is the echo of a frame we sent.
+
+    #define CAN_RX_CHECKSUM_ERROR 0x01  //!< Set in the flags of a received frame of which the checksum is wrong.
+
+    /**
+     * \brief Defines a received CAN frame
+     *
+     * This struct contains a received CAN frame, together with the time it was received.
+     * The bus of the frame has CAN_BUS_RETURNED set when it is the echo of a sent frame.
+     */
+    typedef struct {
+        CANFrame frame;         //!< The received frame.
+        uint16_t device_time;   //!< The timestamp of the CAN device, in its own units.
+        uint8_t flags;          //!< The CAN_RX_ flags of the frame.
+        uint64_t timestamp_ns;  //!< The CLOCK_MONOTONIC time the frame was received, in ns.
+    } CANRxFrame;
+#endif
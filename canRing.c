@@ -0,0 +1,95 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "canRing.h"
+
+int canring_setup(CANRing *r, uint32_t capacity) {
+    uint32_t size = 1;
+
+    while(size < capacity)
+        size <<= 1;
+
+    r->slots = aligned_alloc(64, size * sizeof(CANRingSlot));
+    if(r->slots == NULL)
+        return -1;
+
+    memset(r->slots, 0, size * sizeof(CANRingSlot));
+    r->mask = size - 1;
+    r->dropped = 0;
+    atomic_init(&r->head, 0);
+
+    return 0;
+}
+
+void canring_free(CANRing *r) {
+    free(r->slots);
+    r->slots = NULL;
+}
+
+CANRxFrame *canring_claim(CANRing *r) {
+    uint64_t pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+    CANRingSlot *slot = &r->slots[pos & r->mask];
+
+    atomic_store_explicit(&slot->seq, 2 * pos + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    return &slot->rx;
+}
+
+void canring_publish(CANRing *r) {
+    uint64_t pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+    CANRingSlot *slot = &r->slots[pos & r->mask];
+
+    atomic_store_explicit(&slot->seq, 2 * (pos + 1), memory_order_release);
+    atomic_store_explicit(&r->head, pos + 1, memory_order_release);
+}
+
+void canring_reader_setup(CANRingReader *rd, CANRing *r) {
+    rd->ring = r;
+    rd->pos = atomic_load_explicit(&r->head, memory_order_acquire);
+    rd->overruns = 0;
+}
+
+const CANRxFrame *canring_peek(CANRingReader *rd) {
+    CANRing *r = rd->ring;
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    uint64_t capacity = (uint64_t)r->mask + 1;
+    CANRingSlot *slot;
+
+    if(head - rd->pos > capacity) {
+        /* Lapped by the producer, skip to the middle of the ring to get some slack. */
+        rd->overruns += head - capacity / 2 - rd->pos;
+        rd->pos = head - capacity / 2;
+    }
+
+    while(rd->pos != head) {
+        slot = &r->slots[rd->pos & r->mask];
+        if(atomic_load_explicit(&slot->seq, memory_order_acquire) == 2 * (rd->pos + 1))
+            return &slot->rx;
+
+        /* Overwritten since head was read. */
+        rd->overruns++;
+        rd->pos++;
+    }
+
+    return NULL;
+}
+
+int canring_release(CANRingReader *rd) {
+    CANRing *r = rd->ring;
+    CANRingSlot *slot = &r->slots[rd->pos & r->mask];
+    uint64_t seq;
+
+    atomic_thread_fence(memory_order_acquire);
+    seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    rd->pos++;
+
+    if(seq != 2 * rd->pos) {
+        rd->overruns++;
+        return -1;
+    }
+
+    return 0;
+}
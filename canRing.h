@@ -0,0 +1,94 @@
+/**
+ * \file canRing.h
+ * \date 16 October 2026
+ * \brief File containing the lock-free ring buffer for received CAN frames.
+ *
+ * This file contains the function declarations of a single producer, multiple consumer ring buffer.
+ * The receive path writes the frames straight into the ring, and every reader gets pointers into the ring,
+ * so no frame is copied after it is decoded.
+ */
+
+#ifndef CAN_RING
+#define CAN_RING
+    #include <stdint.h>
+    #include <stdatomic.h>
+    #include "canFrame.h"
+
+    /**
+     * \brief Defines one slot of the ring.
+     *
+     * The sequence is odd while the producer writes the slot, and 2 * (position + 1) when the frame at position is complete.
+     */
+    typedef struct {
+        _Atomic uint64_t seq;   //!< The sequence of the slot.
+        CANRxFrame rx;          //!< The received frame.
+    } CANRingSlot;
+
+    /**
+     * \brief Defines the ring buffer.
+     *
+     * The producer never waits for the readers. A reader that falls more than the capacity behind, is moved forward
+     * and the frames it lost are counted as overruns.
+     */
+    typedef struct {
+        CANRingSlot *slots;                     //!< The slots of the ring.
+        uint32_t mask;                          //!< The capacity of the ring minus one (the capacity is a power of 2).
+        _Alignas(64) _Atomic uint64_t head;     //!< The number of published frames.
+        _Alignas(64) uint64_t dropped;          //!< Frames the producer could not store (written by the producer only).
+    } CANRing;
+
+    /**
+     * \brief Defines one reader of the ring. Every consumer has its own reader.
+     */
+    typedef struct {
+        CANRing *ring;          //!< The ring that is read.
+        uint64_t pos;           //!< The position of the next frame to read.
+        uint64_t overruns;      //!< The number of frames this reader lost because it was too slow.
+    } CANRingReader;
+
+    /**
+     * \fn int canring_setup(CANRing *r, uint32_t capacity)
+     * \brief Allocate the ring.
+     * \param r Pointer to CANRing struct.
+     * \param capacity The number of frames in the ring, rounded up to a power of 2.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void canring_free(CANRing *r)
+     * \brief Free the ring.
+     * \param r Pointer to CANRing struct.
+     *
+     * \fn CANRxFrame *canring_claim(CANRing *r)
+     * \brief Get the next slot to write a frame in. Only to be used by the producer.
+     * \param r Pointer to CANRing struct.
+     * \return The frame to fill in, followed by canring_publish().
+     *
+     * \fn void canring_publish(CANRing *r)
+     * \brief Make the claimed frame visible to the readers.
+     * \param r Pointer to CANRing struct.
+     *
+     * \fn void canring_reader_setup(CANRingReader *rd, CANRing *r)
+     * \brief Setup a reader, it starts at the newest frame.
+     * \param rd Pointer to CANRingReader struct.
+     * \param r The ring to read.
+     *
+     * \fn const CANRxFrame *canring_peek(CANRingReader *rd)
+     * \brief Get the next frame without copying it.
+     * \param rd Pointer to CANRingReader struct.
+     * \return The next frame, NULL if there is none.
+     *
+     * \fn int canring_release(CANRingReader *rd)
+     * \brief Done with the frame of canring_peek(), move to the next one.
+     * \param rd Pointer to CANRingReader struct.
+     * \return 0: Success
+     * \return <0: The frame was overwritten while it was read, and should be ignored.
+     */
+
+    int canring_setup(CANRing *r, uint32_t capacity);
+    void canring_free(CANRing *r);
+    CANRxFrame *canring_claim(CANRing *r);
+    void canring_publish(CANRing *r);
+    void canring_reader_setup(CANRingReader *rd, CANRing *r);
+    const CANRxFrame *canring_peek(CANRingReader *rd);
+    int canring_release(CANRingReader *rd);
+#endif
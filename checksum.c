@@ -0,0 +1,203 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "checksum.h"
+
+#define CHECKSUM_CHUNK          64      //!< The number of sums calculated at once.
+#define CHECKSUM_LENGTH_OFFSET  11      //!< The byte of a CANFrame containing the length.
+
+_Static_assert(offsetof(CANFrame, ID) == 0 && offsetof(CANFrame, data) == 2 &&
+               offsetof(CANFrame, length) == CHECKSUM_LENGTH_OFFSET, "The masks depend on the layout of CANFrame");
+
+/**
+ * \brief Function that sums the checksum bytes of frames.
+ *
+ * The frames start at base, stride bytes apart. A frame may only be read with 16 bytes at once, when these bytes end before end.
+ */
+typedef void (*SumFunction)(const uint8_t *base, int length, size_t stride, const uint8_t *end, uint16_t sums[]);
+
+/* The bytes of a CANFrame that are added, for every length: both ID bytes, the data without the checksum byte and the length. */
+static const uint8_t masks[9][16] __attribute__((aligned(16))) = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00},
+    {0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00},
+    {0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00},
+    {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00},
+    {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00},
+    {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00},
+    {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00},
+    {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00}
+};
+
+static inline const uint8_t *frame_mask(const uint8_t *frame) {
+    uint8_t length = frame[CHECKSUM_LENGTH_OFFSET];
+    return masks[length <= 8 ? length : 0];
+}
+
+static void sums_scalar(const uint8_t *base, int length, size_t stride, const uint8_t *end, uint16_t sums[]) {
+    const uint8_t *frame, *mask;
+    uint16_t sum;
+
+    for(int i = 0; i < length; i++) {
+        frame = base + i * stride;
+        mask = frame_mask(frame);
+        sum = 0;
+        for(int k = 0; k <= CHECKSUM_LENGTH_OFFSET; k++)
+            sum += frame[k] & mask[k];
+        sums[i] = sum;
+    }
+}
+
+#if defined(__SSE2__)
+static void sums_sse2(const uint8_t *base, int length, size_t stride, const uint8_t *end, uint16_t sums[]) {
+    const __m128i zero = _mm_setzero_si128();
+    const uint8_t *frame;
+    __m128i v;
+    int i;
+
+    for(i = 0; i < length; i++) {
+        frame = base + i * stride;
+        if(frame + 16 > end)
+            break;
+
+        v = _mm_and_si128(_mm_loadu_si128((const __m128i*)frame), _mm_load_si128((const __m128i*)frame_mask(frame)));
+        v = _mm_sad_epu8(v, zero);
+        sums[i] = _mm_cvtsi128_si32(v) + _mm_extract_epi16(v, 4);
+    }
+
+    sums_scalar(base + i * stride, length - i, stride, end, sums + i);
+}
+
+__attribute__((target("avx2")))
+static void sums_avx2(const uint8_t *base, int length, size_t stride, const uint8_t *end, uint16_t sums[]) {
+    const __m256i zero = _mm256_setzero_si256();
+    const uint8_t *frame;
+    __m256i v, m;
+    int i;
+
+    /* Two frames per register, every frame gives two partial sums. */
+    for(i = 0; i + 1 < length; i += 2) {
+        frame = base + i * stride;
+        if(frame + stride + 16 > end)
+            break;
+
+        v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)frame)),
+                                    _mm_loadu_si128((const __m128i*)(frame + stride)), 1);
+        m = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_load_si128((const __m128i*)frame_mask(frame))),
+                                    _mm_load_si128((const __m128i*)frame_mask(frame + stride)), 1);
+        v = _mm256_sad_epu8(_mm256_and_si256(v, m), zero);
+        v = _mm256_add_epi64(v, _mm256_srli_si256(v, 8));
+        sums[i] = _mm256_extract_epi16(v, 0);
+        sums[i + 1] = _mm256_extract_epi16(v, 8);
+    }
+
+    sums_sse2(base + i * stride, length - i, stride, end, sums + i);
+}
+#endif
+
+static SumFunction sum_function(void) {
+    static _Atomic(SumFunction) function = NULL;
+    SumFunction f = atomic_load_explicit(&function, memory_order_relaxed);
+
+    if(f == NULL) {
+        f = sums_scalar;
+#if defined(__SSE2__)
+        f = sums_sse2;
+        if(__builtin_cpu_supports("avx2"))
+            f = sums_avx2;
+#endif
+        atomic_store_explicit(&function, f, memory_order_relaxed);
+    }
+
+    return f;
+}
+
+uint16_t checksum_toyota(const CANFrame *frame) {
+    return checksum_toyota_data(frame->ID, frame->data, frame->length);
+}
+
+uint16_t checksum_toyota_data(uint16_t ID, const uint8_t data[], uint8_t length) {
+    uint16_t checksum = (ID >> 8) + (ID & 0xFF) + length;
+
+    for(uint8_t i = 0; i + 1 < length && i < 8; i++)
+        checksum += data[i];
+
+    return checksum;
+}
+
+int checksum_toyota_fill(CANFrame frames[], int length) {
+    const uint8_t *end = (const uint8_t*)&frames[length];
+    SumFunction sum = sum_function();
+    uint16_t sums[CHECKSUM_CHUNK];
+    CANFrame *frame;
+    int written = 0;
+    int n;
+
+    for(int first = 0; first < length; first += n) {
+        n = (length - first < CHECKSUM_CHUNK) ? length - first : CHECKSUM_CHUNK;
+        sum((const uint8_t*)&frames[first], n, sizeof(CANFrame), end, sums);
+
+        for(int i = 0; i < n; i++) {
+            frame = &frames[first + i];
+            if(frame->length == 0 || frame->length > 8)
+                continue;
+
+            frame->data[frame->length - 1] = sums[i];
+            written++;
+        }
+    }
+
+    return written;
+}
+
+int checksum_toyota_verify(const CANFrame *frames, int length, size_t stride, uint8_t valid[]) {
+    const uint8_t *base = (const uint8_t*)frames;
+    const uint8_t *end = base + (size_t)length * stride;
+    SumFunction sum = sum_function();
+    uint16_t sums[CHECKSUM_CHUNK];
+    const CANFrame *frame;
+    int invalid = 0;
+    int ok, n;
+
+    for(int first = 0; first < length; first += n) {
+        n = (length - first < CHECKSUM_CHUNK) ? length - first : CHECKSUM_CHUNK;
+        sum(base + first * stride, n, stride, end, sums);
+
+        for(int i = 0; i < n; i++) {
+            frame = (const CANFrame*)(base + (first + i) * stride);
+            ok = frame->length > 0 && frame->length <= 8 && frame->data[frame->length - 1] == (uint8_t)sums[i];
+            if(valid != NULL)
+                valid[first + i] = ok;
+            invalid += !ok;
+        }
+    }
+
+    return invalid;
+}
+
+const char *checksum_engine(void) {
+    SumFunction f = sum_function();
+
+#if defined(__SSE2__)
+    if(f == sums_avx2)
+        return "avx2";
+    if(f == sums_sse2)
+        return "sse2";
+#endif
+    return "scalar";
+}
+
+void checksum_ids_clear(ChecksumIdSet *ids) {
+    memset(ids, 0, sizeof(ChecksumIdSet));
+}
+
+void checksum_ids_add(ChecksumIdSet *ids, uint16_t id) {
+    if(id < CHECKSUM_ID_COUNT)
+        ids->bits[id >> 5] |= 1u << (id & 31);
+}
@@ -0,0 +1,88 @@
+/**
+ * \file checksum.h
+ * \date 16 October 2026
+ * \brief File containing the batched Toyota checksum engine.
+ *
+ * This file contains the function declarations for calculating and verifying the Toyota checksum of whole arrays of frames.
+ * The checksum is the sum of both ID bytes, the length and all data bytes except the last, truncated to the last data byte.
+ * The bytes to add are selected with a mask per length, so a frame is summed with one SAD instruction.
+ * On x86 SSE2 (one frame per register) or AVX2 (two frames per register) is used, elsewhere a scalar loop.
+ */
+
+#ifndef CAN_CHECKSUM
+#define CAN_CHECKSUM
+    #include <stdint.h>
+    #include <stddef.h>
+    #include "canFrame.h"
+
+    #define CHECKSUM_ID_COUNT 2048  //!< One bit for every 11 bit CAN ID.
+
+    /**
+     * \brief Defines the set of CAN IDs that carry a Toyota checksum.
+     */
+    typedef struct {
+        uint32_t bits[CHECKSUM_ID_COUNT / 32];  //!< One bit per CAN ID.
+    } ChecksumIdSet;
+
+    /**
+     * \fn uint16_t checksum_toyota(const CANFrame *frame)
+     * \brief Calculate the checksum of one frame, without writing it.
+     * \param frame The frame to calculate the checksum for.
+     * \return The sum, the checksum is the lowest byte.
+     *
+     * \fn uint16_t checksum_toyota_data(uint16_t ID, const uint8_t data[], uint8_t length)
+     * \brief Calculate the checksum of a frame that is not a CANFrame, for example in a FrameArena.
+     * \param ID The CAN ID of the frame.
+     * \param data The data of the frame.
+     * \param length The length of the frame.
+     * \return The sum, the checksum is the lowest byte.
+     *
+     * \fn int checksum_toyota_fill(CANFrame frames[], int length)
+     * \brief Calculate the checksums of an array of frames and write them in the last data byte.
+     * Frames with a length of 0 or over 8 are skipped.
+     * \param frames The frames to calculate the checksum for.
+     * \param length The number of frames.
+     * \return The number of frames written.
+     *
+     * \fn int checksum_toyota_verify(const CANFrame *frames, int length, size_t stride, uint8_t valid[])
+     * \brief Verify the checksums of an array of frames.
+     * The stride allows verifying the frames inside larger structs, for example an array of CANRxFrame.
+     * \param frames The first frame to verify.
+     * \param length The number of frames.
+     * \param stride The distance between two frames in bytes, sizeof(CANFrame) for a plain array.
+     * \param valid For every frame 1 if the checksum is correct, 0 if not. NULL if not needed.
+     * \return The number of frames with a wrong checksum.
+     *
+     * \fn const char *checksum_engine(void)
+     * \brief Get the name of the implementation that is used on this CPU.
+     * \return "avx2", "sse2" or "scalar".
+     *
+     * \fn void checksum_ids_clear(ChecksumIdSet *ids)
+     * \brief Remove all IDs from the set.
+     * \param ids Pointer to ChecksumIdSet struct.
+     *
+     * \fn void checksum_ids_add(ChecksumIdSet *ids, uint16_t id)
+     * \brief Add an ID to the set.
+     * \param ids Pointer to ChecksumIdSet struct.
+     * \param id The CAN ID that carries a checksum.
+     *
+     * \fn int checksum_ids_has(const ChecksumIdSet *ids, uint16_t id)
+     * \brief Check if an ID carries a checksum.
+     * \param ids Pointer to ChecksumIdSet struct.
+     * \param id The CAN ID to check.
+     * \return 1: The ID carries a checksum
+     * \return 0: The ID does not carry a checksum
+     */
+
+    uint16_t checksum_toyota(const CANFrame *frame);
+    uint16_t checksum_toyota_data(uint16_t ID, const uint8_t data[], uint8_t length);
+    int checksum_toyota_fill(CANFrame frames[], int length);
+    int checksum_toyota_verify(const CANFrame *frames, int length, size_t stride, uint8_t valid[]);
+    const char *checksum_engine(void);
+    void checksum_ids_clear(ChecksumIdSet *ids);
+    void checksum_ids_add(ChecksumIdSet *ids, uint16_t id);
+
+    static inline int checksum_ids_has(const ChecksumIdSet *ids, uint16_t id) {
+        return id < CHECKSUM_ID_COUNT && (ids->bits[id >> 5] >> (id & 31)) & 1;
+    }
+#endif
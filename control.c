@@ -0,0 +1,64 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "control.h"
+#include "toyotaRav4.h"
+
+#define STEER_RATE  3000    //!< The steering torque ramp, per second.
+#define ACCEL_RATE  1000    //!< The acceleration ramp, per second.
+#define DECEL_RATE  2000    //!< The deceleration ramp, per second.
+
+/* The step of a ramp in one tick, rounded, at least 1. */
+static int16_t ramp_step(uint32_t rate, uint32_t tick_us) {
+    uint64_t step = ((uint64_t)rate * tick_us + 500000) / 1000000;
+
+    return (step > 0) ? step : 1;
+}
+
+void control_setup(Control *c, uint8_t enableCam, uint8_t enableDsu, uint32_t tick_us) {
+    memset(c, 0, sizeof(Control));
+    c->enableCam = enableCam;
+    c->enableDsu = enableDsu;
+    c->steer_step = ramp_step(STEER_RATE, tick_us);
+    c->accel_step = ramp_step(ACCEL_RATE, tick_us);
+    c->decel_step = ramp_step(DECEL_RATE, tick_us);
+}
+
+int control_tick(Control *c, const Joystick *js, FrameArena *a) {
+    uint32_t count = c->count;
+    int length = 0;
+    int16_t steer;
+
+    if(c->enableCam) {
+        steer = (js->axes[0].x * (-1))/22;
+        c->steer = steer;
+        //steer = (steer > 1500) ? 1500 : ((steer < -1500) ? -1500 : steer);
+        if(steer > (c->steer_count + c->steer_step))
+            c->steer_count += c->steer_step;
+        if(steer < (c->steer_count - c->steer_step))
+            c->steer_count -= c->steer_step;
+
+        if(steer == 0)
+            c->steer_count = 0;
+
+        length += sendSteerCommand(a, count, c->steer_count);        // Cam
+
+        length += sendStaticVideo(a, count);                         // Cam
+        length += sendStaticCam(a, count);                           // Cam
+
+        length += sendUiCommand(a, count, 0);                        // Cam
+        length += sendFcwCommand(a, count, 0);                       // Cam
+    }
+
+    if(c->enableDsu) {
+        c->accel = (js->buttons[1] * !js->buttons[2] * (c->accel + c->accel_step));
+        c->decel = (js->buttons[2] * (c->decel - c->decel_step));
+
+        c->accel = (c->accel > 1500) ? 1500 : c->accel;
+        c->decel = (c->decel < -3000) ? -3000 : c->decel;
+        length += sendAccelCommand(a, count, c->accel + c->decel, js->buttons[3]);  // Dsu
+        length += sendStaticDsu(a, count);                                          // Dsu
+    }
+
+    return length;
+}
@@ -0,0 +1,54 @@
+/**
+ * \file control.h
+ * \date 16 October 2026
+ * \brief File containing the control law of the car.
+ *
+ * This file contains the function declarations for turning the joystick state into the frames of one tick, as well as the
+ * definition of the Control struct. The control law does not read any clock or device, so the same code runs live and in a replay.
+ * The ramps are defined per second and converted to a step per tick, so they feel the same at every tick rate.
+ */
+
+#ifndef CONTROL
+#define CONTROL
+    #include <stdint.h>
+    #include "canFrame.h"
+    #include "frameArena.h"
+    #include "joystick.h"
+
+    #define CONTROL_MAX_FRAMES ARENA_MAX_FRAMES //!< The most frames of one tick.
+
+    /**
+     * \brief Defines the state of the control law, kept between ticks.
+     */
+    typedef struct {
+        uint8_t enableCam;      //!< Replace the camera (steering, video and HUD).
+        uint8_t enableDsu;      //!< Replace the DSU (acceleration).
+        uint32_t count;         //!< The counter of the tick, the deadlines passed (see pipeline_build()), used by the counters of the messages.
+        int16_t steer;          //!< The steering torque requested by the joystick in the last tick.
+        int16_t steer_count;    //!< The steering torque, ramped towards the joystick.
+        int16_t accel;          //!< The acceleration, ramped up while the button is held.
+        int16_t decel;          //!< The deceleration, ramped up while the button is held.
+        int16_t steer_step;     //!< The most the steering torque changes in one tick.
+        int16_t accel_step;     //!< The acceleration added every tick the button is held.
+        int16_t decel_step;     //!< The deceleration added every tick the button is held.
+    } Control;
+
+    /**
+     * \fn void control_setup(Control *c, uint8_t enableCam, uint8_t enableDsu, uint32_t tick_us)
+     * \brief Reset the control law. setupToyotaRav4() must be called before the first tick.
+     * \param c Pointer to Control struct.
+     * \param enableCam Replace the camera.
+     * \param enableDsu Replace the DSU.
+     * \param tick_us The period of the tick in microseconds, the same as the profile was loaded with.
+     *
+     * \fn int control_tick(Control *c, const Joystick *js, FrameArena *a)
+     * \brief Run one tick of the control law. c->count is set by the caller, see pipeline_build().
+     * \param c Pointer to Control struct.
+     * \param js The current state of the joystick.
+     * \param a The arena to add the frames to send to.
+     * \return Number of frames added.
+     */
+
+    void control_setup(Control *c, uint8_t enableCam, uint8_t enableDsu, uint32_t tick_us);
+    int control_tick(Control *c, const Joystick *js, FrameArena *a);
+#endif
@@ -0,0 +1,51 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "frameArena.h"
+
+int arena_init(FrameArena *a) {
+    memset(a, 0, sizeof(FrameArena));
+
+    a->frames = aligned_alloc(64, ARENA_MAX_FRAMES * ARENA_FRAME_SIZE);
+    if(a->frames == NULL)
+        return -1;
+
+    return 0;
+}
+
+void arena_free(FrameArena *a) {
+    free(a->frames);
+    a->frames = NULL;
+    a->length = 0;
+}
+
+uint8_t *arena_add(FrameArena *a, uint16_t ID, uint8_t bus, uint8_t length) {
+    uint32_t *words;
+
+    if(a->length >= ARENA_MAX_FRAMES || length > 8) {
+        a->overflows++;
+        return NULL;
+    }
+
+    words = (uint32_t*)(a->frames + a->length * ARENA_FRAME_SIZE);
+    words[0] = (ID << 21) | 1;
+    words[1] = length | (bus << 4);
+    words[2] = 0;
+    words[3] = 0;
+    a->length++;
+
+    return (uint8_t*)&words[2];
+}
+
+int arena_append(FrameArena *a, const uint8_t *frames, int length) {
+    if(length > ARENA_MAX_FRAMES - a->length) {
+        a->overflows += length;
+        return -1;
+    }
+
+    memcpy(a->frames + a->length * ARENA_FRAME_SIZE, frames, length * ARENA_FRAME_SIZE);
+    a->length += length;
+
+    return 0;
+}
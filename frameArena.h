@@ -0,0 +1,126 @@
+/**
+ * \file frameArena.h
+ * \date 16 October 2026
+ * \brief File containing the arena the frames of one tick are built in.
+ *
+ * This file contains the function declarations for building the frames of a tick, as well as the definition of the
+ * FrameArena struct. The frames are written straight in the 16 byte USB format of the Panda, in a preallocated buffer
+ * that has the size of one send:
+ * \code
+ * uint32_t word 0    ID << 21 | 1
+ * uint32_t word 1    length | bus << 4
+ * uint8_t data[8]    the data, zero after the length
+ * \endcode
+ * The Panda sends the buffer itself (panda_can_send_arena() swaps it with the buffer of a free transfer), the other
+ * transports unpack the frames. A frame that does not fit is not added and counted, it never writes past the buffer.
+ */
+
+#ifndef FRAME_ARENA
+#define FRAME_ARENA
+    #include <stdint.h>
+    #include <string.h>
+    #include "canFrame.h"
+
+    #define ARENA_FRAME_SIZE    16      //!< The size of one frame, the same as PANDA_FRAME_SIZE.
+    #define ARENA_MAX_FRAMES    256     //!< The number of frames in an arena, the same as PANDA_TX_MAX_FRAMES.
+
+    /**
+     * \brief Defines the frames of one tick.
+     */
+    typedef struct {
+        uint8_t *frames;        //!< The frames, ARENA_MAX_FRAMES * ARENA_FRAME_SIZE bytes, 64 byte aligned.
+        uint16_t length;        //!< The number of frames added since the last reset.
+        uint64_t overflows;     //!< The number of frames that were not added, because they did not fit.
+    } FrameArena;
+
+    /**
+     * \fn int arena_init(FrameArena *a)
+     * \brief Allocate the buffer of the arena.
+     * \param a Pointer to FrameArena struct.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void arena_free(FrameArena *a)
+     * \brief Free the buffer of the arena.
+     * \param a Pointer to FrameArena struct.
+     *
+     * \fn uint8_t *arena_add(FrameArena *a, uint16_t ID, uint8_t bus, uint8_t length)
+     * \brief Add a frame, the caller writes the data.
+     * \param a Pointer to FrameArena struct.
+     * \param ID The CAN ID.
+     * \param bus The bus to send the frame on.
+     * \param length The number of data bytes, max. 8.
+     * \return The 8 data bytes of the frame, set to 0. NULL if the arena is full or the length is over 8.
+     *
+     * \fn int arena_append(FrameArena *a, const uint8_t *frames, int length)
+     * \brief Add frames that are already packed, all or none.
+     * \param a Pointer to FrameArena struct.
+     * \param frames The packed frames.
+     * \param length The number of frames.
+     * \return 0: Success
+     * \return <0: The frames do not fit
+     *
+     * \fn void arena_reset(FrameArena *a)
+     * \brief Remove all frames, for the next tick.
+     * \param a Pointer to FrameArena struct.
+     *
+     * \fn uint8_t *arena_data(FrameArena *a, int i)
+     * \brief Get the data of a frame, to change it after it was added.
+     * \param a Pointer to FrameArena struct.
+     * \param i The index of the frame.
+     * \return The 8 data bytes of the frame.
+     *
+     * \fn void arena_pack(uint8_t *packed, const CANFrame *frame)
+     * \brief Write one frame in the format of the arena.
+     * \param packed The ARENA_FRAME_SIZE bytes to write.
+     * \param frame The frame.
+     *
+     * \fn void arena_unpack(const uint8_t *packed, CANFrame *frame)
+     * \brief Read one frame in the format of the arena, freq is set to 0.
+     * \param packed The ARENA_FRAME_SIZE bytes to read.
+     * \param frame The frame.
+     *
+     * \fn void arena_get(const FrameArena *a, int i, CANFrame *frame)
+     * \brief Read a frame of the arena.
+     * \param a Pointer to FrameArena struct.
+     * \param i The index of the frame.
+     * \param frame The frame.
+     */
+
+    int arena_init(FrameArena *a);
+    void arena_free(FrameArena *a);
+    uint8_t *arena_add(FrameArena *a, uint16_t ID, uint8_t bus, uint8_t length);
+    int arena_append(FrameArena *a, const uint8_t *frames, int length);
+
+    static inline void arena_reset(FrameArena *a) {
+        a->length = 0;
+    }
+
+    static inline uint8_t *arena_data(FrameArena *a, int i) {
+        return a->frames + i * ARENA_FRAME_SIZE + 8;
+    }
+
+    static inline void arena_pack(uint8_t *packed, const CANFrame *frame) {
+        uint32_t *words = (uint32_t*)packed;
+
+        words[0] = (frame->ID << 21) | 1;
+        words[1] = frame->length | (frame->bus << 4);
+        words[2] = 0;
+        words[3] = 0;
+        memcpy(&words[2], frame->data, frame->length <= 8 ? frame->length : 8);
+    }
+
+    static inline void arena_unpack(const uint8_t *packed, CANFrame *frame) {
+        const uint32_t *words = (const uint32_t*)packed;
+
+        frame->ID = words[0] >> 21;
+        frame->length = words[1] & 0x0F;
+        frame->bus = words[1] >> 4;
+        frame->freq = 0;
+        memcpy(frame->data, &words[2], 8);
+    }
+
+    static inline void arena_get(const FrameArena *a, int i, CANFrame *frame) {
+        arena_unpack(a->frames + i * ARENA_FRAME_SIZE, frame);
+    }
+#endif
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include "healthMonitor.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+#define HEALTH_VALID    (1ULL << 63)    //!< Set in every packed health, so 0 means never read.
+#define HEALTH_CONTROLS (1ULL << 33)    //!< controls_allowed in the packed health.
+
+static uint64_t health_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static uint64_t health_pack(const Health *h) {
+    uint64_t voltage = (h->voltage > 0xffff) ? 0xffff : h->voltage;
+    uint64_t current = (h->current > 0xffff) ? 0xffff : h->current;
+
+    return HEALTH_VALID | voltage | (current << 16) |
+           ((uint64_t)(h->started != 0) << 32) | ((uint64_t)(h->controls_allowed != 0) << 33) |
+           ((uint64_t)(h->gas_interceptor_detected != 0) << 34) | ((uint64_t)(h->started_signal_detected != 0) << 35) |
+           ((uint64_t)(h->started_alt != 0) << 36);
+}
+
+static void health_unpack(uint64_t slot, Health *h) {
+    h->voltage = slot & 0xffff;
+    h->current = (slot >> 16) & 0xffff;
+    h->started = (slot >> 32) & 1;
+    h->controls_allowed = (slot >> 33) & 1;
+    h->gas_interceptor_detected = (slot >> 34) & 1;
+    h->started_signal_detected = (slot >> 35) & 1;
+    h->started_alt = (slot >> 36) & 1;
+}
+
+/* Runs on the thread handling the USB events, which is not always the control thread. */
+static void health_done(const Health *h, int status, void *ctx) {
+    HealthMonitor *m = ctx;
+    uint64_t slot, previous, one = 1;
+
+    if(status < 0) {
+        atomic_fetch_add(&m->failures, 1);
+        return;
+    }
+
+    slot = health_pack(h);
+    atomic_store(&m->timestamp_ns, health_now());
+    previous = atomic_exchange(&m->slot, slot);
+    atomic_fetch_add(&m->completed, 1);
+
+    if(previous != 0 && ((previous ^ slot) & HEALTH_CONTROLS)) {
+        atomic_fetch_add(&m->flips, 1);
+        if(write(m->event_fd, &one, sizeof(one)) < 0) {}
+    }
+}
+
+static void health_on_timer(int fd, uint32_t events, void *ctx) {
+    HealthMonitor *m = ctx;
+    uint64_t expirations;
+    int ret;
+
+    if(read(fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+        return;
+
+    ret = transport_health_submit(m->t, health_done, m);
+    if(ret == 0)
+        m->polls++;
+    else if(ret == LIBUSB_ERROR_BUSY)
+        m->skipped++;
+    else
+        atomic_fetch_add(&m->failures, 1);
+}
+
+static void health_on_change(int fd, uint32_t events, void *ctx) {
+    HealthMonitor *m = ctx;
+    uint64_t count;
+    Health h;
+
+    if(read(fd, &count, sizeof(count)) != sizeof(count))
+        return;
+
+    /* Only the newest state matters, several flips between two wake ups are reported once. */
+    if(health_read(m, &h) != 0 && m->changed != NULL)
+        m->changed(&h, m->ctx);
+}
+
+int health_start(HealthMonitor *m, Transport *t, Reactor *r, uint32_t period_ms, HealthCallback changed, void *ctx) {
+    struct itimerspec spec;
+
+    memset(m, 0, sizeof(HealthMonitor));
+    m->t = t;
+    m->reactor = r;
+    m->changed = changed;
+    m->ctx = ctx;
+    m->timer_fd = -1;
+    m->event_fd = -1;
+
+    if(t->ops->health_submit == NULL || period_ms == 0)
+        return -1;
+
+    m->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if(m->event_fd < 0 || m->timer_fd < 0) {
+        health_stop(m);
+        return -1;
+    }
+
+    /* The first read right away, then every period. */
+    spec.it_value.tv_sec = 0;
+    spec.it_value.tv_nsec = 1;
+    spec.it_interval.tv_sec = period_ms / 1000;
+    spec.it_interval.tv_nsec = (period_ms % 1000) * 1000000L;
+    if(timerfd_settime(m->timer_fd, 0, &spec, NULL) < 0 ||
+       reactor_add(r, m->event_fd, EPOLLIN, health_on_change, m) < 0 ||
+       reactor_add(r, m->timer_fd, EPOLLIN, health_on_timer, m) < 0) {
+        terminalColor(31);
+        printf("Could not start the health polling\n");
+        terminalColor(0);
+        health_stop(m);
+        return -1;
+    }
+
+    return 0;
+}
+
+void health_stop(HealthMonitor *m) {
+    if(m->timer_fd >= 0) {
+        reactor_remove(m->reactor, m->timer_fd);
+        close(m->timer_fd);
+    }
+    if(m->event_fd >= 0) {
+        reactor_remove(m->reactor, m->event_fd);
+        close(m->event_fd);
+    }
+    m->timer_fd = -1;
+    m->event_fd = -1;
+}
+
+uint64_t health_read(HealthMonitor *m, Health *h) {
+    uint64_t slot = atomic_load(&m->slot);
+
+    if(slot == 0)
+        return 0;
+
+    health_unpack(slot, h);
+    return atomic_load(&m->timestamp_ns);
+}
+
+void health_print_stats(HealthMonitor *m) {
+    printf("Health: %llu reads, %llu completed, %llu skipped (still in flight), %llu failed, %llu controls_allowed changes\n",
+           (unsigned long long)m->polls, (unsigned long long)atomic_load(&m->completed), (unsigned long long)m->skipped,
+           (unsigned long long)atomic_load(&m->failures), (unsigned long long)atomic_load(&m->flips));
+}
@@ -0,0 +1,83 @@
+/**
+ * \file healthMonitor.h
+ * \date 16 October 2026
+ * \brief File containing the periodic health polling of the CAN device.
+ *
+ * This file contains the function declarations for reading the health of the Panda in the background, as well as the
+ * definition of the HealthMonitor struct. A timerfd in the event loop submits an asynchronous control transfer on its own
+ * cadence, the control loop never waits for the USB round trip:
+ * \code
+ * timer (2 Hz) --> transport_health_submit() ... completion --> packed Health in one atomic slot
+ *                                                          \--> eventfd if controls_allowed flipped --> callback
+ * \endcode
+ * The completion can run on an I/O thread (pandas backend), so the latest health is packed into 64 bits that any thread
+ * reads with one atomic load. A change of controls_allowed is passed back to the event loop, where the callback runs.
+ */
+
+#ifndef HEALTH_MONITOR
+#define HEALTH_MONITOR
+    #include <stdint.h>
+    #include <stdatomic.h>
+    #include "reactor.h"
+    #include "transport.h"
+
+    #define HEALTH_PERIOD_MS 500    //!< The default time between two health reads (2 Hz).
+
+    /**
+     * \brief Called on the event loop when controls_allowed changed.
+     * \param h The health that changed it.
+     * \param ctx The context given to health_start().
+     */
+    typedef void (*HealthCallback)(const Health *h, void *ctx);
+
+    /**
+     * \brief Defines the health polling of one transport.
+     */
+    typedef struct {
+        Transport *t;                   //!< The transport to read the health of.
+        Reactor *reactor;               //!< The event loop with the timer and the eventfd.
+        int timer_fd;                   //!< The timerfd of the polling cadence, -1 when not started.
+        int event_fd;                   //!< Written by the completion when controls_allowed flipped.
+        HealthCallback changed;         //!< Called when controls_allowed flipped, NULL if not used.
+        void *ctx;                      //!< The context of changed.
+        _Atomic uint64_t slot;          //!< The latest health, packed, 0 if never read.
+        _Atomic uint64_t timestamp_ns;  //!< The CLOCK_MONOTONIC time the latest health was read.
+        uint64_t polls;                 //!< The number of submitted reads.
+        uint64_t skipped;               //!< The number of periods skipped because the previous read was still in flight.
+        _Atomic uint64_t completed;     //!< The number of reads that completed.
+        _Atomic uint64_t failures;      //!< The number of reads that could not be submitted, failed or timed out.
+        _Atomic uint64_t flips;         //!< The number of times controls_allowed changed.
+    } HealthMonitor;
+
+    /**
+     * \fn int health_start(HealthMonitor *m, Transport *t, Reactor *r, uint32_t period_ms, HealthCallback changed, void *ctx)
+     * \brief Start reading the health of a transport periodically.
+     * \param m Pointer to HealthMonitor struct.
+     * \param t The transport, it must support transport_health_submit().
+     * \param r The event loop handling the events of the transport.
+     * \param period_ms The time between two reads.
+     * \param changed Called when controls_allowed flipped, NULL if not used.
+     * \param ctx Passed to changed.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void health_stop(HealthMonitor *m)
+     * \brief Stop reading the health. Call after closing the transport, so no read can complete anymore.
+     * \param m Pointer to HealthMonitor struct.
+     *
+     * \fn uint64_t health_read(HealthMonitor *m, Health *h)
+     * \brief Get the latest health, from any thread, without waiting.
+     * \param m Pointer to HealthMonitor struct.
+     * \param h The health, voltage and current clamped to 65535.
+     * \return The CLOCK_MONOTONIC time the health was read, 0 if it never was
+     *
+     * \fn void health_print_stats(HealthMonitor *m)
+     * \brief Print the statistics of the health polling.
+     * \param m Pointer to HealthMonitor struct.
+     */
+
+    int health_start(HealthMonitor *m, Transport *t, Reactor *r, uint32_t period_ms, HealthCallback changed, void *ctx);
+    void health_stop(HealthMonitor *m);
+    uint64_t health_read(HealthMonitor *m, Health *h);
+    void health_print_stats(HealthMonitor *m);
+#endif
@@ -8,13 +8,19 @@
 #include <linux/joystick.h>
 
 #include "joystick.h"
+#include "joystickEvdev.h"
+#include "latency.h"
 
 #define terminalColor(color) printf("\033[%dm", color)
 
 int setupJoystick(Joystick *js, char *name) {
+    int ret;
+
     memset(js->axes, 0, 3 * sizeof(Axis));
     memset(js->buttons, 0, 12 * sizeof(uint8_t));
 
+    js->events = 0;
+    js->evdev = NULL;
     js->name = name;
     js->fd = open(js->name, O_RDONLY | O_NONBLOCK);
     if(js->fd == -1) {
@@ -24,6 +30,21 @@ int setupJoystick(Joystick *js, char *name) {
         return -1;
     }
 
+    ret = evdev_setup(js);
+    if(ret < 0) {
+        terminalColor(31);
+        printf("Could not set up the evdev joystick\n");
+        terminalColor(0);
+        return -1;
+    }
+    if(ret == 0) {
+        terminalColor(32);
+        printf("Joystick connected (evdev, %d axes, %d buttons)\n", js->numberOfAxes, js->numberOfButtons);
+        terminalColor(0);
+        fflush(stdout);
+        return 0;
+    }
+
     if(ioctl(js->fd, JSIOCGAXES, &js->numberOfAxes) == -1)
         js->numberOfAxes = 0;
 
@@ -38,38 +59,84 @@ int setupJoystick(Joystick *js, char *name) {
     return 0;
 }
 
-int readJoystick(Joystick *js) {
-    struct js_event event;
+void closeJoystick(Joystick *js) {
+    evdev_close(js);
+    close(js->fd);
+}
+
+void updateJoystick(Joystick *js, const JoystickEvent *event) {
     uint8_t axis;
 
-    if(read(js->fd, &event, sizeof(event)) > 0) {
-        switch(event.type) {
-            case JS_EVENT_BUTTON:
-                js->buttons[event.number] = event.value;
-                break;
-            case JS_EVENT_AXIS:
-                axis = event.number / 2;
-
-                if(axis < 3) {
-                    if(event.number % 2 == 0)
-                        js->axes[axis].x = event.value;
-                    else
-                        js->axes[axis].y = event.value;
-                }
-                break;
-            default:
-                /* Ignore init events. */
-                break;
-        }
+    js->last = *event;
+    js->events++;
+
+    switch(event->type) {
+        case JS_EVENT_BUTTON:
+            if(event->number < sizeof(js->buttons))
+                js->buttons[event->number] = event->value;
+            break;
+        case JS_EVENT_AXIS:
+            axis = event->number / 2;
+
+            if(axis < 3) {
+                if(event->number % 2 == 0)
+                    js->axes[axis].x = event->value;
+                else
+                    js->axes[axis].y = event->value;
+            }
+            break;
+        default:
+            /* Ignore init events. */
+            break;
     }
+}
+
+int readJoystick(Joystick *js) {
+    JoystickEvent event;
+
+    return readJoystickBatch(js, &event, 1);
+}
+
+int readJoystickBatch(Joystick *js, JoystickEvent events[], int max) {
+    struct js_event buffer[JOYSTICK_BATCH];
+    ssize_t ret;
+    int n;
+
+    if(js->evdev != NULL)
+        return evdev_read_batch(js, events, max);
+
+    if(max > JOYSTICK_BATCH)
+        max = JOYSTICK_BATCH;
+
+    /* The driver only returns whole events, as many as fit. */
+    errno = 0;
+    ret = read(js->fd, buffer, max * sizeof(struct js_event));
+    if(ret < 0) {
+        if(errno == EAGAIN || errno == EINTR)
+            return 0;
 
-    if(errno != EAGAIN && errno != 0) {
         terminalColor(31);
         printf("%d\n", errno);
+        terminalColor(0);
         return -1;
     }
 
-    return 0;
+    n = ret / sizeof(struct js_event);
+    if(n == 0)
+        return 0;
+
+    js->timestamp_ns = latency_now();
+    for(int i = 0; i < n; i++) {
+        latency_js_event(buffer[i].time, js->timestamp_ns);
+
+        events[i].time = buffer[i].time;
+        events[i].value = buffer[i].value;
+        events[i].type = buffer[i].type;
+        events[i].number = buffer[i].number;
+        updateJoystick(js, &events[i]);
+    }
+
+    return n;
 }
 
 void printState(Joystick *js, int enableAxes, int enableButtons) {
@@ -10,6 +10,8 @@
 #ifndef JOYSTICK
 #define JOYSTICK
 
+    #define JOYSTICK_BATCH 64   //!< The maximum number of events read with one read().
+
     /**
      * \brief Contains the X and Y value of an axis
      */
@@ -19,6 +21,16 @@
     } Axis;
 
 
+    /**
+     * \brief Contains one event of the joystick, in the layout of the kernel (struct js_event).
+     */
+    typedef struct {
+        uint32_t time;      //!< The timestamp of the event in ms.
+        int16_t value;      //!< The new value of the axis or button.
+        uint8_t type;       //!< The type of the event (JS_EVENT_BUTTON, JS_EVENT_AXIS, JS_EVENT_INIT).
+        uint8_t number;     //!< The number of the axis or button.
+    } JoystickEvent;
+
     /**
      * \brief Defines the interface for a connected joystick/gamepad.
      *
@@ -31,22 +43,44 @@
         uint8_t buttons[12];    //!< The state of all buttons on the joystick/gamepad
         uint8_t numberOfAxes;   //!< The number of axes that the specific joystick has.
         uint8_t numberOfButtons;//!< The number of buttons that a specific joystick has.
+        JoystickEvent last;     //!< The last event that was read.
+        uint64_t timestamp_ns;  //!< The CLOCK_MONOTONIC time the last event was read.
+        uint64_t events;        //!< The number of events applied.
+        struct EvdevJoystick *evdev;    //!< The state of the evdev backend, NULL for the joystick API.
     } Joystick;
 
     /**
      * \fn int setupJoystick(Joystick *js, char *name)
-     * \brief Setup and connect to a joystick
+     * \brief Setup and connect to a joystick, /dev/input/jsX or /dev/input/eventX (evdev)
      * \param js Pointer to Joystick struct.
      * \param name The name of the joystick to connect to.
      * \return 0: Success
      * \return <0: Fail
      *
+     * \fn void closeJoystick(Joystick *js)
+     * \brief Disconnect from a joystick
+     * \param js Pointer to Joystick struct.
+     *
      * \fn int readJoystick(Joystick *js)
-     * \brief Reads te current status of the joystick and puts it in the struct
+     * \brief Reads one pending event of the joystick and puts it in the struct
      * \param js Pointer to Joystick struct.
-     * \return 0: Success
+     * \return 1: An event was read
+     * \return 0: No events pending
+     * \return <0: Fail
+     *
+     * \fn int readJoystickBatch(Joystick *js, JoystickEvent events[], int max)
+     * \brief Reads all pending events of the joystick with one read(), up to max, and puts them in the struct
+     * \param js Pointer to Joystick struct.
+     * \param events The array to copy the events to, to record them.
+     * \param max The length of the array, at most JOYSTICK_BATCH events are read.
+     * \return The number of events read, 0 if none are pending
      * \return <0: Fail
      *
+     * \fn void updateJoystick(Joystick *js, const JoystickEvent *event)
+     * \brief Apply one event to the state of the joystick, for example an event from a log.
+     * \param js Pointer to Joystick struct.
+     * \param event The event to apply.
+     *
      * \fn void printState(Joystick *js, int enableAxes, int enableButtons)
      * \brief Debugs the status of the joystick. Can be configured to show only the axes, the buttons or both.
      * \param js Pointer to Joystick struct.
@@ -55,6 +89,9 @@
      */
 
     int setupJoystick(Joystick *js, char *name);
+    void closeJoystick(Joystick *js);
     int readJoystick(Joystick *js);
+    int readJoystickBatch(Joystick *js, JoystickEvent events[], int max);
+    void updateJoystick(Joystick *js, const JoystickEvent *event);
     void printState(Joystick *js, int enableAxes, int enableButtons);
 #endif
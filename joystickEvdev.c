@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/ioctl.h>
+#include <linux/input.h>
+#include <linux/joystick.h>
+
+#include "joystickEvdev.h"
+#include "latency.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+#define BIT_SET(bits, n) ((bits)[(n) / 8] & (1 << ((n) % 8)))
+
+static int16_t evdev_value(const EvdevAxis *a, int32_t value) {
+    if(value < a->min)
+        value = a->min;
+    if(value > a->max)
+        value = a->max;
+
+    return a->table[(uint32_t)(value - a->min) >> a->shift];
+}
+
+static int evdev_build_table(EvdevAxis *a, int32_t deadzone, uint8_t expo) {
+    uint32_t range = (uint32_t)(a->max - a->min);
+    int64_t center = ((int64_t)a->max + a->min) / 2;
+    int64_t t = (int64_t)range / 2 - 2 * deadzone;
+    int64_t coef = (t != 0) ? (1 << 29) / t : 0;
+    int64_t value, raw;
+    uint32_t size;
+
+    a->shift = 0;
+    while((range >> a->shift) >= (1u << EVDEV_TABLE_BITS))
+        a->shift++;
+    size = (range >> a->shift) + 1;
+
+    free(a->table);
+    a->table = malloc(size * sizeof(int16_t));
+    if(a->table == NULL)
+        return -1;
+
+    for(uint32_t i = 0; i < size; i++) {
+        raw = a->min + ((int64_t)i << a->shift);
+
+        /* The default correction of the kernel (joydev), so the values equal those of /dev/input/jsX. */
+        if(raw > center - deadzone)
+            value = (raw < center + deadzone) ? 0 : (coef * (raw - center - deadzone)) >> 14;
+        else
+            value = (coef * (raw - center + deadzone)) >> 14;
+        value = (value > 32767) ? 32767 : ((value < -32767) ? -32767 : value);
+
+        /* The response curve blends the linear value with its cube: fine control around the center, full range at the ends. */
+        if(expo > 0)
+            value = (value * (100 - expo) + value * value * value / (32767 * 32767) * expo) / 100;
+
+        a->table[i] = value;
+    }
+
+    return 0;
+}
+
+int evdev_setup(Joystick *js) {
+    uint8_t absBits[ABS_CNT / 8 + 1] = {0};
+    uint8_t keyBits[KEY_CNT / 8 + 1] = {0};
+    struct input_absinfo info;
+    int clock = CLOCK_MONOTONIC;
+    uint8_t nrAxes = 0, nrButtons = 0;
+    EvdevJoystick *ev;
+    EvdevAxis *a;
+    int version;
+
+    js->evdev = NULL;
+    if(ioctl(js->fd, EVIOCGVERSION, &version) == -1)
+        return 1;
+
+    ev = calloc(1, sizeof(EvdevJoystick));
+    if(ev == NULL)
+        return -1;
+    js->evdev = ev;
+    memset(ev->axisMap, EVDEV_NONE, sizeof(ev->axisMap));
+    memset(ev->buttonMap, EVDEV_NONE, sizeof(ev->buttonMap));
+
+    /* The timestamps on the same clock as latency_now(). */
+    if(ioctl(js->fd, EVIOCSCLOCKID, &clock) == -1) {
+        terminalColor(31);
+        printf("Could not set the clock of the joystick\n");
+        terminalColor(0);
+    }
+
+    if(ioctl(js->fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits) == -1 ||
+       ioctl(js->fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) == -1) {
+        evdev_close(js);
+        return -1;
+    }
+
+    /* Number the axes and buttons like the kernel does for /dev/input/jsX. */
+    for(int code = 0; code < ABS_MT_SLOT && nrAxes < EVDEV_MAX_AXES; code++) {
+        if(!BIT_SET(absBits, code) || ioctl(js->fd, EVIOCGABS(code), &info) == -1)
+            continue;
+
+        a = &ev->axes[nrAxes];
+        a->min = info.minimum;
+        a->max = (info.maximum > info.minimum) ? info.maximum : info.minimum + 1;
+        a->flat = info.flat;
+        a->code = code;
+        if(evdev_build_table(a, a->flat, 0) < 0) {
+            evdev_close(js);
+            return -1;
+        }
+        ev->values[nrAxes] = evdev_value(a, info.value);
+        ev->axisMap[code] = nrAxes++;
+    }
+
+    for(int code = BTN_JOYSTICK; code < KEY_CNT && nrButtons < EVDEV_NONE; code++) {
+        if(BIT_SET(keyBits, code)) {
+            ev->buttonCodes[nrButtons] = code;
+            ev->buttonMap[code] = nrButtons++;
+        }
+    }
+    for(int code = BTN_MISC; code < BTN_JOYSTICK && nrButtons < EVDEV_NONE; code++) {
+        if(BIT_SET(keyBits, code)) {
+            ev->buttonCodes[nrButtons] = code;
+            ev->buttonMap[code] = nrButtons++;
+        }
+    }
+
+    js->numberOfAxes = nrAxes;
+    js->numberOfButtons = nrButtons;
+
+    return 0;
+}
+
+void evdev_close(Joystick *js) {
+    EvdevJoystick *ev = js->evdev;
+
+    if(ev == NULL)
+        return;
+
+    for(int i = 0; i < EVDEV_MAX_AXES; i++)
+        free(ev->axes[i].table);
+    free(ev);
+    js->evdev = NULL;
+}
+
+int evdev_calibrate(Joystick *js, uint8_t number, int32_t deadzone, uint8_t expo) {
+    EvdevJoystick *ev = js->evdev;
+
+    if(ev == NULL || number >= js->numberOfAxes || expo > 100)
+        return -1;
+
+    return evdev_build_table(&ev->axes[number], (deadzone < 0) ? ev->axes[number].flat : deadzone, expo);
+}
+
+static uint32_t evdev_time_ms(const struct input_event *e) {
+    return (uint32_t)((uint64_t)e->input_event_sec * 1000 + e->input_event_usec / 1000);
+}
+
+static int evdev_resync(Joystick *js, JoystickEvent events[], int max) {
+    EvdevJoystick *ev = js->evdev;
+    uint8_t keyBits[KEY_CNT / 8 + 1] = {0};
+    struct input_absinfo info;
+    uint32_t time = (uint32_t)(latency_now() / 1000000);
+    int16_t value;
+    int n = 0;
+
+    /* Only the differences with the state are turned into events, so resyncing again is harmless. */
+    for(int i = 0; i < js->numberOfAxes && n < max; i++) {
+        if(ioctl(js->fd, EVIOCGABS(ev->axes[i].code), &info) == -1)
+            continue;
+        value = evdev_value(&ev->axes[i], info.value);
+        if(value == ev->values[i])
+            continue;
+
+        ev->values[i] = value;
+        events[n] = (JoystickEvent){time, value, JS_EVENT_AXIS, i};
+        updateJoystick(js, &events[n++]);
+    }
+
+    if(ioctl(js->fd, EVIOCGKEY(sizeof(keyBits)), keyBits) != -1) {
+        for(int i = 0; i < js->numberOfButtons && i < (int)sizeof(js->buttons) && n < max; i++) {
+            value = BIT_SET(keyBits, ev->buttonCodes[i]) ? 1 : 0;
+            if(value == js->buttons[i])
+                continue;
+
+            events[n] = (JoystickEvent){time, value, JS_EVENT_BUTTON, i};
+            updateJoystick(js, &events[n++]);
+        }
+    }
+
+    if(n < max)
+        ev->resync = 0;
+
+    return n;
+}
+
+int evdev_read_batch(Joystick *js, JoystickEvent events[], int max) {
+    EvdevJoystick *ev = js->evdev;
+    struct input_event *e;
+    uint64_t event_ns;
+    ssize_t ret;
+    int count, limit, n = 0;
+    uint8_t number;
+    int16_t value;
+
+    if(max > JOYSTICK_BATCH)
+        max = JOYSTICK_BATCH;
+    if(ev->resync) {
+        n = evdev_resync(js, events, max);
+        if(ev->resync)
+            return n;
+    }
+
+    /* Never read more events than fit in the array, then every complete report fits. */
+    limit = max - n;
+    if(ev->nrPending < limit) {
+        errno = 0;
+        ret = read(js->fd, ev->pending + ev->nrPending, (limit - ev->nrPending) * sizeof(struct input_event));
+        if(ret < 0 && errno != EAGAIN && errno != EINTR) {
+            terminalColor(31);
+            printf("%d\n", errno);
+            terminalColor(0);
+            return -1;
+        }
+        if(ret > 0) {
+            ev->nrPending += ret / sizeof(struct input_event);
+            js->timestamp_ns = latency_now();
+        }
+    }
+
+    /* Only the events up to the last SYN_REPORT that fits are applied, a report bigger than the room left is split.
+     * More than limit events can be pending after a resync, or when a SYN_DROPPED stopped the previous batch early. */
+    count = (ev->nrPending < limit) ? ev->nrPending : limit;
+    while(count > 0 && !(ev->pending[count - 1].type == EV_SYN && ev->pending[count - 1].code == SYN_REPORT))
+        count--;
+    if(count == 0 && ev->nrPending >= limit)
+        count = limit;
+
+    for(int i = 0; i < count; i++) {
+        e = &ev->pending[i];
+
+        if(e->type == EV_SYN) {
+            if(e->code == SYN_DROPPED) {
+                ev->dropped = 1;
+            } else if(e->code == SYN_REPORT && ev->dropped) {
+                /* Continue after reading the state of the device again. */
+                ev->dropped = 0;
+                ev->resync = 1;
+                count = i + 1;
+            }
+            continue;
+        }
+        if(ev->dropped)
+            continue;
+
+        if(e->type == EV_ABS && e->code < ABS_CNT && (number = ev->axisMap[e->code]) != EVDEV_NONE) {
+            value = evdev_value(&ev->axes[number], e->value);
+            if(value == ev->values[number])
+                continue;
+            ev->values[number] = value;
+            events[n] = (JoystickEvent){evdev_time_ms(e), value, JS_EVENT_AXIS, number};
+        } else if(e->type == EV_KEY && e->code < KEY_CNT && e->value != 2 && (number = ev->buttonMap[e->code]) != EVDEV_NONE) {
+            events[n] = (JoystickEvent){evdev_time_ms(e), e->value, JS_EVENT_BUTTON, number};
+        } else {
+            continue;
+        }
+
+        event_ns = (uint64_t)e->input_event_sec * 1000000000ULL + e->input_event_usec * 1000ULL;
+        latency_record(LATENCY_JS_READ, (int64_t)(js->timestamp_ns - event_ns));
+        updateJoystick(js, &events[n++]);
+    }
+
+    ev->nrPending -= count;
+    memmove(ev->pending, ev->pending + count, ev->nrPending * sizeof(struct input_event));
+
+    return n;
+}
@@ -0,0 +1,85 @@
+/**
+ * \file joystickEvdev.h
+ * \date 16 October 2026
+ * \brief File containing the evdev backend of the joystick (/dev/input/eventX).
+ *
+ * This file contains the function declarations for reading a gamepad through evdev, as well as the definition of the
+ * EvdevJoystick struct. The events are translated to the events of the joystick API, with the same axis and button numbers
+ * and the same value range as the kernel gives on /dev/input/jsX, so the control law, the log and the replay do not change.
+ * Compared to the joystick API the events have CLOCK_MONOTONIC timestamps in µs, the events of one report (up to SYN_REPORT)
+ * are always applied together, and every axis is mapped with a precomputed table: calibration, deadzone and response curve
+ * in one lookup.
+ */
+
+#ifndef JOYSTICK_EVDEV
+#define JOYSTICK_EVDEV
+    #include <stdint.h>
+    #include <linux/input.h>
+    #include "joystick.h"
+
+    #define EVDEV_MAX_AXES      8       //!< The maximum number of axes that are mapped.
+    #define EVDEV_TABLE_BITS    16      //!< The maximum size of the table of an axis (2^bits entries).
+    #define EVDEV_NONE          0xFF    //!< The number of an axis or button that is not mapped.
+
+    /**
+     * \brief Defines the table of one axis, from the value of the device to the value of the joystick API.
+     */
+    typedef struct {
+        int32_t min;            //!< The minimum value of the device.
+        int32_t max;            //!< The maximum value of the device.
+        int32_t flat;           //!< The deadzone reported by the device.
+        uint8_t shift;          //!< The number of bits dropped from (value - min) to index the table.
+        uint16_t code;          //!< The ABS_ code of the axis.
+        int16_t *table;         //!< The value of the joystick API for every index.
+    } EvdevAxis;
+
+    /**
+     * \brief Defines the evdev state of a joystick.
+     */
+    typedef struct EvdevJoystick {
+        uint8_t axisMap[ABS_CNT];                   //!< The axis number of every ABS_ code, EVDEV_NONE if not mapped.
+        uint8_t buttonMap[KEY_CNT];                 //!< The button number of every KEY_/BTN_ code, EVDEV_NONE if not mapped.
+        uint16_t buttonCodes[EVDEV_NONE];           //!< The KEY_/BTN_ code of every button number.
+        EvdevAxis axes[EVDEV_MAX_AXES];             //!< The axes, by axis number.
+        int16_t values[EVDEV_MAX_AXES];             //!< The last value of every axis, in the range of the joystick API.
+        struct input_event pending[JOYSTICK_BATCH]; //!< The events of a report that is not complete yet.
+        int nrPending;                              //!< The number of events in pending.
+        uint8_t dropped;                            //!< Events were lost, skip them up to the next SYN_REPORT.
+        uint8_t resync;                             //!< The state has to be read from the device again.
+    } EvdevJoystick;
+
+    /**
+     * \fn int evdev_setup(Joystick *js)
+     * \brief Set up the evdev backend of a joystick, when its file is an evdev device.
+     * \param js Pointer to Joystick struct, with the file opened.
+     * \return 0: Success
+     * \return 1: Not an evdev device
+     * \return <0: Fail
+     *
+     * \fn void evdev_close(Joystick *js)
+     * \brief Free the evdev backend of a joystick.
+     * \param js Pointer to Joystick struct.
+     *
+     * \fn int evdev_calibrate(Joystick *js, uint8_t number, int32_t deadzone, uint8_t expo)
+     * \brief Build the table of an axis again, with another deadzone or response curve.
+     * \param js Pointer to Joystick struct.
+     * \param number The axis number.
+     * \param deadzone The values around the center of the device that count as 0, -1 for the flat of the device.
+     * \param expo The response curve in %, 0 is linear and 100 is cubic.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int evdev_read_batch(Joystick *js, JoystickEvent events[], int max)
+     * \brief Reads all pending reports of the joystick, up to max events, and puts them in the struct. See readJoystickBatch().
+     * \param js Pointer to Joystick struct.
+     * \param events The array to copy the events to, in the format of the joystick API.
+     * \param max The length of the array.
+     * \return The number of events read, 0 if none are pending
+     * \return <0: Fail
+     */
+
+    int evdev_setup(Joystick *js);
+    void evdev_close(Joystick *js);
+    int evdev_calibrate(Joystick *js, uint8_t number, int32_t deadzone, uint8_t expo);
+    int evdev_read_batch(Joystick *js, JoystickEvent events[], int max);
+#endif
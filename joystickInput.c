@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include <sys/eventfd.h>
+
+#include "joystickInput.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+void jsinput_publish(JoystickSnapshot *s, const Joystick *js) {
+    uint32_t seq = atomic_load_explicit(&s->seq, memory_order_relaxed);
+
+    /* The reader copies state[(seq / 2) & 1], so the other one can be written without disturbing it. */
+    atomic_store_explicit(&s->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    s->state[(seq / 2 + 1) & 1] = *js;
+    atomic_store_explicit(&s->seq, seq + 2, memory_order_release);
+}
+
+void jsinput_snapshot(JoystickSnapshot *s, Joystick *js) {
+    uint32_t seq;
+
+    /* Only the second publish after the copied state writes it again: when that one started, copy again. */
+    do {
+        seq = atomic_load_explicit(&s->seq, memory_order_acquire) & ~1u;
+        *js = s->state[(seq / 2) & 1];
+        atomic_thread_fence(memory_order_acquire);
+    } while(atomic_load_explicit(&s->seq, memory_order_relaxed) - seq > 2);
+}
+
+static void *jsinput_worker(void *arg) {
+    JoystickInput *in = arg;
+    JoystickEvent events[JOYSTICK_BATCH];
+    JoystickInputEvent *item;
+    struct pollfd fds[2];
+    uint64_t first, expected;
+    int n;
+
+    fds[0].fd = in->js->fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = in->wake_fd;
+    fds[1].events = POLLIN;
+
+    while(atomic_load_explicit(&in->running, memory_order_acquire)) {
+        if(poll(fds, 2, -1) < 0) {
+            if(errno == EINTR)
+                continue;
+            break;
+        }
+        if(!(fds[0].revents & (POLLIN | POLLERR | POLLHUP)))
+            continue;
+
+        do {
+            n = readJoystickBatch(in->js, events, JOYSTICK_BATCH);
+            if(n <= 0)
+                break;
+
+            first = in->js->events - n;
+            for(int i = 0; i < n; i++) {
+                item = spsc_claim(&in->events);
+                if(item == NULL)
+                    continue;
+                item->number = first + i + 1;
+                item->timestamp_ns = in->js->timestamp_ns;
+                item->event = events[i];
+                spsc_push(&in->events);
+            }
+
+            /* All events of the batch are applied before the state is published. */
+            jsinput_publish(&in->snapshot, in->js);
+            expected = 0;
+            atomic_compare_exchange_strong_explicit(&in->origin_ns, &expected, in->js->timestamp_ns,
+                                                    memory_order_relaxed, memory_order_relaxed);
+        } while(n == JOYSTICK_BATCH);
+
+        /* An unplugged joystick stays readable, polling it again would spin. */
+        if(n < 0 || (n == 0 && (fds[0].revents & (POLLERR | POLLHUP)))) {
+            terminalColor(31);
+            printf("Lost the joystick, stopped reading it\n");
+            terminalColor(0);
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+int jsinput_start(JoystickInput *in, Joystick *js) {
+    memset(in, 0, sizeof(JoystickInput));
+    in->js = js;
+    in->wake_fd = -1;
+    jsinput_publish(&in->snapshot, js);
+
+    if(spsc_setup(&in->events, JOYSTICK_INPUT_QUEUE, sizeof(JoystickInputEvent)) < 0)
+        return -1;
+
+    in->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(in->wake_fd < 0) {
+        spsc_free(&in->events);
+        return -1;
+    }
+
+    atomic_store_explicit(&in->running, 1, memory_order_release);
+    if(pthread_create(&in->thread, NULL, jsinput_worker, in) != 0) {
+        terminalColor(31);
+        printf("Could not start the joystick input thread\n");
+        terminalColor(0);
+        jsinput_stop(in);
+        return -1;
+    }
+    in->started = 1;
+
+    return 0;
+}
+
+void jsinput_stop(JoystickInput *in) {
+    uint64_t one = 1;
+
+    if(in->started) {
+        atomic_store_explicit(&in->running, 0, memory_order_release);
+        if(write(in->wake_fd, &one, sizeof(one)) < 0)
+            pthread_cancel(in->thread);
+        pthread_join(in->thread, NULL);
+        in->started = 0;
+    }
+
+    if(in->wake_fd >= 0)
+        close(in->wake_fd);
+    in->wake_fd = -1;
+    spsc_free(&in->events);
+}
+
+uint64_t jsinput_read(JoystickInput *in, Joystick *js) {
+    jsinput_snapshot(&in->snapshot, js);
+
+    return atomic_exchange_explicit(&in->origin_ns, 0, memory_order_relaxed);
+}
+
+int jsinput_event(JoystickInput *in, const Joystick *js, JoystickInputEvent *event) {
+    JoystickInputEvent *front = spsc_front(&in->events);
+
+    /* Events newer than the state are left for the next call, so the log matches what the control law saw. */
+    if(front == NULL || front->number > js->events)
+        return 0;
+
+    *event = *front;
+    spsc_pop(&in->events);
+
+    return 1;
+}
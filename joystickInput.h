@@ -0,0 +1,100 @@
+/**
+ * \file joystickInput.h
+ * \date 16 October 2026
+ * \brief File containing the joystick input thread.
+ *
+ * This file contains the function declarations for reading the joystick on its own thread, as well as the definition of the
+ * JoystickInput struct. The thread drains all pending events with one read(), applies them and publishes the new state
+ * in a double-buffered snapshot:
+ * \code
+ * input thread: readJoystickBatch() --> state[(seq + 1) & 1], seq++ --> SpscQueue of events (for the log)
+ * control thread: copy state[seq & 1], retry if seq changed
+ * \endcode
+ * The control thread never waits for the input thread, and always sees the state after the last batch of events.
+ */
+
+#ifndef JOYSTICK_INPUT
+#define JOYSTICK_INPUT
+    #include <stdint.h>
+    #include <stdatomic.h>
+    #include <pthread.h>
+    #include "joystick.h"
+    #include "spscQueue.h"
+
+    #define JOYSTICK_INPUT_QUEUE 1024   //!< The number of events the input thread can be ahead of the log.
+
+    /**
+     * \brief Defines the double-buffered state of the joystick, written by one thread and read by another.
+     */
+    typedef struct {
+        Joystick state[2];          //!< The last two published states, the newest is state[(seq / 2) & 1].
+        _Atomic uint32_t seq;       //!< Twice the number of published states, odd while one is written.
+    } JoystickSnapshot;
+
+    /**
+     * \brief Defines one event read by the input thread, passed to the control thread to log it.
+     */
+    typedef struct {
+        uint64_t number;            //!< The value of Joystick.events after applying the event.
+        uint64_t timestamp_ns;      //!< The CLOCK_MONOTONIC time the event was read.
+        JoystickEvent event;        //!< The event.
+    } JoystickInputEvent;
+
+    /**
+     * \brief Defines the input thread of a joystick.
+     */
+    typedef struct {
+        Joystick *js;               //!< The joystick, only used by the input thread after jsinput_start().
+        JoystickSnapshot snapshot;  //!< The state for the control thread.
+        _Atomic uint64_t origin_ns; //!< The time the oldest event not yet taken by jsinput_read() was read, 0 if none.
+        SpscQueue events;           //!< The events read (JoystickInputEvent).
+        pthread_t thread;           //!< The input thread.
+        uint8_t started;            //!< Is the input thread running?
+        _Atomic uint8_t running;    //!< Cleared to stop the input thread.
+        int wake_fd;                //!< An eventfd to wake the input thread when it has to stop.
+    } JoystickInput;
+
+    /**
+     * \fn void jsinput_publish(JoystickSnapshot *s, const Joystick *js)
+     * \brief Writer: publish a new state. Only one thread may publish.
+     * \param s Pointer to JoystickSnapshot struct.
+     * \param js The new state.
+     *
+     * \fn void jsinput_snapshot(JoystickSnapshot *s, Joystick *js)
+     * \brief Reader: copy the newest state, without ever waiting for the writer.
+     * \param s Pointer to JoystickSnapshot struct.
+     * \param js The copy of the state.
+     *
+     * \fn int jsinput_start(JoystickInput *in, Joystick *js)
+     * \brief Start reading a joystick on its own thread.
+     * \param in Pointer to JoystickInput struct.
+     * \param js The joystick, set up with setupJoystick().
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void jsinput_stop(JoystickInput *in)
+     * \brief Stop the input thread. The joystick can be closed afterwards.
+     * \param in Pointer to JoystickInput struct.
+     *
+     * \fn uint64_t jsinput_read(JoystickInput *in, Joystick *js)
+     * \brief Get the newest state of the joystick.
+     * \param in Pointer to JoystickInput struct.
+     * \param js The copy of the state.
+     * \return The time the oldest event since the previous call was read, 0 if there were none.
+     *
+     * \fn int jsinput_event(JoystickInput *in, const Joystick *js, JoystickInputEvent *event)
+     * \brief Get the next event that is part of a state from jsinput_read(), to log it.
+     * \param in Pointer to JoystickInput struct.
+     * \param js The state from jsinput_read().
+     * \param event The event.
+     * \return 1: An event was read
+     * \return 0: No more events in the state
+     */
+
+    void jsinput_publish(JoystickSnapshot *s, const Joystick *js);
+    void jsinput_snapshot(JoystickSnapshot *s, Joystick *js);
+    int jsinput_start(JoystickInput *in, Joystick *js);
+    void jsinput_stop(JoystickInput *in);
+    uint64_t jsinput_read(JoystickInput *in, Joystick *js);
+    int jsinput_event(JoystickInput *in, const Joystick *js, JoystickInputEvent *event);
+#endif
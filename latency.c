@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+
+#include "latency.h"
+
+static LatencyHistogram histograms[LATENCY_STAGES];
+static _Thread_local uint64_t origin;    //!< Per thread, an I/O thread sets the origin of the frames it sends.
+static _Atomic int64_t js_offset = INT64_MAX;
+
+static const char *names[LATENCY_STAGES] = {
+    "js read",
+    "js to tick",
+    "tick wake",
+    "build",
+    "tick queue",
+    "pack",
+    "submit",
+    "complete",
+    "total"
+};
+
+static unsigned int bucket_index(uint64_t ns) {
+    unsigned int exponent;
+
+    if(ns < (1u << LATENCY_SUB_BITS))
+        return ns;
+    if(ns >= (2ULL << LATENCY_MAX_EXPONENT))
+        return LATENCY_BUCKETS - 1;
+
+    exponent = 63 - __builtin_clzll(ns);
+    return ((exponent - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS) +
+           ((ns >> (exponent - LATENCY_SUB_BITS)) & ((1u << LATENCY_SUB_BITS) - 1));
+}
+
+static uint64_t bucket_upper(unsigned int index) {
+    unsigned int exponent, mantissa;
+
+    if(index < (1u << LATENCY_SUB_BITS))
+        return index;
+
+    exponent = (index >> LATENCY_SUB_BITS) + LATENCY_SUB_BITS - 1;
+    mantissa = index & ((1u << LATENCY_SUB_BITS) - 1);
+    return (((uint64_t)(1u << LATENCY_SUB_BITS) + mantissa + 1) << (exponent - LATENCY_SUB_BITS)) - 1;
+}
+
+uint64_t latency_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+void latency_record(LatencyStage stage, int64_t ns) {
+    LatencyHistogram *h = &histograms[stage];
+    uint64_t value = (ns > 0) ? (uint64_t)ns : 0;
+    uint64_t max = atomic_load_explicit(&h->max_ns, memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&h->buckets[bucket_index(value)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->sum_ns, value, memory_order_relaxed);
+    while(value > max && !atomic_compare_exchange_weak_explicit(&h->max_ns, &max, value,
+                                                                memory_order_relaxed, memory_order_relaxed));
+}
+
+void latency_js_event(uint32_t event_ms, uint64_t read_ns) {
+    /* Both clocks in ms, the difference only makes sense modulo 2^32. */
+    int64_t diff = (int32_t)((uint32_t)(read_ns / 1000000) - event_ms);
+    int64_t offset = atomic_load_explicit(&js_offset, memory_order_relaxed);
+
+    while(diff < offset && !atomic_compare_exchange_weak_explicit(&js_offset, &offset, diff,
+                                                                  memory_order_relaxed, memory_order_relaxed));
+    if(diff < offset)
+        offset = diff;
+
+    latency_record(LATENCY_JS_READ, (diff - offset) * 1000000);
+}
+
+void latency_set_origin(uint64_t ns) {
+    origin = ns;
+}
+
+uint64_t latency_origin(void) {
+    return origin;
+}
+
+uint64_t latency_percentile(LatencyStage stage, double percentile) {
+    const LatencyHistogram *h = &histograms[stage];
+    uint64_t count = atomic_load_explicit(&h->count, memory_order_relaxed);
+    uint64_t max = atomic_load_explicit(&h->max_ns, memory_order_relaxed);
+    uint64_t target, seen = 0;
+
+    if(count == 0)
+        return 0;
+
+    target = (uint64_t)(count * percentile / 100.0);
+    if(target == 0)
+        target = 1;
+    if(target > count)
+        target = count;
+
+    for(unsigned int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+        if(seen >= target)
+            return (bucket_upper(i) < max) ? bucket_upper(i) : max;
+    }
+
+    return max;
+}
+
+const LatencyHistogram *latency_histogram(LatencyStage stage) {
+    return &histograms[stage];
+}
+
+void latency_print(void) {
+    const LatencyHistogram *h;
+    uint64_t count;
+
+    printf("Latency (us)      count       mean        p50        p99      p99.9        max\n");
+    for(int i = 0; i < LATENCY_STAGES; i++) {
+        h = &histograms[i];
+        count = atomic_load_explicit(&h->count, memory_order_relaxed);
+        if(count == 0)
+            continue;
+
+        printf("%-12s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", names[i], (unsigned long long)count,
+               atomic_load_explicit(&h->sum_ns, memory_order_relaxed) / (double)count / 1000.0,
+               latency_percentile(i, 50.0) / 1000.0, latency_percentile(i, 99.0) / 1000.0,
+               latency_percentile(i, 99.9) / 1000.0,
+               atomic_load_explicit(&h->max_ns, memory_order_relaxed) / 1000.0);
+    }
+}
+
+void latency_reset(void) {
+    for(int i = 0; i < LATENCY_STAGES; i++) {
+        for(unsigned int k = 0; k < LATENCY_BUCKETS; k++)
+            atomic_store_explicit(&histograms[i].buckets[k], 0, memory_order_relaxed);
+        atomic_store_explicit(&histograms[i].count, 0, memory_order_relaxed);
+        atomic_store_explicit(&histograms[i].sum_ns, 0, memory_order_relaxed);
+        atomic_store_explicit(&histograms[i].max_ns, 0, memory_order_relaxed);
+    }
+}
@@ -0,0 +1,101 @@
+/**
+ * \file latency.h
+ * \date 16 October 2026
+ * \brief File containing the latency tracepoints of the control path.
+ *
+ * This file contains the function declarations for measuring every stage between a joystick event and the frames leaving the PC.
+ * Every stage has a lock-free histogram with logarithmic buckets (HDR style): 32 buckets per power of two, so every value is
+ * kept with an error below 3%, from 1 ns up to about 18 minutes. Recording a value is one clock read and a few atomic adds.
+ *
+ * The end-to-end latency starts when the oldest joystick event handled by a tick is read. The tick sets it as the origin with
+ * latency_set_origin(), the transports pass it along with the transfer and record the total when the frames have left.
+ * The origin is kept per thread, a transport that sends from another thread passes it along and sets it there.
+ */
+
+#ifndef LATENCY
+#define LATENCY
+    #include <stdint.h>
+    #include <stdatomic.h>
+
+    #define LATENCY_SUB_BITS        5   //!< 2^LATENCY_SUB_BITS buckets per power of two.
+    #define LATENCY_MAX_EXPONENT    40  //!< Values of 2^(LATENCY_MAX_EXPONENT + 1) ns and more go in the last bucket.
+    #define LATENCY_BUCKETS         ((LATENCY_MAX_EXPONENT - LATENCY_SUB_BITS + 2) << LATENCY_SUB_BITS)
+
+    /**
+     * \brief Defines the measured stages.
+     */
+    typedef enum {
+        LATENCY_JS_READ = 0,    //!< The kernel timestamp of a joystick event to reading it (ms resolution, µs with evdev).
+        LATENCY_JS_TICK,        //!< Reading a joystick event to the start of the tick handling it.
+        LATENCY_WAKE,           //!< The deadline of a tick to the start of the tick.
+        LATENCY_BUILD,          //!< The start of a tick to all frames built.
+        LATENCY_QUEUE,          //!< The control thread handing the frames of a tick to the I/O thread (see pipeline.h).
+        LATENCY_PACK,           //!< Packing the frames in the format of the device.
+        LATENCY_SUBMIT,         //!< Handing the frames to the device (libusb_submit_transfer(), sendmmsg()).
+        LATENCY_COMPLETE,       //!< Submitting a transfer to its completion.
+        LATENCY_TOTAL,          //!< Reading a joystick event to the frames of its tick leaving the PC.
+        LATENCY_STAGES
+    } LatencyStage;
+
+    /**
+     * \brief Defines the histogram of one stage.
+     */
+    typedef struct {
+        _Atomic uint64_t buckets[LATENCY_BUCKETS];  //!< The number of values per bucket.
+        _Atomic uint64_t count;                     //!< The number of values.
+        _Atomic uint64_t sum_ns;                    //!< The sum of all values, to calculate the mean.
+        _Atomic uint64_t max_ns;                    //!< The highest value.
+    } LatencyHistogram;
+
+    /**
+     * \fn uint64_t latency_now(void)
+     * \brief Get the time for a tracepoint.
+     * \return The CLOCK_MONOTONIC time in ns.
+     *
+     * \fn void latency_record(LatencyStage stage, int64_t ns)
+     * \brief Add a value to the histogram of a stage. Can be called from any thread.
+     * \param stage The stage.
+     * \param ns The latency in ns, negative values count as 0.
+     *
+     * \fn void latency_js_event(uint32_t event_ms, uint64_t read_ns)
+     * \brief Record the delay between the kernel timestamp of a joystick event and reading it.
+     * The kernel time has another origin, the smallest difference seen so far is taken as zero delay.
+     * \param event_ms The time of the event (js_event.time).
+     * \param read_ns The CLOCK_MONOTONIC time the event was read.
+     *
+     * \fn void latency_set_origin(uint64_t ns)
+     * \brief Set the start of the end-to-end latency of the frames that are sent next by the calling thread.
+     * \param ns The CLOCK_MONOTONIC time of the oldest input, 0 if the frames do not follow from new input.
+     *
+     * \fn uint64_t latency_origin(void)
+     * \brief Get the start of the end-to-end latency of the frames that are sent now by the calling thread.
+     * \return The CLOCK_MONOTONIC time, 0 if none.
+     *
+     * \fn uint64_t latency_percentile(LatencyStage stage, double percentile)
+     * \brief Get a percentile of a stage.
+     * \param stage The stage.
+     * \param percentile The percentile, 0 up to 100.
+     * \return The upper bound of the bucket containing the percentile in ns, 0 if there are no values.
+     *
+     * \fn const LatencyHistogram *latency_histogram(LatencyStage stage)
+     * \brief Get the histogram of a stage.
+     * \param stage The stage.
+     * \return The histogram.
+     *
+     * \fn void latency_print(void)
+     * \brief Print the count, mean, p50, p99, p99.9 and maximum of every stage with values.
+     *
+     * \fn void latency_reset(void)
+     * \brief Clear all histograms.
+     */
+
+    uint64_t latency_now(void);
+    void latency_record(LatencyStage stage, int64_t ns);
+    void latency_js_event(uint32_t event_ms, uint64_t read_ns);
+    void latency_set_origin(uint64_t ns);
+    uint64_t latency_origin(void);
+    uint64_t latency_percentile(LatencyStage stage, double percentile);
+    const LatencyHistogram *latency_histogram(LatencyStage stage);
+    void latency_print(void);
+    void latency_reset(void);
+#endif
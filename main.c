@@ -19,145 +19,523 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <signal.h>
+#include <string.h>
+#include <limits.h>
 
 #include <sys/ioctl.h>
-#include <sys/time.h>
 
 #include "panda.h"
+#include "transport.h"
 #include "joystick.h"
+#include "joystickEvdev.h"
+#include "joystickInput.h"
 #include "toyotaRav4.h"
+#include "scheduler.h"
+#include "reactor.h"
+#include "recorder.h"
+#include "control.h"
+#include "replay.h"
+#include "latency.h"
+#include "telemetry.h"
+#include "healthMonitor.h"
+#include "pipeline.h"
 
 typedef struct {
     char *js;
+    char *profile;
+    char *log;
+    char *replay;
+    char *transport;
+    char *telemetry;
     uint8_t enableDsu;
     uint8_t enableCam;
+    uint8_t realtime;
+    uint8_t threadedInput;
+    uint8_t pipeline;
+    uint8_t calibrate;
+    int deadzone;
+    int expo;
+    int cpus[PIPELINE_STAGES];
+    uint32_t tick_us;
 } Params;
 
-typedef struct timeval Time;
-
 #define terminalColor(color) printf("\033[%dm", color)
 
+#define DEFAULT_RATE    100     //!< The default rate of the control loop in Hz.
+#define MAX_RATE        1000    //!< The highest rate of the control loop in Hz.
+#define RT_PRIORITY     80      //!< The SCHED_FIFO priority used in real-time mode.
+#define RX_RING_SIZE    4096    //!< The number of received frames kept in the ring.
+#define LOG_CAPACITY    (1 << 24)   //!< The number of records in a log file (512 MB, about 45 minutes of driving).
+#define DEFAULT_PROFILE "profiles/toyotaRav4.profile"   //!< Relative to the directory of the executable.
+#define DEFAULT_TRANSPORT "panda"
+
+/* The profiles are next to the executable, so it can be started from any directory. */
+static char *defaultProfile(void) {
+    static char path[PATH_MAX];
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    char *slash;
+
+    if(length < 0)
+        return DEFAULT_PROFILE;
+    path[length] = '\0';
+
+    slash = strrchr(path, '/');
+    if(slash == NULL || (size_t)(slash + 1 - path) + sizeof(DEFAULT_PROFILE) > sizeof(path))
+        return DEFAULT_PROFILE;
+    strcpy(slash + 1, DEFAULT_PROFILE);
+    return path;
+}
 
 int getParams(int argc, char *argv[], Params *params) {
-    if(argc <= 1) {
-        printf("%s \033[31m<cam-dsu>\033[32m [<js>]\033[0m\n"
+    int opt;
+    long rate;
+    char *end;
+
+    memset(params, 0, sizeof(Params));
+    params->profile = defaultProfile();
+    params->transport = DEFAULT_TRANSPORT;
+    params->telemetry = TELEMETRY_NAME;
+    params->tick_us = 1000000 / DEFAULT_RATE;
+
+    while((opt = getopt(argc, argv, "rTM:f:d:p:l:P:t:S:")) != -1) {
+        switch(opt) {
+            case 'r':
+                params->realtime = 1;
+                break;
+            case 'T':
+                params->threadedInput = 1;
+                break;
+            case 'M':
+                /* The control law gets its own thread, it reads the joystick state of the input thread. */
+                if(sscanf(optarg, "%d,%d,%d", &params->cpus[PIPELINE_INPUT], &params->cpus[PIPELINE_CONTROL],
+                          &params->cpus[PIPELINE_IO]) != PIPELINE_STAGES)
+                    argc = 0;
+                params->pipeline = 1;
+                params->threadedInput = 1;
+                break;
+            case 'f':
+                rate = strtol(optarg, &end, 10);
+                if(*end != '\0' || rate <= 0 || rate > MAX_RATE)
+                    argc = 0;
+                else
+                    params->tick_us = 1000000 / rate;
+                break;
+            case 'd':
+                if(sscanf(optarg, "%d,%d", &params->deadzone, &params->expo) != 2 || params->expo < 0 || params->expo > 100)
+                    argc = 0;
+                params->calibrate = 1;
+                break;
+            case 'p':
+                params->profile = optarg;
+                break;
+            case 'l':
+                params->log = optarg;
+                break;
+            case 'P':
+                params->replay = optarg;
+                break;
+            case 't':
+                params->transport = optarg;
+                break;
+            case 'S':
+                params->telemetry = optarg;
+                break;
+            default:
+                argc = 0;
+                break;
+        }
+    }
+
+    if(argc <= optind) {
+        printf("%s [-r] [-T] [-M <cpu>,<cpu>,<cpu>] [-f <Hz>] [-d <deadzone>,<expo>] [-p <profile>] [-l <log>] [-P <log>] [-t <transport>] [-S <name>] \033[31m<cam-dsu>\033[32m [<js>]\033[0m\n"
+               " -r\t\t Real-time mode (SCHED_FIFO, locked memory)\n"
+               " -T\t\t Read the joystick on its own thread\n"
+               " -M\t\t Run input, control and I/O on their own threads, pinned to these CPUs (-1: not pinned)\n"
+               " -f\t\t Rate of the control loop, the periods of the profile must be whole ticks\t(default: %d Hz)\n"
+               " -d\t\t Deadzone (in device units, -1: of the device) and response curve (0: linear, 100: cubic) of an evdev joystick\n"
+               " -p\t\t Vehicle profile\t(default: " DEFAULT_PROFILE " next to the executable)\n"
+               " -l\t\t Record all frames and joystick events to a log file\n"
+               " -P\t\t Replay a log offline, and compare the frames with the log\n"
+               " -t\t\t CAN transport: panda, pandas[:<serial>[@<cpu>],...], socketcan:<if>[,<if>...] or loopback\t(default: " DEFAULT_TRANSPORT ")\n"
+               " -S\t\t Shared memory to publish the telemetry in, read with tools/telemetry\t(default: " TELEMETRY_NAME ")\n"
                " cam-dsu\t C, D or CD\n"
-               " js\t\t Joystick/Gamepad\t(default: /dev/input/js0)\n", argv[0]);
+               " js\t\t Joystick/Gamepad, /dev/input/jsX or /dev/input/eventX\t(default: /dev/input/js0)\n", argv[0], DEFAULT_RATE);
 
         return -1;
     }
 
-    params->js = (argc > 4) ? argv[4] : "/dev/input/js0";
+    params->js = (argc > optind + 1) ? argv[optind + 1] : "/dev/input/js0";
 
-    if(argv[1][0] == 'C')
+    if(argv[optind][0] == 'C')
         params->enableCam = 1;
-    if(argv[1][0] == 'D' || argv[1][1] == 'D')
+    if(argv[optind][0] == 'D' || argv[optind][1] == 'D')
         params->enableDsu = 1;
     if(!(params->enableCam || params->enableDsu))
-        getParams(0, argv, NULL);
+        return getParams(0, argv, params);
 
     return 0;
 }
 
-uint8_t running = 1;
+volatile sig_atomic_t running = 1;
 void signal_handler(int signal) {
     running = 0;
 }
 
+volatile sig_atomic_t dump_latency = 0;
+void dump_handler(int signal) {
+    dump_latency = 1;
+}
+
+static Recorder recorder = {.fd = -1};
+static Telemetry telemetry = {.block = NULL};
+static Reactor reactor = {.epfd = -1};
+static CANCache rx_cache;
+static ToyotaRav4State vehicle;
+static uint64_t js_origin = 0;      //!< The time the oldest joystick event not yet handled by a tick was read.
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+int runReplay(Params *params, VehicleProfile *profile) {
+    static CANCache cache;
+    RecorderLog log;
+    Control control;
+    FrameArena arena;
+    Replay rp;
+    uint32_t tick_us;
+    uint64_t start;
+    double wall;
+
+    if(recorder_load(&log, params->replay) < 0)
+        return -1;
+
+    /* The frames only match when the control law runs at the rate of the log. */
+    tick_us = (log.header->tick_us != 0) ? log.header->tick_us : params->tick_us;
+    if((params->log != NULL && recorder_open(&recorder, params->log, LOG_CAPACITY, tick_us) < 0) ||
+       profile_load(profile, params->profile, tick_us) < 0 || setupToyotaRav4(profile) < 0 || arena_init(&arena) < 0) {
+        recorder_unload(&log);
+        return -1;
+    }
+
+    control_setup(&control, params->enableCam, params->enableDsu, tick_us);
+    cancache_setup(&cache);
+    replay_setup(&rp, &control, &arena, &cache, &recorder);
+
+    start = now_ns();
+    replay_run(&rp, &log);
+    wall = (now_ns() - start) / 1e9;
+
+    replay_print_stats(&rp);
+    printf("Replayed in %.3f s (%.0fx real time)\n", wall,
+           wall > 0 ? (rp.stats.last_ns - rp.stats.first_ns) / 1e9 / wall : 0.0);
+
+    arena_free(&arena);
+    recorder_unload(&log);
+    return (rp.stats.mismatches > 0) ? -1 : 0;
+}
+
+void onTimer(int fd, uint32_t events, void *ctx) {
+    scheduler_timer_read((Scheduler *)ctx);
+}
+
+void onJoystick(int fd, uint32_t events, void *ctx) {
+    JoystickEvent batch[JOYSTICK_BATCH];
+    Joystick *js = ctx;
+    int n;
+
+    /* A full batch means more events may be pending. */
+    do {
+        n = readJoystickBatch(js, batch, JOYSTICK_BATCH);
+        if(n > 0 && js_origin == 0)
+            js_origin = js->timestamp_ns;
+        for(int i = 0; i < n; i++)
+            recorder_event(&recorder, RECORD_JS, &batch[i], sizeof(JoystickEvent), js->timestamp_ns);
+    } while(n == JOYSTICK_BATCH);
+
+    /* An unplugged joystick stays readable, so it would be called again and again. */
+    if(n < 0 || (events & (EPOLLHUP | EPOLLERR))) {
+        reactor_remove(&reactor, fd);
+        terminalColor(31);
+        printf("Lost the joystick, stopped reading it\n");
+        terminalColor(0);
+    }
+}
+
+void onPipeline(int fd, uint32_t events, void *ctx) {
+    uint64_t ticks;
+
+    if(read(fd, &ticks, sizeof(ticks)) < 0) {}
+}
+
+/* The I/O of one tick: log what the control law saw, send its frames and publish the telemetry. */
+static void handleTick(PipelineTick *tick, Transport *t, JoystickInput *input, CANRingReader *rx_log,
+                       HealthMonitor *health, TelemetryState *ts) {
+    JoystickInputEvent event;
+    CANRxFrame rx;
+    const CANRxFrame *next;
+    uint64_t health_ns;
+    Health h;
+    int length;
+
+    latency_set_origin(tick->origin_ns);
+
+    if(input->started) {
+        /* Log the events of this state before the tick, like onJoystick() does. */
+        while(jsinput_event(input, &tick->js, &event) > 0)
+            recorder_event(&recorder, RECORD_JS, &event.event, sizeof(JoystickEvent), event.timestamp_ns);
+    }
+
+    /* Log everything received since the previous tick. */
+    while((next = canring_peek(rx_log)) != NULL) {
+        rx = *next;
+        if(canring_release(rx_log) == 0) {
+            recorder_rx(&recorder, &rx);
+            ts->rx_frames++;
+        }
+    }
+    recorder_tick(&recorder, tick->dropped ? RECORD_DROPPED : RECORD_TICK, tick->count, tick->tick_ns);
+
+    /* Sending empties the arena, the Panda takes its buffer. */
+    length = tick->frames.length;
+    if(length > 0) {
+        recorder_arena(&recorder, RECORD_TX, &tick->frames, now_ns());
+        transport_send_arena(t, &tick->frames);
+        ts->tx_frames += length;
+    }
+
+    ts->timestamp_ns = tick->tick_ns;
+    ts->build_ns = tick->build_ns;
+    ts->ticks = tick->sched.ticks;
+    ts->executed = tick->sched.executed;
+    ts->overruns = tick->sched.overruns;
+    ts->missed = tick->sched.missed;
+    ts->late_ns = tick->sched.last_late_ns;
+    ts->max_late_ns = tick->sched.max_late_ns;
+    ts->count = tick->count;
+    ts->steer = tick->control.steer;
+    ts->steer_count = tick->control.steer_count;
+    ts->accel = tick->control.accel;
+    ts->decel = tick->control.decel;
+    ts->buttons = 0;
+    for(int i = 0; i < 12; i++)
+        ts->buttons |= (tick->js.buttons[i] != 0) << i;
+    for(int i = 0; i < 3; i++) {
+        ts->axes[2 * i] = tick->js.axes[i].x;
+        ts->axes[2 * i + 1] = tick->js.axes[i].y;
+    }
+    ts->js_events = tick->js.events;
+    readToyotaRav4State(&rx_cache, &vehicle);
+    ts->speed = vehicle.speed;
+    ts->steer_angle = vehicle.steer_angle;
+    ts->steer_echo = vehicle.steer_echo;
+    ts->steer_echo_ns = vehicle.steer_echo_ns;
+    if((health_ns = health_read(health, &h)) != 0) {
+        ts->health = h;
+        ts->health_ns = health_ns;
+    }
+    telemetry_publish(&telemetry, ts);
+}
+
+void onHealth(const Health *h, void *ctx) {
+    terminalColor(h->controls_allowed ? 32 : 31);
+    printf("Controls %s  V:%d  Started:%d\n", h->controls_allowed ? "allowed" : "not allowed", h->voltage, h->started);
+    terminalColor(0);
+}
+
 int main(int argc, char *argv[]) {
     signal(SIGINT, signal_handler);
+    signal(SIGUSR1, dump_handler);
 
     int ret;
-    uint16_t count = 0;
 
     Joystick js;
-    Panda p;
-    CANFrame frame_list[256];
-    uint8_t list_length = 0;
+    JoystickInput input;
+    Transport t;
+    Control control;
+    PipelineTick tick;
+    static Pipeline pipe;
+    PipelineTick *built;
+
+    Scheduler sched;
+    uint64_t handled = 0;
 
-    Time time;
-    Time prev_time;
+    CANRing rx_ring;
+    CANRingReader rx_log;
+    ChecksumIdSet rx_checksum;
 
     Params params;
 
     Health h;
+    static HealthMonitor health;
+    TelemetryState ts;
+
+    static VehicleProfile profile;
+
+    js.fd = 0;
+    memset(&input, 0, sizeof(JoystickInput));     // Its statistics are printed, also when it was never started.
+    input.wake_fd = -1;
+    t.ops = NULL;
+    tick.frames.frames = NULL;
+    tick.dropped = 0;
+    sched.timer_fd = -1;
+    rx_ring.slots = NULL;
+    health.timer_fd = -1;
+    health.event_fd = -1;
 
     ret = getParams(argc, argv, &params);
     if(ret < 0) goto end;
-    ret = panda_setup(&p, 0x1336);
+    if(params.replay != NULL) {
+        ret = runReplay(&params, &profile);
+        goto end;
+    }
+    if(params.log != NULL) {
+        ret = recorder_open(&recorder, params.log, LOG_CAPACITY, params.tick_us);
+        if(ret < 0) goto end;
+    }
+    ret = profile_load(&profile, params.profile, params.tick_us);
+    if(ret < 0) goto end;
+    ret = setupToyotaRav4(&profile);
+    if(ret < 0) goto end;
+    ret = transport_open(&t, params.transport);
+    if(ret < 0) goto end;
+    ret = arena_init(&tick.frames);
     if(ret < 0) goto end;
     ret = setupJoystick(&js, params.js);
     if(ret < 0) goto end;
-    gettimeofday(&prev_time, NULL);
+    if(params.calibrate) {
+        /* The tables map the device to the events, so the log and the replay already have the calibrated values. */
+        ret = (js.evdev != NULL) ? 0 : -1;
+        for(int i = 0; i < js.numberOfAxes && ret >= 0; i++)
+            ret = evdev_calibrate(&js, i, params.deadzone, params.expo);
+        if(ret < 0) {
+            terminalColor(31);
+            printf("Only the axes of an evdev joystick (/dev/input/eventX) can be calibrated\n");
+            terminalColor(0);
+            goto end;
+        }
+    }
+    if(params.realtime)
+        scheduler_enable_realtime(RT_PRIORITY);
+
+    memset(&ts, 0, sizeof(ts));
+    if(transport_get_health(&t, &h) >= 0) {
+        printf("V:%d  Started:%d  Controls:%d\n", h.voltage, h.started, h.controls_allowed);
+        ts.health = h;
+        ts.health_ns = now_ns();
+    }
+    telemetry_open(&telemetry, params.telemetry);
 
-    panda_get_health(&p, &h);
-    printf("V:%d  Started:%d  Controls:%d\n", h.voltage, h.started, h.controls_allowed);
+    control_setup(&control, params.enableCam, params.enableDsu, params.tick_us);
 
-    int16_t steer;
-    int16_t steer_count;
-    int16_t accel = 0;
-    int16_t decel = 0;
+    ret = reactor_setup(&reactor);
+    if(ret < 0) goto end;
+    if(!params.pipeline) {
+        scheduler_setup(&sched, params.tick_us);
+        ret = reactor_add(&reactor, scheduler_timer_create(&sched), EPOLLIN, onTimer, &sched);
+        if(ret < 0) goto end;
+    }
+    if(params.threadedInput) {
+        ret = jsinput_start(&input, &js);
+        if(ret < 0) goto end;
+    } else {
+        ret = reactor_add(&reactor, js.fd, EPOLLIN, onJoystick, &js);
+        if(ret < 0) goto end;
+    }
+    ret = transport_add_to_reactor(&t, &reactor);
+    if(ret < 0) goto end;
+    if(t.ops->health_submit != NULL) {
+        ret = health_start(&health, &t, &reactor, HEALTH_PERIOD_MS, onHealth, NULL);
+        if(ret < 0) goto end;
+    }
+    ret = canring_setup(&rx_ring, RX_RING_SIZE);
+    if(ret < 0) goto end;
+    cancache_setup(&rx_cache);
+    setupToyotaRav4Checksums(&rx_checksum);
+    transport_rx_verify(&t, &rx_checksum);
+    canring_reader_setup(&rx_log, &rx_ring);
+    ret = transport_rx_start(&t, &rx_ring, &rx_cache);
+    if(ret < 0) goto end;
+    if(params.pipeline) {
+        /* From here on the control law belongs to the control thread. */
+        ret = pipeline_start(&pipe, &control, &input, params.tick_us, params.cpus);
+        if(ret < 0) goto end;
+        ret = reactor_add(&reactor, pipe.event_fd, EPOLLIN, onPipeline, &pipe);
+        if(ret < 0) goto end;
+    }
 
     while(running) {
-        gettimeofday(&time, NULL);
-
-        readJoystick(&js);
-
-        // 100 Hz
-        if((time.tv_usec + ((time.tv_sec - prev_time.tv_sec) * 1000000)) >= (prev_time.tv_usec + 10000)) {
-            if(params.enableCam) {
-                steer = (js.axes[0].x * (-1))/22;
-                //steer = (steer > 1500) ? 1500 : ((steer < -1500) ? -1500 : steer);
-                if(steer > (steer_count + 30))
-                    steer_count += 30;
-                if(steer < (steer_count - 30))
-                    steer_count -= 30;
-
-                if(steer == 0)
-                    steer_count = 0;
-
-                list_length += sendSteerCommand(frame_list, count, steer_count);               // Cam
-
-                list_length += sendStaticVideo(frame_list + list_length, count);               // Cam
-                list_length += sendStaticCam(frame_list + list_length, count);                 // Cam
+        reactor_run_once(&reactor, -1);
 
-                list_length += sendUiCommand(frame_list + list_length, count, 0);              // Cam
-                list_length += sendFcwCommand(frame_list + list_length, count, 0);             // Cam
-            }
-
-            if(params.enableDsu) {
-                accel = (js.buttons[1] * !js.buttons[2] * (accel + 10));
-                decel = (js.buttons[2] * (decel - 20));
+        if(dump_latency) {
+            dump_latency = 0;
+            latency_print();
+        }
 
-                accel = (accel > 1500) ? 1500 : accel;
-                decel = (decel < -3000) ? -3000 : decel;
-                list_length += sendAccelCommand(frame_list + list_length, count, accel + decel, js.buttons[3]);  // Dsu
-                list_length += sendStaticDsu(frame_list + list_length, count);                               // Dsu
+        // Every tick
+        if(params.pipeline) {
+            while((built = pipeline_front(&pipe)) != NULL) {
+                handleTick(built, &t, &input, &rx_log, &health, &ts);
+                pipeline_pop(&pipe);
             }
-
-            count++;
-            prev_time.tv_usec = time.tv_usec;
-            prev_time.tv_sec  = time.tv_sec;
-
-            if(list_length > 0) {
-                panda_can_send_many(&p, frame_list, list_length);
+        } else if(sched.executed != handled) {
+            handled = sched.executed;
+            tick.tick_ns = now_ns();
+
+            if(params.threadedInput) {
+                js_origin = jsinput_read(&input, &tick.js);
+            } else {
+                tick.js = js;
             }
+            tick.origin_ns = js_origin;
+            js_origin = 0;
 
-            list_length = 0;
+            pipeline_build(&tick, &control, &sched);
+            handleTick(&tick, &t, &input, &rx_log, &health, &ts);
         }
-
-        usleep(10);
     }
 
     printf("\n");
+    /* The control thread still builds ticks and records their latency, stop it before the statistics are printed. */
+    pipeline_join(&pipe);
+    if(params.pipeline)
+        pipeline_print_stats(&pipe);
+    else
+        scheduler_print_stats(&sched);
+    transport_print_stats(&t);
+    if(health.timer_fd >= 0)
+        health_print_stats(&health);
+    latency_print();
+    if(recorder_dropped(&recorder) > 0)
+        printf("Log full, dropped %llu records\n", (unsigned long long)recorder_dropped(&recorder));
+    if(tick.frames.overflows > 0) {
+        terminalColor(31);
+        printf("Frames that did not fit in their tick: %llu\n", (unsigned long long)tick.frames.overflows);
+        terminalColor(0);
+    }
 
     end:
+    pipeline_stop(&pipe);
+    scheduler_close(&sched);
+    jsinput_stop(&input);
+    if(input.events.full > 0)
+        printf("Joystick events not logged: %llu\n", (unsigned long long)input.events.full);
     if(js.fd != 0) {
-        close(js.fd);
+        closeJoystick(&js);
         terminalColor(32);
         printf("Closed Joystick\n");
         terminalColor(0);
     }
-    if(p.handle != 0) panda_close(&p);
-    return 0;
+    transport_close(&t);
+    health_stop(&health);
+    arena_free(&tick.frames);
+    canring_free(&rx_ring);
+    reactor_close(&reactor);
+    closeToyotaRav4();
+    recorder_close(&recorder);
+    telemetry_close(&telemetry);
+    return (ret < 0) ? 1 : 0;
 }
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <stdatomic.h>
 
 #include <libusb-1.0/libusb.h>
 
@@ -8,11 +10,94 @@
 
 #define terminalColor(color) printf("\033[%dm", color)
 
+#define PANDA_TX_TIMEOUT 20   //!< Timeout of a CAN send in ms, so a stalled endpoint can't keep a slot forever.
+#define PANDA_HEALTH_TIMEOUT 100    //!< Timeout of an asynchronous health read in ms.
+
+_Static_assert(PANDA_FRAME_SIZE == ARENA_FRAME_SIZE && PANDA_TX_MAX_FRAMES == ARENA_MAX_FRAMES,
+               "The buffer of a FrameArena is swapped with the buffer of a transfer");
+
+static int64_t elapsed_ns(const struct timespec *from) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - from->tv_sec) * 1000000000LL + (now.tv_nsec - from->tv_nsec);
+}
+
+static int panda_tx_setup(Panda *p) {
+    for(int i = 0; i < PANDA_TX_SLOTS; i++) {
+        p->tx[i].busy = 0;
+        p->tx[i].transfer = libusb_alloc_transfer(0);
+        p->tx[i].buffer = aligned_alloc(64, PANDA_TX_MAX_FRAMES * PANDA_FRAME_SIZE);
+        if(p->tx[i].transfer == NULL || p->tx[i].buffer == NULL)
+            return LIBUSB_ERROR_NO_MEM;
+    }
+
+    return 0;
+}
+
+static int panda_busy_transfers(Panda *p) {
+    int busy = p->rx_pending + atomic_load(&p->health_busy);
+
+    for(int i = 0; i < PANDA_TX_SLOTS; i++)
+        busy += p->tx[i].busy;
+
+    return busy;
+}
+
+static void panda_wait_transfers(Panda *p) {
+    struct timeval tv = {0, 1000};
+
+    /* Cancelled transfers still call back, wait for them before freeing. */
+    for(int tries = 0; panda_busy_transfers(p) > 0 && tries < 1000; tries++)
+        libusb_handle_events_timeout(p->ctx, &tv);
+}
+
+static void panda_tx_free(Panda *p) {
+    for(int i = 0; i < PANDA_TX_SLOTS; i++) {
+        if(p->tx[i].busy)
+            libusb_cancel_transfer(p->tx[i].transfer);
+    }
+
+    panda_wait_transfers(p);
+
+    for(int i = 0; i < PANDA_TX_SLOTS; i++) {
+        if(p->tx[i].transfer != NULL)
+            libusb_free_transfer(p->tx[i].transfer);
+        free(p->tx[i].buffer);
+        p->tx[i].transfer = NULL;
+        p->tx[i].buffer = NULL;
+    }
+}
+
 int panda_setup(Panda *p, int mode) {
+    return panda_setup_serial(p, mode, NULL);
+}
+
+int panda_setup_serial(Panda *p, int mode, const char *serial) {
+    p->ctx = NULL;
     p->handle = 0;
+    p->reactor = NULL;
+    p->threaded = 0;
+    snprintf(p->serial, PANDA_SERIAL_LENGTH, "%s", (serial != NULL) ? serial : "");
+    p->tx_next = 0;
+    memset(p->tx, 0, sizeof(p->tx));
+    memset(&p->tx_stats, 0, sizeof(PandaTxStats));
+    memset(p->rx, 0, sizeof(p->rx));
+    p->rx_buffer = NULL;
+    p->rx_ring = NULL;
+    p->rx_cache = NULL;
+    p->rx_checksum = NULL;
+    p->rx_active = 0;
+    p->rx_pending = 0;
+    memset(&p->rx_stats, 0, sizeof(PandaRxStats));
+    p->health = NULL;
+    p->health_buffer = NULL;
+    p->health_done = NULL;
+    p->health_ctx = NULL;
+    atomic_init(&p->health_busy, 0);
     int ret;
 
-    ret = libusb_init(NULL);
+    ret = libusb_init(&p->ctx);
 
     if(ret < 0) {
         terminalColor(31);
@@ -30,12 +115,65 @@ int panda_setup(Panda *p, int mode) {
         return ret;
     }
 
+    ret = panda_tx_setup(p);
+
+    if(ret < 0) {
+        terminalColor(31);
+        printf("Unable to allocate transfers\n");
+        terminalColor(0);
+        return ret;
+    }
+
     panda_set_safety_mode(p, mode);
 
     return 0;
 }
 
+static int panda_is_panda(const struct libusb_device_descriptor *desc) {
+    return desc->idVendor == 0xbbaa && (desc->idProduct == 0xddcc || desc->idProduct == 0xddee);
+}
+
+static void panda_read_serial(libusb_device_handle *handle, const struct libusb_device_descriptor *desc, char *serial) {
+    int ret = libusb_get_string_descriptor_ascii(handle, desc->iSerialNumber, (unsigned char*)serial, PANDA_SERIAL_LENGTH - 1);
+
+    serial[(ret > 0) ? ret : 0] = '\0';
+}
+
+int panda_list(char serials[][PANDA_SERIAL_LENGTH], int max) {
+    struct libusb_device_descriptor desc;
+    libusb_device_handle *handle;
+    libusb_context *ctx;
+    libusb_device **devices;
+    int n = 0;
+    int ret;
+
+    ret = libusb_init(&ctx);
+    if(ret < 0)
+        return ret;
+
+    ret = libusb_get_device_list(ctx, &devices);
+    if(ret < 0) {
+        libusb_exit(ctx);
+        return ret;
+    }
+
+    for(int i = 0; devices[i] && n < max; ++i) {
+        if(libusb_get_device_descriptor(devices[i], &desc) < 0 || !panda_is_panda(&desc))
+            continue;
+        if(libusb_open(devices[i], &handle) < 0)
+            continue;
+
+        panda_read_serial(handle, &desc, serials[n++]);
+        libusb_close(handle);
+    }
+
+    libusb_free_device_list(devices, 1);
+    libusb_exit(ctx);
+    return n;
+}
+
 int panda_connect(Panda *p) {
+    char serial[PANDA_SERIAL_LENGTH];
     libusb_device **devices;
     ssize_t cnt;
     int ret;
@@ -43,7 +181,7 @@ int panda_connect(Panda *p) {
     if(p->handle != 0)
         panda_close(p);
 
-    cnt = libusb_get_device_list(NULL, &devices);
+    cnt = libusb_get_device_list(p->ctx, &devices);
     if(cnt < 0) {
         terminalColor(31);
         printf("No devices\n");
@@ -61,7 +199,7 @@ int panda_connect(Panda *p) {
         }
 
         //printf("%d %04x %04x\n", i, p->desc.idVendor, p->desc.idProduct);
-        if(p->desc.idVendor == 0xbbaa && (p->desc.idProduct == 0xddcc || p->desc.idProduct == 0xddee)) {
+        if(panda_is_panda(&p->desc)) {
             ret = libusb_open(devices[i], &(p->handle));
             if(ret < 0) {
                 terminalColor(31);
@@ -70,6 +208,14 @@ int panda_connect(Panda *p) {
                 return ret;
             }
 
+            panda_read_serial(p->handle, &p->desc, serial);
+            if(p->serial[0] != '\0' && strcmp(serial, p->serial) != 0) {
+                libusb_close(p->handle);
+                p->handle = 0;
+                continue;
+            }
+            memcpy(p->serial, serial, PANDA_SERIAL_LENGTH);
+
             ret = libusb_set_configuration(p->handle, 1);
             if(ret < 0) {
                 terminalColor(31);
@@ -92,25 +238,60 @@ int panda_connect(Panda *p) {
         }
     }
 
+    libusb_free_device_list(devices, 1);
+
     if(p->handle == 0) {
         terminalColor(31);
-        printf("No Panda found.\n");
+        if(p->serial[0] != '\0')
+            printf("Panda %s not found.\n", p->serial);
+        else
+            printf("No Panda found.\n");
         terminalColor(0);
         return -1;
     }
     terminalColor(32);
-    printf("Panda connected\n");
+    printf("Panda %s connected\n", p->serial);
     terminalColor(0);
     fflush(stdout);
 
     return 0;
 }
 
+static void panda_health_free(Panda *p) {
+    if(p->health == NULL)
+        return;
+
+    if(atomic_load(&p->health_busy))
+        libusb_cancel_transfer(p->health);
+    panda_wait_transfers(p);
+
+    libusb_free_transfer(p->health);
+    free(p->health_buffer);
+    p->health = NULL;
+    p->health_buffer = NULL;
+}
+
 int panda_close(Panda *p) {
+    const struct libusb_pollfd **fds;
+
+    if(p->reactor != NULL) {
+        libusb_set_pollfd_notifiers(p->ctx, NULL, NULL, NULL);
+        fds = libusb_get_pollfds(p->ctx);
+        for(int i = 0; fds != NULL && fds[i] != NULL; i++)
+            reactor_remove(p->reactor, fds[i]->fd);
+        libusb_free_pollfds(fds);
+        p->reactor = NULL;
+    }
+
+    panda_rx_stop(p);
+    panda_health_free(p);
+    panda_tx_free(p);
     libusb_close(p->handle);
     p->handle = 0;
+    libusb_exit(p->ctx);
+    p->ctx = NULL;
     terminalColor(32);
-    printf("Closed Panda\n");
+    printf("Closed Panda %s\n", p->serial);
     terminalColor(0);
 
     return 0;
@@ -138,36 +319,214 @@ int panda_set_can_speed(Panda *p, int bus, int speed) {
     return libusb_control_transfer(p->handle, REQUEST_OUT, 0xde, bus, speed*10, data, 0, 0);
 }
 
+static void panda_usb_event(int fd, uint32_t events, void *ctx) {
+    Panda *p = ctx;
+    struct timeval tv = {0, 0};
+
+    /* Only handle what is ready, never wait for the device. */
+    libusb_handle_events_timeout_completed(p->ctx, &tv, NULL);
+}
+
+static void panda_pollfd_added(int fd, short events, void *user_data) {
+    Panda *p = user_data;
+
+    /* The poll() flags have the same values as the epoll() flags. */
+    reactor_add(p->reactor, fd, (uint32_t)events, panda_usb_event, p);
+}
+
+static void panda_pollfd_removed(int fd, void *user_data) {
+    Panda *p = user_data;
+
+    reactor_remove(p->reactor, fd);
+}
+
+int panda_add_to_reactor(Panda *p, Reactor *r) {
+    const struct libusb_pollfd **fds;
+    int ret = 0;
+
+    fds = libusb_get_pollfds(p->ctx);
+    if(fds == NULL)
+        return -1;
+
+    p->reactor = r;
+    for(int i = 0; fds[i] != NULL; i++) {
+        ret = reactor_add(r, fds[i]->fd, (uint32_t)fds[i]->events, panda_usb_event, p);
+        if(ret < 0)
+            break;
+    }
+    libusb_free_pollfds(fds);
+
+    libusb_set_pollfd_notifiers(p->ctx, panda_pollfd_added, panda_pollfd_removed, p);
+
+    return ret;
+}
+
 int panda_get_health(Panda *p, Health *h) {
     return libusb_control_transfer(p->handle, 0xc0, 0xd2, 0, 0, (unsigned char*)h, sizeof(Health), 0);
 }
 
-int panda_can_send_many(Panda *p, CANFrame frames[], int length) {
-    int nrBytes = 0x10  * length;
-    unsigned char *data = calloc(nrBytes, sizeof(unsigned char));
-    uint32_t *tempData = (uint32_t*)data;
-    int transferred;
+static void panda_health_done(struct libusb_transfer *transfer) {
+    Panda *p = transfer->user_data;
+    Health h;
+    int status = 0;
+
+    if(transfer->status == LIBUSB_TRANSFER_COMPLETED && transfer->actual_length >= (int)sizeof(Health))
+        memcpy(&h, libusb_control_transfer_get_data(transfer), sizeof(Health));
+    else
+        status = (transfer->status == LIBUSB_TRANSFER_TIMED_OUT) ? LIBUSB_ERROR_TIMEOUT : LIBUSB_ERROR_IO;
+
+    /* Cleared before the callback, so it can already submit the next read. */
+    atomic_store(&p->health_busy, 0);
+    if(transfer->status != LIBUSB_TRANSFER_CANCELLED && p->health_done != NULL)
+        p->health_done(&h, status, p->health_ctx);
+}
+
+int panda_get_health_async(Panda *p, PandaHealthCallback done, void *ctx) {
     int ret;
 
-    for(int i = 0; i < length; i++) {
-        tempData[0] = (frames[i].ID << 21) | 1;
-        tempData[1] = frames[i].length | (frames[i].bus << 4);
+    if(p->health == NULL) {
+        p->health = libusb_alloc_transfer(0);
+        p->health_buffer = malloc(LIBUSB_CONTROL_SETUP_SIZE + sizeof(Health));
+        if(p->health == NULL || p->health_buffer == NULL) {
+            libusb_free_transfer(p->health);
+            free(p->health_buffer);
+            p->health = NULL;
+            p->health_buffer = NULL;
+            return LIBUSB_ERROR_NO_MEM;
+        }
+    }
+    if(atomic_exchange(&p->health_busy, 1))
+        return LIBUSB_ERROR_BUSY;
+
+    p->health_done = done;
+    p->health_ctx = ctx;
+    libusb_fill_control_setup(p->health_buffer, REQUEST_IN, 0xd2, 0, 0, sizeof(Health));
+    libusb_fill_control_transfer(p->health, p->handle, p->health_buffer, panda_health_done, p, PANDA_HEALTH_TIMEOUT);
+
+    ret = libusb_submit_transfer(p->health);
+    if(ret < 0)
+        atomic_store(&p->health_busy, 0);
 
-        memcpy(&tempData[2], frames[i].data, frames[i].length);
+    return ret;
+}
 
-        tempData += 4;
+int panda_pack_frames(unsigned char *data, CANFrame frames[], int length) {
+    for(int i = 0; i < length; i++)
+        arena_pack(data + i * PANDA_FRAME_SIZE, &frames[i]);
+
+    return PANDA_FRAME_SIZE * length;
+}
+
+static void panda_tx_done(struct libusb_transfer *transfer) {
+    Panda *p = transfer->user_data;
+    PandaTxStats *st = &p->tx_stats;
+    PandaTxSlot *slot = NULL;
+    int64_t latency;
+
+    for(int i = 0; i < PANDA_TX_SLOTS; i++) {
+        if(p->tx[i].transfer == transfer) {
+            slot = &p->tx[i];
+            break;
+        }
     }
+    if(slot == NULL)
+        return;
+
+    latency = elapsed_ns(&slot->submitted);
+    slot->busy = 0;
+
+    latency_record(LATENCY_COMPLETE, latency);
+    if(slot->origin_ns != 0 && transfer->status == LIBUSB_TRANSFER_COMPLETED)
+        latency_record(LATENCY_TOTAL, latency_now() - slot->origin_ns);
+
+    st->in_flight--;
+    st->last_status = transfer->status;
+    if(transfer->status == LIBUSB_TRANSFER_COMPLETED)
+        st->completed++;
+    else
+        st->failed++;
+
+    st->last_latency_ns = latency;
+    st->sum_latency_ns += latency;
+    if(latency > st->max_latency_ns)
+        st->max_latency_ns = latency;
+}
 
-    ret = libusb_bulk_transfer(p->handle, 3 | LIBUSB_ENDPOINT_OUT, data, nrBytes, &transferred, 0);
-    free(data);
+/* Submit the slot with its packed frames. */
+static int panda_tx_submit(Panda *p, PandaTxSlot *slot, int nrBytes, uint64_t packed) {
+    int ret;
 
+    libusb_fill_bulk_transfer(slot->transfer, p->handle, 3 | LIBUSB_ENDPOINT_OUT, slot->buffer, nrBytes,
+                              panda_tx_done, p, PANDA_TX_TIMEOUT);
+
+    clock_gettime(CLOCK_MONOTONIC, &slot->submitted);
+    slot->origin_ns = latency_origin();
+    ret = libusb_submit_transfer(slot->transfer);
+    latency_record(LATENCY_SUBMIT, latency_now() - packed);
     if(ret < 0) {
+        p->tx_stats.failed++;
         return ret;
     }
 
+    slot->busy = 1;
+    p->tx_next = (p->tx_next + 1) % PANDA_TX_SLOTS;
+    p->tx_stats.submitted++;
+    p->tx_stats.in_flight++;
+    if(p->tx_stats.in_flight > p->tx_stats.max_in_flight)
+        p->tx_stats.max_in_flight = p->tx_stats.in_flight;
+
+    /* Nobody else handles the events, so wait for the completion here. */
+    if(p->reactor == NULL && !p->threaded) {
+        while(slot->busy)
+            libusb_handle_events(p->ctx);
+
+        if(p->tx_stats.last_status != LIBUSB_TRANSFER_COMPLETED)
+            return LIBUSB_ERROR_IO;
+    }
+
     return 0;
 }
 
+int panda_can_send_many(Panda *p, CANFrame frames[], int length) {
+    PandaTxSlot *slot = &p->tx[p->tx_next];
+    uint64_t start, packed;
+    int nrBytes;
+
+    if(length > PANDA_TX_MAX_FRAMES)
+        return LIBUSB_ERROR_OVERFLOW;
+
+    if(slot->busy) {
+        p->tx_stats.dropped++;
+        return LIBUSB_ERROR_BUSY;
+    }
+
+    start = latency_now();
+    nrBytes = panda_pack_frames(slot->buffer, frames, length);
+    packed = latency_now();
+    latency_record(LATENCY_PACK, packed - start);
+
+    return panda_tx_submit(p, slot, nrBytes, packed);
+}
+
+int panda_can_send_arena(Panda *p, FrameArena *a) {
+    PandaTxSlot *slot = &p->tx[p->tx_next];
+    unsigned char *buffer;
+    int nrBytes = a->length * PANDA_FRAME_SIZE;
+
+    arena_reset(a);
+    if(slot->busy) {
+        p->tx_stats.dropped++;
+        return LIBUSB_ERROR_BUSY;
+    }
+
+    /* The frames are already packed, the free buffer of the slot becomes the arena of the next tick. */
+    buffer = slot->buffer;
+    slot->buffer = a->frames;
+    a->frames = buffer;
+
+    return panda_tx_submit(p, slot, nrBytes, latency_now());
+}
+
 int panda_can_send(Panda *p, CANFrame frame) {
     return panda_can_send_many(p, &frame, 1);
 }
@@ -183,11 +542,154 @@ int panda_can_recv(Panda *p, unsigned char *data, int length) {
     return transferred;
 }
 
+static int panda_frame_valid(const uint32_t *words) {
+    /* Extended IDs do not fit in a CANFrame, CAN FD lengths are not supported. */
+    return !(words[0] & 0x04) && (words[1] & 0x0F) <= 8;
+}
+
+int panda_unpack_frame(const unsigned char *data, CANRxFrame *rx) {
+    const uint32_t *words = (const uint32_t*)data;
+
+    if(!panda_frame_valid(words))
+        return -1;
+
+    rx->frame.ID = words[0] >> 21;
+    rx->frame.length = words[1] & 0x0F;
+    rx->frame.bus = (words[1] >> 4) & 0xFF;
+    rx->frame.freq = 0;
+    rx->device_time = words[1] >> 16;
+    rx->flags = 0;
+    memcpy(rx->frame.data, &words[2], 8);
+
+    return 0;
+}
+
+static void panda_rx_done(struct libusb_transfer *transfer) {
+    Panda *p = transfer->user_data;
+    struct timespec now;
+    uint64_t timestamp;
+    CANRxFrame *rx;
+
+    if(transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        timestamp = now.tv_sec * 1000000000ULL + now.tv_nsec;
+
+        p->rx_stats.transfers++;
+        for(int off = 0; off + PANDA_FRAME_SIZE <= transfer->actual_length; off += PANDA_FRAME_SIZE) {
+            if(!panda_frame_valid((const uint32_t*)(transfer->buffer + off))) {
+                p->rx_stats.dropped++;
+                p->rx_ring->dropped++;
+                continue;
+            }
+
+            /* Decode straight into the ring. */
+            rx = canring_claim(p->rx_ring);
+            panda_unpack_frame(transfer->buffer + off, rx);
+            rx->timestamp_ns = timestamp;
+            if(p->rx_checksum != NULL && checksum_ids_has(p->rx_checksum, rx->frame.ID) &&
+               checksum_toyota_verify(&rx->frame, 1, sizeof(CANRingSlot), NULL) != 0) {
+                rx->flags |= CAN_RX_CHECKSUM_ERROR;
+                p->rx_stats.checksum_errors++;
+            }
+            if(p->rx_cache != NULL)
+                cancache_update(p->rx_cache, rx);
+            canring_publish(p->rx_ring);
+            p->rx_stats.frames++;
+        }
+    } else if(transfer->status != LIBUSB_TRANSFER_CANCELLED) {
+        p->rx_stats.errors++;
+    }
+
+    if(p->rx_active && transfer->status != LIBUSB_TRANSFER_CANCELLED && transfer->status != LIBUSB_TRANSFER_NO_DEVICE) {
+        if(libusb_submit_transfer(transfer) == 0)
+            return;
+        p->rx_stats.errors++;
+    }
+
+    p->rx_pending--;
+}
+
+int panda_rx_start(Panda *p, CANRing *ring, CANCache *cache) {
+    int ret;
+
+    if(p->rx_buffer == NULL) {
+        p->rx_buffer = aligned_alloc(64, PANDA_RX_TRANSFERS * PANDA_RX_SIZE);
+        if(p->rx_buffer == NULL)
+            return LIBUSB_ERROR_NO_MEM;
+    }
+
+    p->rx_ring = ring;
+    p->rx_cache = cache;
+    p->rx_active = 1;
+
+    for(int i = 0; i < PANDA_RX_TRANSFERS; i++) {
+        if(p->rx[i] == NULL)
+            p->rx[i] = libusb_alloc_transfer(0);
+        if(p->rx[i] == NULL)
+            return LIBUSB_ERROR_NO_MEM;
+
+        libusb_fill_bulk_transfer(p->rx[i], p->handle, 1 | LIBUSB_ENDPOINT_IN, p->rx_buffer + i * PANDA_RX_SIZE,
+                                  PANDA_RX_SIZE, panda_rx_done, p, 0);
+
+        ret = libusb_submit_transfer(p->rx[i]);
+        if(ret < 0) {
+            panda_rx_stop(p);
+            return ret;
+        }
+        p->rx_pending++;
+    }
+
+    return 0;
+}
+
+void panda_rx_verify(Panda *p, const ChecksumIdSet *ids) {
+    p->rx_checksum = ids;
+}
+
+void panda_rx_stop(Panda *p) {
+    p->rx_active = 0;
+
+    for(int i = 0; i < PANDA_RX_TRANSFERS; i++) {
+        if(p->rx[i] != NULL)
+            libusb_cancel_transfer(p->rx[i]);
+    }
+
+    panda_wait_transfers(p);
+
+    for(int i = 0; i < PANDA_RX_TRANSFERS; i++) {
+        if(p->rx[i] != NULL)
+            libusb_free_transfer(p->rx[i]);
+        p->rx[i] = NULL;
+    }
+    free(p->rx_buffer);
+    p->rx_buffer = NULL;
+}
+
 int panda_can_clear(Panda *p, int bus) {
     unsigned char data[1];
     return libusb_control_transfer(p->handle, REQUEST_OUT, 0xf1, bus, 0, data, 0, 0);
 }
 
+void panda_print_tx_stats(Panda *p) {
+    PandaTxStats *st = &p->tx_stats;
+
+    printf("TX sent: %llu  OK: %llu  Failed: %llu  Dropped: %llu  Queue: %u/%u  Latency avg/max: %lld/%lld us\n",
+           (unsigned long long)st->submitted, (unsigned long long)st->completed,
+           (unsigned long long)st->failed, (unsigned long long)st->dropped,
+           st->in_flight, st->max_in_flight,
+           (long long)((st->completed + st->failed) ? (st->sum_latency_ns / (int64_t)(st->completed + st->failed)) / 1000 : 0),
+           (long long)(st->max_latency_ns / 1000));
+}
+
+void panda_print_rx_stats(Panda *p) {
+    PandaRxStats *st = &p->rx_stats;
+
+    printf("RX transfers: %llu  Frames: %llu  Dropped: %llu  Errors: %llu  Checksum errors: %llu\n",
+           (unsigned long long)st->transfers, (unsigned long long)st->frames,
+           (unsigned long long)st->dropped, (unsigned long long)st->errors,
+           (unsigned long long)st->checksum_errors);
+}
+
 void print_many(CANFrame frames[], int length) {
     for(int k = 0; k < length; k++) {
         printf("Bus: %d  ID: %4d  Length: %d  Data: ", frames[k].bus, frames[k].ID, frames[k].length);
@@ -9,31 +9,62 @@
 
 #ifndef PANDA
 #define PANDA
+	#include <time.h>
+	#include <stdatomic.h>
 	#include <libusb-1.0/libusb.h>
+	#include "reactor.h"
+	#include "canFrame.h"
+	#include "frameArena.h"
+	#include "canRing.h"
+	#include "canCache.h"
+	#include "checksum.h"
+	#include "latency.h"
 
-        /**
-	 * \brief Defines the interface for a specific connected Panda.
-	 * 
-	 * This struct contains the USB handle and file descriptor, so it can be passed to all functions.
+	#define PANDA_FRAME_SIZE	0x10	//!< The size of one CAN frame in the USB format of the Panda.
+	#define PANDA_TX_MAX_FRAMES	256	//!< The maximum number of frames in one send.
+	#define PANDA_TX_SLOTS		4	//!< The number of CAN sends that can be in flight at the same time.
+	#define PANDA_RX_TRANSFERS	4	//!< The number of CAN receive transfers that are kept queued.
+	#define PANDA_RX_SIZE		(PANDA_FRAME_SIZE * 256)	//!< The size of one CAN receive transfer.
+	#define PANDA_SERIAL_LENGTH	32	//!< The maximum length of a serial number, including the '\0'.
+	#define PANDA_BUSSES		3	//!< The number of CAN busses of one Panda.
+
+	/**
+	 * \brief Defines one preallocated CAN send transfer.
 	 */
 	typedef struct {
-	    libusb_device_handle *handle;		//!< The LibUSB handle
-	    struct libusb_device_descriptor desc;	//!< The LibUSB file descriptor
-	} Panda;
+	    struct libusb_transfer *transfer;	//!< The LibUSB transfer, reused for every send.
+	    unsigned char *buffer;		//!< The packed frames, PANDA_TX_MAX_FRAMES * PANDA_FRAME_SIZE bytes.
+	    struct timespec submitted;		//!< When the transfer was submitted.
+	    uint64_t origin_ns;			//!< The start of the end-to-end latency of the frames, 0 if none.
+	    uint8_t busy;			//!< Is the transfer still in flight?
+	} PandaTxSlot;
 
 	/**
-	 * \brief Defines a standard CAN frame
-	 * 
-	 * This struct defines a standard CAN frame, so that the software can be used with different CAN devices with different drivers.
-	 * 
+	 * \brief Contains the statistics of the CAN send path.
 	 */
 	typedef struct {
-	    uint16_t ID;	//!< The CAN frame ID.
-	    uint8_t data[8];	//!< The Data sent with the frame, max. 8 Bytes.
-	    uint8_t bus;	//!< Which bus to send the data on. For using multiple CAN busses.
-	    uint8_t length;	//!< The number of bytes te be sent.
-	    uint8_t freq;	//!< How frequent to send the frame. 
-	} CANFrame;
+	    uint64_t submitted;		//!< The number of submitted sends.
+	    uint64_t completed;		//!< The number of sends that completed successfully.
+	    uint64_t failed;		//!< The number of sends that failed, timed out or were cancelled.
+	    uint64_t dropped;		//!< The number of sends dropped because all slots were in flight.
+	    int last_status;		//!< The libusb_transfer_status of the last completed send.
+	    uint32_t in_flight;		//!< The number of sends currently in flight (queue depth).
+	    uint32_t max_in_flight;	//!< The highest queue depth seen.
+	    int64_t last_latency_ns;	//!< The submit to completion time of the last send.
+	    int64_t max_latency_ns;	//!< The highest submit to completion time seen.
+	    int64_t sum_latency_ns;	//!< The sum of all submit to completion times, to calculate the mean.
+	} PandaTxStats;
+
+	/**
+	 * \brief Contains the statistics of the CAN receive path.
+	 */
+	typedef struct {
+	    uint64_t transfers;		//!< The number of completed receive transfers.
+	    uint64_t frames;		//!< The number of frames put in the ring.
+	    uint64_t dropped;		//!< The number of records that could not be decoded (extended ID, bad length).
+	    uint64_t errors;		//!< The number of receive transfers that failed.
+	    uint64_t checksum_errors;	//!< The number of verified frames with a wrong checksum.
+	} PandaRxStats;
 
         /**
          * \brief Contains a few health parameters of the car and the Panda.
@@ -51,6 +82,44 @@
             uint8_t started_alt;                //!< (Deprecated) Not used anymore
         } Health;
 
+	/**
+	 * \brief Called when an asynchronous health read completes.
+	 * \param h The health, only valid if status is 0.
+	 * \param status 0: Success, <0: The read failed or timed out.
+	 * \param ctx The context given to panda_get_health_async().
+	 */
+	typedef void (*PandaHealthCallback)(const Health *h, int status, void *ctx);
+
+        /**
+	 * \brief Defines the interface for a specific connected Panda.
+	 * 
+	 * This struct contains the USB handle and file descriptor, so it can be passed to all functions.
+	 */
+	typedef struct {
+	    libusb_context *ctx;			//!< The LibUSB context of this Panda only, so every Panda can have its own thread.
+	    libusb_device_handle *handle;		//!< The LibUSB handle
+	    struct libusb_device_descriptor desc;	//!< The LibUSB file descriptor
+	    char serial[PANDA_SERIAL_LENGTH];		//!< The serial number, set before connecting to only connect to that Panda.
+	    Reactor *reactor;				//!< The event loop handling the USB events, NULL if none.
+	    uint8_t threaded;				//!< Are the USB events handled by a worker thread?
+	    PandaTxSlot tx[PANDA_TX_SLOTS];		//!< The ring of CAN send transfers.
+	    uint8_t tx_next;				//!< The next slot of the ring to use.
+	    PandaTxStats tx_stats;			//!< The statistics of the CAN send path.
+	    struct libusb_transfer *rx[PANDA_RX_TRANSFERS];	//!< The queued CAN receive transfers.
+	    unsigned char *rx_buffer;			//!< The buffers of the receive transfers.
+	    CANRing *rx_ring;				//!< The ring the received frames are written to.
+	    CANCache *rx_cache;				//!< The cache of the newest frame per ID, NULL if not used.
+	    const ChecksumIdSet *rx_checksum;		//!< The IDs of which the checksum is verified, NULL if not used.
+	    uint8_t rx_active;				//!< Are the receive transfers resubmitted?
+	    uint8_t rx_pending;				//!< The number of receive transfers in flight.
+	    PandaRxStats rx_stats;			//!< The statistics of the CAN receive path.
+	    struct libusb_transfer *health;		//!< The asynchronous health read, NULL until the first one.
+	    unsigned char *health_buffer;		//!< The setup packet and Health of the asynchronous read.
+	    PandaHealthCallback health_done;		//!< Called when the asynchronous read completes.
+	    void *health_ctx;				//!< The context of health_done.
+	    _Atomic uint8_t health_busy;		//!< Is the asynchronous read in flight?
+	} Panda;
+
 
 	/**
 	 * \brief Constant to define what type of request you want to make.
@@ -74,8 +143,23 @@
          * \return 0: Success
          * \return <0: Fail
 	 * 
+	 * \fn int panda_setup_serial(Panda *p, int mode, const char *serial)
+	 * \brief Setup and connect to the Panda with a serial number
+	 * \param p Pointer to Panda struct.
+         * \param mode Safety Mode
+	 * \param serial The serial number of the Panda, NULL for the first Panda found.
+         * \return 0: Success
+         * \return <0: Fail
+	 *
+	 * \fn int panda_list(char serials[][PANDA_SERIAL_LENGTH], int max)
+	 * \brief Find the serial numbers of all connected Pandas.
+	 * \param serials The array to write the serial numbers to.
+	 * \param max The length of the array.
+         * \return The number of Pandas found.
+         * \return <0: Fail
+	 *
 	 * \fn int panda_connect(Panda *p)
-	 * \brief Connect to the Panda (Called from setup)
+	 * \brief Connect to the Panda with the serial number of the struct, or the first one if it is empty (Called from setup)
 	 * \param p Pointer to Panda struct.
          * \return 0: Success
          * \return <0: Fail
@@ -107,6 +191,13 @@
          * \return 0: Success
          * \return <0: Fail
 	 * 
+	 * \fn int panda_add_to_reactor(Panda *p, Reactor *r)
+	 * \brief Let an event loop handle the USB events of the Panda, instead of blocking on them.
+	 * \param p Pointer to Panda struct.
+	 * \param r The event loop to add the USB file descriptors to.
+         * \return 0: Success
+         * \return <0: Fail
+	 *
          * \fn int panda_get_health(Panda *p, Health *h)
          * \brief Get the car health from the Panda
          * \param p Pointer to Panda struct
@@ -114,13 +205,36 @@
          * \return 0: Success
          * \return <0: Fail
          *
+	 * \fn int panda_get_health_async(Panda *p, PandaHealthCallback done, void *ctx)
+	 * \brief Read the car health without waiting, done is called from the thread handling the USB events.
+	 * \param p Pointer to Panda struct.
+	 * \param done Called with the health when the read completes, not when it is cancelled by panda_close().
+	 * \param ctx Passed to done.
+	 * \return 0: Success
+	 * \return LIBUSB_ERROR_BUSY: The previous read is still in flight
+	 * \return <0: Fail
+	 *
 	 * \fn int panda_can_send_many(Panda *p, CANFrame frames[], int length)
 	 * \brief Send many CAN frames to the Panda
+	 *
+	 * The frames are packed in the next free preallocated transfer and submitted without waiting,
+	 * the completion is handled by the event loop of panda_add_to_reactor() or by the worker thread of the Panda.
+	 * Without either, the call waits for the completion.
 	 * \param p Pointer to Panda struct.
 	 * \param frames The CAN frames to send to the Panda.
-	 * \param length The number of CAN frames to send.
+	 * \param length The number of CAN frames to send, max. PANDA_TX_MAX_FRAMES.
          * \return 0: Success
-         * \return <0: Fail
+         * \return <0: Fail (LIBUSB_ERROR_BUSY when all transfers are still in flight)
+	 * 
+	 * \fn int panda_can_send_arena(Panda *p, FrameArena *a)
+	 * \brief Send the frames of an arena to the Panda, without copying them.
+	 *
+	 * The buffer of the arena is given to the next free transfer and the arena gets the buffer of that transfer,
+	 * so the arena is empty afterwards. Completes like panda_can_send_many().
+	 * \param p Pointer to Panda struct.
+	 * \param a The arena with the frames, built with arena_init().
+         * \return 0: Success
+         * \return <0: Fail (LIBUSB_ERROR_BUSY when all transfers are still in flight)
 	 * 
 	 * \fn int panda_can_send(Panda *p, CANFrame frame)
 	 * \brief Send one CAN frame to the Panda
@@ -137,6 +251,34 @@
          * \return 0: Success
          * \return <0: Fail
 	 * 
+	 * \fn int panda_rx_start(Panda *p, CANRing *ring, CANCache *cache)
+	 * \brief Start receiving CAN frames in the background.
+	 *
+	 * PANDA_RX_TRANSFERS receive transfers are kept queued at all times, every completed transfer is decoded
+	 * into the ring and submitted again. The USB events must be handled by an event loop, see panda_add_to_reactor().
+	 * \param p Pointer to Panda struct.
+	 * \param ring The ring to write the received frames to.
+	 * \param cache The cache to update with every received frame, NULL if not used.
+         * \return 0: Success
+         * \return <0: Fail
+	 *
+	 * \fn void panda_rx_verify(Panda *p, const ChecksumIdSet *ids)
+	 * \brief Verify the Toyota checksum of the received frames with these IDs.
+	 * Frames with a wrong checksum are still put in the ring, with CAN_RX_CHECKSUM_ERROR set.
+	 * \param p Pointer to Panda struct.
+	 * \param ids The IDs to verify, NULL to stop verifying.
+	 *
+	 * \fn void panda_rx_stop(Panda *p)
+	 * \brief Stop receiving CAN frames in the background, and wait for the queued transfers.
+	 * \param p Pointer to Panda struct.
+	 *
+	 * \fn int panda_unpack_frame(const unsigned char *data, CANRxFrame *rx)
+	 * \brief Convert one received frame in the USB format of the Panda.
+	 * \param data The PANDA_FRAME_SIZE bytes of the frame.
+	 * \param rx The decoded frame, the host timestamp is not set.
+         * \return 0: Success
+         * \return <0: Unsupported frame (extended ID or length over 8)
+	 *
 	 * \fn int panda_can_clear(Panda *p, int bus)
 	 * \brief Clear an internal buffer of the Panda
 	 * \param p Pointer to Panda struct.
@@ -144,6 +286,21 @@
          * \return 0: Success
          * \return <0: Fail
 	 * 
+	 * \fn int panda_pack_frames(unsigned char *data, CANFrame frames[], int length)
+	 * \brief Convert CAN frames to the USB format of the Panda.
+	 * \param data The buffer to write to, length * PANDA_FRAME_SIZE bytes.
+	 * \param frames The CAN frames to convert.
+	 * \param length The number of CAN frames to convert.
+         * \return The number of bytes written.
+	 *
+	 * \fn void panda_print_tx_stats(Panda *p)
+	 * \brief Print the statistics of the CAN send path.
+	 * \param p Pointer to Panda struct.
+	 *
+	 * \fn void panda_print_rx_stats(Panda *p)
+	 * \brief Print the statistics of the CAN receive path.
+	 * \param p Pointer to Panda struct.
+	 *
 	 * \fn void print_many(CANFrame frames[], int length)
 	 * \brief Debug the frames that would be sent.
 	 * \param frames The frames to print.
@@ -152,18 +309,30 @@
          * \return <0: Problem
 	 */
         int panda_setup(Panda *p, int mode);
+	int panda_setup_serial(Panda *p, int mode, const char *serial);
+	int panda_list(char serials[][PANDA_SERIAL_LENGTH], int max);
 	int panda_connect(Panda *p);
 	int panda_close(Panda *p);
 
 	int panda_get_version(Panda *p);
 	int panda_set_safety_mode(Panda *p, uint16_t mode);
 	int panda_set_can_speed(Panda *p, int bus, int speed);
+	int panda_add_to_reactor(Panda *p, Reactor *r);
         int panda_get_health(Panda *p, Health *h);
+	int panda_get_health_async(Panda *p, PandaHealthCallback done, void *ctx);
 
 	int panda_can_send_many(Panda *p, CANFrame frames[], int length);
+	int panda_can_send_arena(Panda *p, FrameArena *a);
 	int panda_can_send(Panda *p, CANFrame frame);
 	int panda_can_recv(Panda *p, unsigned char *data, int length);
+	int panda_rx_start(Panda *p, CANRing *ring, CANCache *cache);
+	void panda_rx_verify(Panda *p, const ChecksumIdSet *ids);
+	void panda_rx_stop(Panda *p);
+	int panda_unpack_frame(const unsigned char *data, CANRxFrame *rx);
 	int panda_can_clear(Panda *p, int bus);
+	int panda_pack_frames(unsigned char *data, CANFrame frames[], int length);
+	void panda_print_tx_stats(Panda *p);
+	void panda_print_rx_stats(Panda *p);
 
 	void print_many(CANFrame frames[], int length);
 #endif	
@@ -0,0 +1,333 @@
+#define _GNU_SOURCE     // pthread_setaffinity_np()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#include <sys/eventfd.h>
+
+#include "pandaPool.h"
+#include "latency.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+#define PANDA_POOL_POLL_US 100000   //!< The longest an I/O thread waits for USB events before checking its queue again.
+
+_Static_assert(CAN_CACHE_BUSSES >= PANDA_POOL_MAX_BUSSES, "Every logical bus of a pool must be cached");
+
+static void *pandapool_worker(void *arg) {
+    PandaDevice *d = arg;
+    Panda *p = &d->panda;
+    struct timeval tv = {0, PANDA_POOL_POLL_US};
+    uint64_t frames = p->rx_stats.frames;
+    uint64_t one = 1;
+    PandaBatch *b;
+
+    while(atomic_load_explicit(&d->running, memory_order_acquire)) {
+        /* Only take a send from the queue when a transfer is free, the others wait in the queue. */
+        while(!p->tx[p->tx_next].busy && (b = spsc_front(&d->tx)) != NULL) {
+            latency_set_origin(b->origin_ns);
+            panda_can_send_many(p, b->frames, b->length);
+            spsc_pop(&d->tx);
+        }
+
+        libusb_handle_events_timeout_completed(p->ctx, &tv, NULL);
+
+        if(p->rx_stats.frames != frames) {
+            frames = p->rx_stats.frames;
+            if(write(d->event_fd, &one, sizeof(one)) < 0)
+                p->rx_stats.errors++;
+        }
+    }
+
+    return NULL;
+}
+
+static int pandapool_start_worker(PandaDevice *d) {
+    cpu_set_t set;
+    int ret;
+
+    atomic_store_explicit(&d->running, 1, memory_order_release);
+    ret = pthread_create(&d->thread, NULL, pandapool_worker, d);
+    if(ret != 0)
+        return -1;
+    d->started = 1;
+
+    if(d->cpu >= 0) {
+        CPU_ZERO(&set);
+        CPU_SET(d->cpu, &set);
+        if(pthread_setaffinity_np(d->thread, sizeof(set), &set) != 0) {
+            terminalColor(31);
+            printf("Could not pin the I/O thread of Panda %s to CPU %d\n", d->panda.serial, d->cpu);
+            terminalColor(0);
+        }
+    }
+
+    return 0;
+}
+
+static void pandapool_stop_worker(PandaDevice *d) {
+    if(!d->started)
+        return;
+
+    atomic_store_explicit(&d->running, 0, memory_order_release);
+    libusb_interrupt_event_handler(d->panda.ctx);
+    pthread_join(d->thread, NULL);
+    d->started = 0;
+}
+
+static PandaDevice *pandapool_add(PandaPool *pp, const char *serial, int cpu, int mode) {
+    PandaDevice *d = aligned_alloc(64, (sizeof(PandaDevice) + 63) & ~(size_t)63);
+    int ret;
+
+    if(d == NULL)
+        return NULL;
+    memset(d, 0, sizeof(PandaDevice));
+    d->cpu = cpu;
+    d->event_fd = pp->event_fd;
+    pp->devices[pp->nrDevices++] = d;
+
+    ret = panda_setup_serial(&d->panda, mode, serial);
+    if(ret < 0)
+        return NULL;
+    /* From now on only the I/O thread handles the USB events of this Panda. */
+    d->panda.threaded = 1;
+
+    if(spsc_setup(&d->tx, PANDA_POOL_QUEUE, sizeof(PandaBatch)) < 0)
+        return NULL;
+    if(canring_setup(&d->rx_ring, PANDA_POOL_RX_RING) < 0)
+        return NULL;
+    canring_reader_setup(&d->rx_reader, &d->rx_ring);
+
+    return d;
+}
+
+int pandapool_open(PandaPool *pp, const char *serials[], const int cpus[], int length, int mode) {
+    char found[PANDA_POOL_MAX_DEVICES][PANDA_SERIAL_LENGTH];
+    long nrCpus = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *serial;
+    int cpu;
+
+    memset(pp, 0, sizeof(PandaPool));
+    pp->event_fd = -1;
+    for(int i = 0; i < PANDA_POOL_MAX_BUSSES; i++)
+        pp->routes[i].device = PANDA_POOL_NO_ROUTE;
+
+    if(length == 0) {
+        length = panda_list(found, PANDA_POOL_MAX_DEVICES);
+        if(length <= 0) {
+            terminalColor(31);
+            printf("No Panda found.\n");
+            terminalColor(0);
+            return -1;
+        }
+    }
+    if(length > PANDA_POOL_MAX_DEVICES)
+        return -1;
+
+    pp->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(pp->event_fd < 0)
+        return -1;
+
+    for(int i = 0; i < length; i++) {
+        serial = (serials != NULL) ? serials[i] : found[i];
+        /* Keep core 0 for the control thread, also when there are more Pandas than other cores. */
+        cpu = (cpus != NULL) ? cpus[i] : (nrCpus > 1 ? (int)(1 + i % (nrCpus - 1)) : -1);
+
+        if(pandapool_add(pp, serial, cpu, mode) == NULL) {
+            pandapool_close(pp);
+            return -1;
+        }
+        for(int bus = 0; bus < PANDA_BUSSES; bus++)
+            pandapool_route(pp, i * PANDA_BUSSES + bus, i, bus);
+    }
+
+    for(int i = 0; i < pp->nrDevices; i++) {
+        if(pandapool_start_worker(pp->devices[i]) < 0) {
+            pandapool_close(pp);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+void pandapool_close(PandaPool *pp) {
+    PandaDevice *d;
+
+    for(int i = 0; i < pp->nrDevices; i++) {
+        d = pp->devices[i];
+        if(d == NULL)
+            continue;
+
+        pandapool_stop_worker(d);
+        d->panda.threaded = 0;
+        if(d->panda.handle != 0)
+            panda_close(&d->panda);
+        else if(d->panda.ctx != NULL)
+            libusb_exit(d->panda.ctx);
+        spsc_free(&d->tx);
+        canring_free(&d->rx_ring);
+        free(d);
+        pp->devices[i] = NULL;
+    }
+    pp->nrDevices = 0;
+
+    if(pp->event_fd >= 0)
+        close(pp->event_fd);
+    pp->event_fd = -1;
+}
+
+int pandapool_route(PandaPool *pp, uint8_t bus, uint8_t device, uint8_t deviceBus) {
+    PandaRoute *old;
+
+    if(bus >= PANDA_POOL_MAX_BUSSES)
+        return -1;
+    if(device != PANDA_POOL_NO_ROUTE && (device >= pp->nrDevices || deviceBus >= PANDA_BUSSES))
+        return -1;
+
+    old = &pp->routes[bus];
+    if(old->device != PANDA_POOL_NO_ROUTE && pp->devices[old->device]->logical[old->bus] == bus)
+        pp->devices[old->device]->logical[old->bus] = PANDA_POOL_NO_ROUTE;
+
+    old->device = device;
+    old->bus = deviceBus;
+    if(device == PANDA_POOL_NO_ROUTE)
+        return 0;
+
+    /* A bus of a Panda belongs to one logical bus, the one routed to it before loses its route. */
+    for(int i = 0; i < PANDA_POOL_MAX_BUSSES; i++) {
+        if(i != bus && pp->routes[i].device == device && pp->routes[i].bus == deviceBus)
+            pp->routes[i].device = PANDA_POOL_NO_ROUTE;
+    }
+    pp->devices[device]->logical[deviceBus] = bus;
+
+    return 0;
+}
+
+int pandapool_send(PandaPool *pp, CANFrame frames[], int length) {
+    PandaBatch *batches[PANDA_POOL_MAX_DEVICES] = {NULL};
+    uint8_t full[PANDA_POOL_MAX_DEVICES] = {0};
+    const PandaRoute *route;
+    PandaBatch *b;
+    int ret = 0;
+
+    if(length > PANDA_TX_MAX_FRAMES)
+        return LIBUSB_ERROR_OVERFLOW;
+
+    for(int i = 0; i < length; i++) {
+        route = (frames[i].bus < PANDA_POOL_MAX_BUSSES) ? &pp->routes[frames[i].bus] : NULL;
+        if(route == NULL || route->device == PANDA_POOL_NO_ROUTE) {
+            pp->stats.unrouted++;
+            ret = -1;
+            continue;
+        }
+        if(full[route->device])
+            continue;
+
+        b = batches[route->device];
+        if(b == NULL) {
+            b = spsc_claim(&pp->devices[route->device]->tx);
+            if(b == NULL) {
+                full[route->device] = 1;
+                pp->stats.queue_full++;
+                ret = -1;
+                continue;
+            }
+            b->length = 0;
+            batches[route->device] = b;
+        }
+
+        b->frames[b->length] = frames[i];
+        b->frames[b->length].bus = route->bus;
+        b->length++;
+    }
+
+    for(int d = 0; d < pp->nrDevices; d++) {
+        if(batches[d] == NULL)
+            continue;
+
+        batches[d]->origin_ns = latency_origin();
+        spsc_push(&pp->devices[d]->tx);
+        libusb_interrupt_event_handler(pp->devices[d]->panda.ctx);
+    }
+
+    return ret;
+}
+
+int pandapool_rx_start(PandaPool *pp) {
+    PandaDevice *d;
+    int ret = 0;
+
+    /* The receive transfers are set up while the I/O thread is stopped, so it never sees them half done. */
+    for(int i = 0; i < pp->nrDevices && ret >= 0; i++) {
+        d = pp->devices[i];
+        pandapool_stop_worker(d);
+        ret = panda_rx_start(&d->panda, &d->rx_ring, NULL);
+        if(pandapool_start_worker(d) < 0)
+            ret = -1;
+    }
+
+    return ret;
+}
+
+int pandapool_receive(PandaPool *pp, CANRxFrame *rx) {
+    const CANRxFrame *next;
+    PandaDevice *d;
+    uint8_t bus;
+
+    for(int n = 0; n < pp->nrDevices; n++) {
+        d = pp->devices[pp->next];
+
+        while((next = canring_peek(&d->rx_reader)) != NULL) {
+            *rx = *next;
+            if(canring_release(&d->rx_reader) != 0)
+                continue;
+
+            bus = rx->frame.bus & ~CAN_BUS_RETURNED;
+            if(bus >= PANDA_BUSSES || d->logical[bus] == PANDA_POOL_NO_ROUTE)
+                continue;
+
+            rx->frame.bus = d->logical[bus] | (rx->frame.bus & CAN_BUS_RETURNED);
+            pp->stats.rx_frames++;
+            return 1;
+        }
+
+        pp->stats.rx_overruns += d->rx_reader.overruns;
+        d->rx_reader.overruns = 0;
+        pp->next = (pp->next + 1) % pp->nrDevices;
+    }
+
+    return 0;
+}
+
+int pandapool_get_health(PandaPool *pp, uint8_t device, Health *h) {
+    if(device >= pp->nrDevices)
+        return -1;
+
+    return panda_get_health(&pp->devices[device]->panda, h);
+}
+
+int pandapool_get_health_async(PandaPool *pp, uint8_t device, PandaHealthCallback done, void *ctx) {
+    if(device >= pp->nrDevices)
+        return -1;
+
+    return panda_get_health_async(&pp->devices[device]->panda, done, ctx);
+}
+
+void pandapool_print_stats(PandaPool *pp) {
+    for(int i = 0; i < pp->nrDevices; i++) {
+        printf("Panda %s (CPU %d)\n", pp->devices[i]->panda.serial, pp->devices[i]->cpu);
+        panda_print_tx_stats(&pp->devices[i]->panda);
+        panda_print_rx_stats(&pp->devices[i]->panda);
+    }
+
+    printf("Pool unrouted: %llu  Queue full: %llu  RX frames: %llu  RX overruns: %llu\n",
+           (unsigned long long)pp->stats.unrouted, (unsigned long long)pp->stats.queue_full,
+           (unsigned long long)pp->stats.rx_frames, (unsigned long long)pp->stats.rx_overruns);
+}
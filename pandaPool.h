@@ -0,0 +1,164 @@
+/**
+ * \file pandaPool.h
+ * \date 16 October 2026
+ * \brief File containing the pool of Pandas, for more busses and more bandwidth than one Panda has.
+ *
+ * This file contains the function declarations for driving several Pandas at the same time, as well as the definition of the
+ * PandaPool struct. Every Panda has its own LibUSB context and its own I/O thread, pinned to a core:
+ * \code
+ * control thread --SpscQueue--> I/O thread 0 --USB--> Panda 0
+ *                --SpscQueue--> I/O thread 1 --USB--> Panda 1
+ * control thread <--CANRing---- I/O threads (eventfd to wake the event loop)
+ * \endcode
+ * The frames are routed by a table from logical bus to (Panda, bus of that Panda). By default Panda n has the logical busses
+ * n * PANDA_BUSSES up to n * PANDA_BUSSES + PANDA_BUSSES - 1, so with one Panda nothing changes.
+ */
+
+#ifndef PANDA_POOL
+#define PANDA_POOL
+    #include <stdint.h>
+    #include <stdatomic.h>
+    #include <pthread.h>
+    #include "canFrame.h"
+    #include "canRing.h"
+    #include "panda.h"
+    #include "spscQueue.h"
+
+    #define PANDA_POOL_MAX_DEVICES  4       //!< The maximum number of Pandas in a pool.
+    #define PANDA_POOL_MAX_BUSSES   (PANDA_POOL_MAX_DEVICES * PANDA_BUSSES)     //!< The number of logical busses.
+    #define PANDA_POOL_QUEUE        8       //!< The number of sends that can wait for the I/O thread of a Panda.
+    #define PANDA_POOL_RX_RING      4096    //!< The number of received frames an I/O thread can be ahead of the control thread.
+    #define PANDA_POOL_NO_ROUTE     0xFF    //!< The device of a logical bus without a Panda.
+
+    /**
+     * \brief Defines one send, passed from the control thread to an I/O thread.
+     */
+    typedef struct {
+        uint64_t origin_ns;                     //!< The start of the end-to-end latency of the frames, 0 if none.
+        uint16_t length;                        //!< The number of frames.
+        CANFrame frames[PANDA_TX_MAX_FRAMES];   //!< The frames, with the bus of the Panda.
+    } PandaBatch;
+
+    /**
+     * \brief Defines where the frames of a logical bus go.
+     */
+    typedef struct {
+        uint8_t device;     //!< The index of the Panda in the pool, PANDA_POOL_NO_ROUTE if none.
+        uint8_t bus;        //!< The bus of that Panda.
+    } PandaRoute;
+
+    /**
+     * \brief Defines one Panda of the pool with its I/O thread.
+     */
+    typedef struct {
+        Panda panda;                        //!< The Panda, only used by the I/O thread after pandapool_open().
+        pthread_t thread;                   //!< The I/O thread.
+        int cpu;                            //!< The core the I/O thread is pinned to, -1 if not pinned.
+        uint8_t started;                    //!< Is the I/O thread running?
+        _Atomic uint8_t running;            //!< Cleared to stop the I/O thread.
+        int event_fd;                       //!< The eventfd of the pool, written by the I/O thread when frames were received.
+        SpscQueue tx;                       //!< The sends from the control thread (PandaBatch).
+        CANRing rx_ring;                    //!< The frames received by the I/O thread.
+        CANRingReader rx_reader;            //!< The reader of the control thread.
+        uint8_t logical[PANDA_BUSSES];      //!< The logical bus of every bus of the Panda, PANDA_POOL_NO_ROUTE if none.
+    } PandaDevice;
+
+    /**
+     * \brief Contains the statistics of the pool itself, the statistics of every Panda are in its Panda struct.
+     */
+    typedef struct {
+        uint64_t unrouted;      //!< The number of frames for a logical bus without a Panda.
+        uint64_t queue_full;    //!< The number of sends dropped because the I/O thread was too far behind.
+        uint64_t rx_frames;     //!< The number of frames read by the control thread.
+        uint64_t rx_overruns;   //!< The number of frames lost because the control thread was too far behind.
+    } PandaPoolStats;
+
+    /**
+     * \brief Defines the pool.
+     */
+    typedef struct {
+        PandaDevice *devices[PANDA_POOL_MAX_DEVICES];   //!< The Pandas, each on its own cache lines.
+        uint8_t nrDevices;                              //!< The number of Pandas.
+        PandaRoute routes[PANDA_POOL_MAX_BUSSES];       //!< The routing table, by logical bus.
+        int event_fd;                                   //!< Readable when one of the I/O threads received frames.
+        uint8_t next;                                   //!< The device pandapool_receive() continues with.
+        PandaPoolStats stats;                           //!< The statistics of the pool.
+    } PandaPool;
+
+    /**
+     * \fn int pandapool_open(PandaPool *pp, const char *serials[], const int cpus[], int length, int mode)
+     * \brief Connect to the Pandas, set up the default routes and start an I/O thread per Panda.
+     * \param pp Pointer to PandaPool struct.
+     * \param serials The serial numbers of the Pandas, in the order of their logical busses.
+     * \param cpus The core to pin the I/O thread of every Panda to, -1 to not pin. NULL to pin to core 1, 2, ..., never core 0.
+     * \param length The number of Pandas, 0 for all connected Pandas.
+     * \param mode The safety mode of the Pandas.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void pandapool_close(PandaPool *pp)
+     * \brief Stop the I/O threads and close the Pandas.
+     * \param pp Pointer to PandaPool struct.
+     *
+     * \fn int pandapool_route(PandaPool *pp, uint8_t bus, uint8_t device, uint8_t deviceBus)
+     * \brief Change where the frames of a logical bus go, and where the frames received on that bus come from.
+     * \param pp Pointer to PandaPool struct.
+     * \param bus The logical bus.
+     * \param device The index of the Panda in the pool, PANDA_POOL_NO_ROUTE to drop the frames of the bus.
+     * \param deviceBus The bus of that Panda.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int pandapool_send(PandaPool *pp, CANFrame frames[], int length)
+     * \brief Route frames to the Pandas of their bus and queue them for the I/O threads, without waiting.
+     * \param pp Pointer to PandaPool struct.
+     * \param frames The frames, with their logical bus.
+     * \param length The number of frames, max. PANDA_TX_MAX_FRAMES.
+     * \return 0: Success
+     * \return <0: Some frames were dropped (no route or the queue is full)
+     *
+     * \fn int pandapool_rx_start(PandaPool *pp)
+     * \brief Start receiving on all Pandas, the frames are read with pandapool_receive().
+     * \param pp Pointer to PandaPool struct.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int pandapool_receive(PandaPool *pp, CANRxFrame *rx)
+     * \brief Read the next received frame of any Panda, with its logical bus. Call after pp->event_fd became readable.
+     * \param pp Pointer to PandaPool struct.
+     * \param rx The frame.
+     * \return 1: A frame was read
+     * \return 0: No frames pending
+     *
+     * \fn int pandapool_get_health(PandaPool *pp, uint8_t device, Health *h)
+     * \brief Get the health of one Panda.
+     * \param pp Pointer to PandaPool struct.
+     * \param device The index of the Panda in the pool.
+     * \param h Pointer to Health struct.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int pandapool_get_health_async(PandaPool *pp, uint8_t device, PandaHealthCallback done, void *ctx)
+     * \brief Read the health of one Panda without waiting, done is called from the I/O thread of that Panda.
+     * \param pp Pointer to PandaPool struct.
+     * \param device The index of the Panda in the pool.
+     * \param done Called with the health when the read completes.
+     * \param ctx Passed to done.
+     * \return 0: Success
+     * \return <0: Fail, LIBUSB_ERROR_BUSY if the previous read is still in flight
+     *
+     * \fn void pandapool_print_stats(PandaPool *pp)
+     * \brief Print the statistics of the pool and of every Panda.
+     * \param pp Pointer to PandaPool struct.
+     */
+
+    int pandapool_open(PandaPool *pp, const char *serials[], const int cpus[], int length, int mode);
+    void pandapool_close(PandaPool *pp);
+    int pandapool_route(PandaPool *pp, uint8_t bus, uint8_t device, uint8_t deviceBus);
+    int pandapool_send(PandaPool *pp, CANFrame frames[], int length);
+    int pandapool_rx_start(PandaPool *pp);
+    int pandapool_receive(PandaPool *pp, CANRxFrame *rx);
+    int pandapool_get_health(PandaPool *pp, uint8_t device, Health *h);
+    int pandapool_get_health_async(PandaPool *pp, uint8_t device, PandaHealthCallback done, void *ctx);
+    void pandapool_print_stats(PandaPool *pp);
+#endif
@@ -0,0 +1,205 @@
+#define _GNU_SOURCE     // pthread_setaffinity_np()
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#include <sys/eventfd.h>
+
+#include "pipeline.h"
+#include "latency.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+static const char *stages[PIPELINE_STAGES] = {"input", "control", "I/O"};
+
+static void pipeline_pin(pthread_t thread, int cpu, PipelineStage stage) {
+    cpu_set_t set;
+
+    if(cpu < 0)
+        return;
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if(pthread_setaffinity_np(thread, sizeof(set), &set) != 0) {
+        terminalColor(31);
+        printf("Could not pin the %s thread to CPU %d\n", stages[stage], cpu);
+        terminalColor(0);
+    }
+}
+
+static PipelineTick *pipeline_slot(Pipeline *p, uint32_t i) {
+    return (PipelineTick*)(p->ticks.items + (size_t)i * p->ticks.item_size);
+}
+
+void pipeline_build(PipelineTick *tick, Control *c, const Scheduler *s) {
+    latency_record(LATENCY_WAKE, s->last_late_ns);
+    if(tick->origin_ns != 0)
+        latency_record(LATENCY_JS_TICK, tick->tick_ns - tick->origin_ns);
+
+    /* Missed deadlines are counted too, so after an overrun every message is still sent on its own cadence. */
+    c->count = (uint32_t)(s->ticks - 1);
+    tick->count = c->count;
+    arena_reset(&tick->frames);
+    control_tick(c, &tick->js, &tick->frames);
+    tick->build_ns = latency_now() - tick->tick_ns;
+    latency_record(LATENCY_BUILD, tick->build_ns);
+
+    tick->control = *c;
+    tick->sched = *s;
+}
+
+static void *pipeline_worker(void *arg) {
+    Pipeline *p = arg;
+    PipelineTick *tick;
+    uint64_t one = 1;
+    uint64_t depth;
+
+    while(atomic_load_explicit(&p->running, memory_order_acquire)) {
+        if(scheduler_wait(&p->sched) < 0)
+            continue;
+
+        /* The control law runs every tick, also when the I/O thread is too far behind to take the frames. */
+        depth = atomic_load_explicit(&p->ticks.head, memory_order_relaxed) - atomic_load_explicit(&p->ticks.tail, memory_order_acquire);
+        tick = spsc_claim(&p->ticks);
+        if(tick == NULL) {
+            p->lost++;
+            tick = &p->spare;
+        }
+
+        tick->tick_ns = latency_now();
+        tick->origin_ns = jsinput_read(p->input, &tick->js);
+        pipeline_build(tick, p->control, &p->sched);
+        if(tick == &p->spare)
+            continue;
+
+        /* Frames this late are not sent, but the tick is queued so the I/O thread still logs it. */
+        tick->dropped = (depth >= PIPELINE_QUEUE);
+        if(tick->dropped) {
+            p->stalled++;
+            arena_reset(&tick->frames);
+        }
+
+        tick->pushed_ns = latency_now();
+        spsc_push(&p->ticks);
+        if(write(p->event_fd, &one, sizeof(one)) < 0) {}
+    }
+
+    return NULL;
+}
+
+int pipeline_start(Pipeline *p, Control *c, JoystickInput *in, uint32_t period_us, const int cpus[PIPELINE_STAGES]) {
+    memset(p, 0, sizeof(Pipeline));
+    p->control = c;
+    p->input = in;
+    p->event_fd = -1;
+    memcpy(p->cpus, cpus, sizeof(p->cpus));
+
+    if(spsc_setup(&p->ticks, PIPELINE_BACKLOG, sizeof(PipelineTick)) < 0)
+        return -1;
+
+    /* Every slot has its own arena, so a tick is built where the I/O thread sends it from. */
+    memset(p->ticks.items, 0, (size_t)(p->ticks.mask + 1) * p->ticks.item_size);
+    for(uint32_t i = 0; i <= p->ticks.mask; i++) {
+        if(arena_init(&pipeline_slot(p, i)->frames) < 0) {
+            pipeline_stop(p);
+            return -1;
+        }
+    }
+
+    p->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(arena_init(&p->spare.frames) < 0 || p->event_fd < 0 || scheduler_setup(&p->sched, period_us) < 0) {
+        pipeline_stop(p);
+        return -1;
+    }
+
+    atomic_store_explicit(&p->running, 1, memory_order_release);
+    if(pthread_create(&p->thread, NULL, pipeline_worker, p) != 0) {
+        terminalColor(31);
+        printf("Could not start the control thread\n");
+        terminalColor(0);
+        pipeline_stop(p);
+        return -1;
+    }
+    p->started = 1;
+
+    pipeline_pin(in->thread, cpus[PIPELINE_INPUT], PIPELINE_INPUT);
+    pipeline_pin(p->thread, cpus[PIPELINE_CONTROL], PIPELINE_CONTROL);
+    pipeline_pin(pthread_self(), cpus[PIPELINE_IO], PIPELINE_IO);
+
+    return 0;
+}
+
+void pipeline_join(Pipeline *p) {
+    if(p->started) {
+        atomic_store_explicit(&p->running, 0, memory_order_release);
+        pthread_join(p->thread, NULL);
+        p->started = 0;
+    }
+}
+
+void pipeline_stop(Pipeline *p) {
+    if(p->ticks.items == NULL)
+        return;
+
+    pipeline_join(p);
+
+    if(p->event_fd >= 0)
+        close(p->event_fd);
+    p->event_fd = -1;
+
+    for(uint32_t i = 0; i <= p->ticks.mask; i++)
+        arena_free(&pipeline_slot(p, i)->frames);
+    arena_free(&p->spare.frames);
+    spsc_free(&p->ticks);
+}
+
+PipelineTick *pipeline_front(Pipeline *p) {
+    PipelineTick *tick = spsc_front(&p->ticks);
+    uint32_t depth;
+
+    if(tick == NULL)
+        return NULL;
+
+    depth = atomic_load_explicit(&p->ticks.head, memory_order_relaxed) - atomic_load_explicit(&p->ticks.tail, memory_order_relaxed);
+    if(depth > p->max_depth)
+        p->max_depth = depth;
+    latency_record(LATENCY_QUEUE, latency_now() - tick->pushed_ns);
+
+    return tick;
+}
+
+void pipeline_pop(Pipeline *p) {
+    spsc_pop(&p->ticks);
+    p->handled++;
+}
+
+void pipeline_print_stats(Pipeline *p) {
+    uint64_t overflows = p->spare.frames.overflows;
+
+    for(uint32_t i = 0; i <= p->ticks.mask; i++)
+        overflows += pipeline_slot(p, i)->frames.overflows;
+
+    scheduler_print_stats(&p->sched);
+    printf("Pipeline: %llu ticks handled, %llu dropped (I/O behind), deepest queue %u of %u\n",
+           (unsigned long long)p->handled, (unsigned long long)p->stalled, p->max_depth, p->ticks.mask + 1);
+    if(p->stalled > 0) {
+        terminalColor(31);
+        printf("The I/O thread could not keep up, the frames of %llu ticks were not sent\n", (unsigned long long)p->stalled);
+        terminalColor(0);
+    }
+    if(p->lost > 0) {
+        terminalColor(31);
+        printf("The queue was full, %llu ticks are missing from the log, a replay will differ\n", (unsigned long long)p->lost);
+        terminalColor(0);
+    }
+    if(overflows > 0) {
+        terminalColor(31);
+        printf("Frames that did not fit in their tick: %llu\n", (unsigned long long)overflows);
+        terminalColor(0);
+    }
+}
@@ -0,0 +1,129 @@
+/**
+ * \file pipeline.h
+ * \date 16 October 2026
+ * \brief File containing the pipeline of the input, control and I/O threads.
+ *
+ * This file contains the function declarations for running the control law on its own thread, as well as the definition
+ * of the Pipeline struct. Every stage runs on its own thread, optionally pinned to a CPU:
+ * \code
+ * input thread:   joystick --> JoystickSnapshot + SpscQueue of events (see joystickInput.h)
+ * control thread: scheduler_wait() --> jsinput_read() --> control_tick() --> SpscQueue of PipelineTick --> eventfd
+ * I/O thread:     pipeline_front() --> log, send, telemetry --> pipeline_pop()
+ * \endcode
+ * The control thread sleeps until the absolute deadline of every tick and never waits for the I/O thread, so the cadence
+ * of the control law does not depend on USB, the log or the telemetry. The queue is bounded: when the I/O thread is
+ * PIPELINE_QUEUE ticks behind, the control law still runs but the frames of the tick are dropped and counted. The tick itself
+ * is still queued and logged, so a replay runs the control law for it as well. Only when the I/O thread is PIPELINE_BACKLOG
+ * ticks behind, ticks are missing from the log.
+ * Every tick is built in the FrameArena of its queue slot, the Panda sends that buffer without copying it.
+ */
+
+#ifndef PIPELINE
+#define PIPELINE
+    #include <stdint.h>
+    #include <stdatomic.h>
+    #include <pthread.h>
+    #include "joystick.h"
+    #include "joystickInput.h"
+    #include "control.h"
+    #include "scheduler.h"
+    #include "spscQueue.h"
+    #include "frameArena.h"
+
+    #define PIPELINE_QUEUE      8   //!< The number of ticks the I/O thread can be behind before their frames are dropped.
+    #define PIPELINE_BACKLOG    64  //!< The number of ticks the I/O thread can be behind before they are not logged.
+
+    /**
+     * \brief Defines the stages, the index of their CPU.
+     */
+    typedef enum {
+        PIPELINE_INPUT = 0,     //!< The thread reading the joystick.
+        PIPELINE_CONTROL,       //!< The thread running the control law.
+        PIPELINE_IO,            //!< The thread sending and logging, the thread calling pipeline_start().
+        PIPELINE_STAGES
+    } PipelineStage;
+
+    /**
+     * \brief Defines one tick, from the control law to the I/O.
+     */
+    typedef struct {
+        uint64_t tick_ns;       //!< The CLOCK_MONOTONIC time the tick started.
+        uint64_t pushed_ns;     //!< The time the tick was handed to the I/O.
+        uint64_t origin_ns;     //!< The time the oldest joystick event of the tick was read, 0 if none.
+        int64_t build_ns;       //!< The time to build the frames.
+        uint32_t count;         //!< The counter of the control law during the tick.
+        uint8_t dropped;        //!< Were the frames dropped because the I/O thread was behind? Only the tick is logged.
+        Joystick js;            //!< The state of the joystick the frames were built from.
+        Control control;        //!< The state of the control law after the tick.
+        Scheduler sched;        //!< The statistics of the scheduler after the tick.
+        FrameArena frames;      //!< The frames of the tick.
+    } PipelineTick;
+
+    /**
+     * \brief Defines the control thread and its queue to the I/O thread.
+     */
+    typedef struct {
+        Control *control;               //!< The control law, only used by the control thread after pipeline_start().
+        JoystickInput *input;           //!< The input thread the joystick state comes from.
+        Scheduler sched;                //!< The deadlines of the control thread.
+        SpscQueue ticks;                //!< The built ticks (PipelineTick).
+        PipelineTick spare;             //!< The tick built when the queue is full, it is not sent nor logged.
+        int event_fd;                   //!< Written by the control thread after every tick, read by the I/O thread.
+        int cpus[PIPELINE_STAGES];      //!< The CPU of every stage, -1 if not pinned.
+        pthread_t thread;               //!< The control thread.
+        uint8_t started;                //!< Is the control thread running?
+        _Atomic uint8_t running;        //!< Cleared to stop the control thread.
+        uint64_t stalled;               //!< The number of ticks of which the frames were dropped.
+        uint64_t lost;                  //!< The number of ticks not logged because the queue was full.
+        uint64_t handled;               //!< The number of ticks taken by the I/O thread.
+        uint32_t max_depth;             //!< The most ticks seen in the queue by the I/O thread.
+    } Pipeline;
+
+    /**
+     * \fn void pipeline_build(PipelineTick *tick, Control *c, const Scheduler *s)
+     * \brief Run the control law on tick->js and record the timing. Used by the control thread, and by the single
+     * threaded loop without a pipeline. The counter of the control law is set from the deadlines passed, missed ones included.
+     * \param tick The tick, with tick_ns, origin_ns and js set. The frames are added to tick->frames.
+     * \param c The control law.
+     * \param s The scheduler that started the tick.
+     *
+     * \fn int pipeline_start(Pipeline *p, Control *c, JoystickInput *in, uint32_t period_us, const int cpus[PIPELINE_STAGES])
+     * \brief Start the control thread, and pin the input thread and the calling thread.
+     * \param p Pointer to Pipeline struct.
+     * \param c The control law, set up with control_setup().
+     * \param in The input thread, started with jsinput_start().
+     * \param period_us The period of the tick in microseconds.
+     * \param cpus The CPU of every stage, -1 to not pin it.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void pipeline_join(Pipeline *p)
+     * \brief Stop the control thread. The queue and the statistics stay available until pipeline_stop().
+     * \param p Pointer to Pipeline struct.
+     *
+     * \fn void pipeline_stop(Pipeline *p)
+     * \brief Stop the control thread and free the queue.
+     * \param p Pointer to Pipeline struct.
+     *
+     * \fn PipelineTick *pipeline_front(Pipeline *p)
+     * \brief I/O thread: get the oldest built tick.
+     * \param p Pointer to Pipeline struct.
+     * \return The tick, followed by pipeline_pop(). NULL if there is none.
+     *
+     * \fn void pipeline_pop(Pipeline *p)
+     * \brief I/O thread: done with the tick of pipeline_front().
+     * \param p Pointer to Pipeline struct.
+     *
+     * \fn void pipeline_print_stats(Pipeline *p)
+     * \brief Print the statistics of the control thread and the queue.
+     * \param p Pointer to Pipeline struct.
+     */
+
+    void pipeline_build(PipelineTick *tick, Control *c, const Scheduler *s);
+    int pipeline_start(Pipeline *p, Control *c, JoystickInput *in, uint32_t period_us, const int cpus[PIPELINE_STAGES]);
+    void pipeline_join(Pipeline *p);
+    void pipeline_stop(Pipeline *p);
+    PipelineTick *pipeline_front(Pipeline *p);
+    void pipeline_pop(Pipeline *p);
+    void pipeline_print_stats(Pipeline *p);
+#endif
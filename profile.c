@@ -0,0 +1,258 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "profile.h"
+#include "toyotaRav4.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+#define PROFILE_LINE_LENGTH 512
+#define PROFILE_SEPARATORS  " \t\r\n"
+
+/**
+ * \brief Defines a checksum algorithm that can be selected in a profile.
+ */
+typedef struct {
+    const char *name;
+    ChecksumFunction checksum;
+} ProfileChecksum;
+
+static const ProfileChecksum checksums[] = {
+    {"toyota", create_checksum}
+};
+
+static int profile_error(const char *path, int line, const char *msg) {
+    terminalColor(31);
+    printf("%s:%d: %s\n", path, line, msg);
+    terminalColor(0);
+    return -1;
+}
+
+static int parse_number(const char *tok, int base, long min, long max, long *value) {
+    char *end;
+
+    if(tok == NULL)
+        return -1;
+
+    *value = strtol(tok, &end, base);
+    if(*end != '\0' || end == tok || *value < min || *value > max)
+        return -1;
+
+    return 0;
+}
+
+/* Convert a period in milliseconds to ticks, -2 if it is not a whole number of ticks. */
+static int parse_period(const char *tok, uint32_t tick_us, long *ticks) {
+    long ms;
+
+    if(parse_number(tok, 0, 1, 0xFFFF, &ms) < 0)
+        return -1;
+    if((ms * 1000) % tick_us != 0 || (ms * 1000) / tick_us > 0xFFFF)
+        return -2;
+
+    *ticks = (ms * 1000) / tick_us;
+    return 0;
+}
+
+static int parse_name(const char *tok, char name[PROFILE_NAME_LENGTH]) {
+    if(tok == NULL || strlen(tok) >= PROFILE_NAME_LENGTH)
+        return -1;
+
+    strcpy(name, tok);
+    return 0;
+}
+
+static int parse_frame(char **save, ScheduleEntry *e, uint32_t tick_us) {
+    long v[5];
+    char *tok;
+    int ret;
+
+    memset(e, 0, sizeof(ScheduleEntry));
+
+    if(parse_number(strtok_r(NULL, PROFILE_SEPARATORS, save), 0, 0, 0x7FF, &v[0]) < 0 ||
+       parse_number(strtok_r(NULL, PROFILE_SEPARATORS, save), 0, 0, 0xFF, &v[1]) < 0)
+        return -1;
+    ret = parse_period(strtok_r(NULL, PROFILE_SEPARATORS, save), tick_us, &v[2]);
+    if(ret < 0)
+        return ret;
+
+    e->frame.ID = v[0];
+    e->frame.bus = v[1];
+    e->frame.freq = v[2];
+
+    while((tok = strtok_r(NULL, PROFILE_SEPARATORS, save)) != NULL) {
+        if(strcmp(tok, "counter") == 0) {
+            for(int i = 0; i < 5; i++) {
+                if(i == 1)
+                    ret = parse_period(strtok_r(NULL, PROFILE_SEPARATORS, save), tick_us, &v[i]);
+                else
+                    ret = parse_number(strtok_r(NULL, PROFILE_SEPARATORS, save), 0, 0, 0xFFFF, &v[i]);
+                if(ret < 0)
+                    return ret;
+            }
+            if(v[0] >= e->frame.length || v[2] == 0 || v[3] > 0xFF || v[4] > 7)
+                return -1;
+
+            e->hasCounter = 1;
+            e->counter.byte = v[0];
+            e->counter.div = v[1];
+            e->counter.mod = v[2];
+            e->counter.add = v[3];
+            e->counter.shift = v[4];
+        } else if(strcmp(tok, "checksum") == 0) {
+            e->checksum = 1;
+        } else {
+            if(e->hasCounter || e->checksum || e->frame.length >= 8)
+                return -1;
+            if(parse_number(tok, 16, 0, 0xFF, &v[0]) < 0)
+                return -1;
+
+            e->frame.data[e->frame.length++] = v[0];
+        }
+    }
+
+    if(e->frame.length == 0)
+        return -1;
+
+    return 0;
+}
+
+static int parse_command(char **save, ProfileCommand *c, uint32_t tick_us) {
+    long v[4];
+    int ret;
+
+    if(parse_name(strtok_r(NULL, PROFILE_SEPARATORS, save), c->name) < 0)
+        return -1;
+
+    if(parse_number(strtok_r(NULL, PROFILE_SEPARATORS, save), 0, 0, 0x7FF, &v[0]) < 0 ||
+       parse_number(strtok_r(NULL, PROFILE_SEPARATORS, save), 0, 0, 0xFF, &v[1]) < 0 ||
+       parse_number(strtok_r(NULL, PROFILE_SEPARATORS, save), 0, 1, 8, &v[2]) < 0)
+        return -1;
+
+    ret = parse_period(strtok_r(NULL, PROFILE_SEPARATORS, save), tick_us, &v[3]);
+    if(ret < 0)
+        return ret;
+
+    c->ID = v[0];
+    c->bus = v[1];
+    c->length = v[2];
+    c->period = v[3];
+
+    return 0;
+}
+
+int profile_load(VehicleProfile *vp, const char *path, uint32_t tick_us) {
+    char line[PROFILE_LINE_LENGTH];
+    char *save, *tok, *comment;
+    ProfileGroup *group = NULL;
+    unsigned int i;
+    int nr = 0;
+    int ret = -1;
+    FILE *f;
+
+    memset(vp, 0, sizeof(VehicleProfile));
+    vp->tick_us = tick_us;
+    if(tick_us == 0)
+        return -1;
+
+    f = fopen(path, "r");
+    if(f == NULL) {
+        terminalColor(31);
+        printf("Could not open profile %s\n", path);
+        terminalColor(0);
+        return -1;
+    }
+
+    while(fgets(line, sizeof(line), f) != NULL) {
+        nr++;
+
+        comment = strchr(line, '#');
+        if(comment != NULL)
+            *comment = '\0';
+
+        tok = strtok_r(line, PROFILE_SEPARATORS, &save);
+        if(tok == NULL)
+            continue;
+
+        if(strcmp(tok, "vehicle") == 0) {
+            if(parse_name(strtok_r(NULL, PROFILE_SEPARATORS, &save), vp->name) < 0)
+                goto error;
+        } else if(strcmp(tok, "checksum") == 0) {
+            tok = strtok_r(NULL, PROFILE_SEPARATORS, &save);
+            for(i = 0; tok != NULL && i < sizeof(checksums) / sizeof(checksums[0]); i++) {
+                if(strcmp(tok, checksums[i].name) == 0)
+                    vp->checksum = checksums[i].checksum;
+            }
+            if(vp->checksum == NULL)
+                goto error;
+        } else if(strcmp(tok, "group") == 0) {
+            if(vp->nrGroups >= PROFILE_MAX_GROUPS)
+                goto error;
+            group = &vp->groups[vp->nrGroups++];
+            if(parse_name(strtok_r(NULL, PROFILE_SEPARATORS, &save), group->name) < 0)
+                goto error;
+            group->first = vp->nrFrames;
+        } else if(strcmp(tok, "frame") == 0) {
+            if(group == NULL || vp->nrFrames >= PROFILE_MAX_FRAMES)
+                goto error;
+            ret = parse_frame(&save, &vp->frames[vp->nrFrames], tick_us);
+            if(ret < 0)
+                goto error;
+            if(vp->frames[vp->nrFrames].checksum && vp->checksum == NULL)
+                goto error;
+            vp->nrFrames++;
+            group->length++;
+        } else if(strcmp(tok, "command") == 0) {
+            if(vp->nrCommands >= PROFILE_MAX_COMMANDS)
+                goto error;
+            ret = parse_command(&save, &vp->commands[vp->nrCommands++], tick_us);
+            if(ret < 0)
+                goto error;
+        } else {
+            goto error;
+        }
+    }
+
+    fclose(f);
+
+    terminalColor(32);
+    printf("Loaded profile %s\n", vp->name);
+    terminalColor(0);
+
+    return 0;
+
+    error:
+    fclose(f);
+    if(ret == -2)
+        return profile_error(path, nr, "Period is not a whole number of ticks");
+    return profile_error(path, nr, "Invalid statement");
+}
+
+const ProfileGroup *profile_group(const VehicleProfile *vp, const char *name) {
+    for(int i = 0; i < vp->nrGroups; i++) {
+        if(strcmp(vp->groups[i].name, name) == 0)
+            return &vp->groups[i];
+    }
+
+    return NULL;
+}
+
+const ProfileCommand *profile_command(const VehicleProfile *vp, const char *name) {
+    for(int i = 0; i < vp->nrCommands; i++) {
+        if(strcmp(vp->commands[i].name, name) == 0)
+            return &vp->commands[i];
+    }
+
+    return NULL;
+}
+
+int profile_compile_group(const VehicleProfile *vp, const char *name, Schedule *s) {
+    const ProfileGroup *group = profile_group(vp, name);
+
+    if(group == NULL)
+        return schedule_compile(s, NULL, 0, vp->checksum);
+
+    return schedule_compile(s, &vp->frames[group->first], group->length, vp->checksum);
+}
@@ -0,0 +1,106 @@
+/**
+ * \file profile.h
+ * \date 16 October 2026
+ * \brief File containing the loader of vehicle profiles.
+ *
+ * This file contains the function declarations for loading a vehicle profile, as well as the definition of the VehicleProfile struct.
+ * A profile describes all the static frames (with their counters and checksums) and the command messages of a car,
+ * so another car can be driven without recompiling.
+ *
+ * A profile is a text file with one statement per line, # starts a comment:
+ * \code
+ * vehicle  <name>
+ * checksum <algorithm>                                   (toyota)
+ * group    <name>                                        (the following frames belong to this group)
+ * frame    <id> <bus> <period> <data...> [counter <byte> <div> <mod> <add> <shift>] [checksum]
+ * command  <name> <id> <bus> <length> <period>
+ * \endcode
+ * Numbers are decimal or 0x hexadecimal, the data bytes of a frame are always hexadecimal. Periods and the div of a counter
+ * are in milliseconds, the loader converts them to ticks of the control loop. A period that is not a whole number of ticks
+ * is an error: rounding it would change the cadence the car expects.
+ */
+
+#ifndef PROFILE
+#define PROFILE
+    #include <stdint.h>
+    #include "canFrame.h"
+    #include "schedule.h"
+
+    #define PROFILE_MAX_FRAMES      256     //!< The maximum number of static frames in a profile.
+    #define PROFILE_MAX_GROUPS      8       //!< The maximum number of groups in a profile.
+    #define PROFILE_MAX_COMMANDS    16      //!< The maximum number of command messages in a profile.
+    #define PROFILE_NAME_LENGTH     32      //!< The maximum length of a name, including the terminator.
+
+    /**
+     * \brief Defines a group of static frames that is enabled as a whole (for example everything replacing the camera).
+     */
+    typedef struct {
+        char name[PROFILE_NAME_LENGTH];     //!< The name of the group.
+        uint16_t first;                     //!< The index of the first frame of the group.
+        uint16_t length;                    //!< The number of frames in the group.
+    } ProfileGroup;
+
+    /**
+     * \brief Defines a command message, of which the data is calculated every time it is sent.
+     */
+    typedef struct {
+        char name[PROFILE_NAME_LENGTH];     //!< The name of the command.
+        uint16_t ID;                        //!< The CAN ID of the message.
+        uint8_t bus;                        //!< The bus to send the message on.
+        uint8_t length;                     //!< The number of data bytes.
+        uint16_t period;                    //!< The period of the message in ticks (milliseconds in the profile).
+    } ProfileCommand;
+
+    /**
+     * \brief Defines a loaded vehicle profile.
+     *
+     * All frames are stored in one flat array, with the frames of a group next to each other,
+     * so the arrays can be compiled into schedules directly.
+     */
+    typedef struct {
+        char name[PROFILE_NAME_LENGTH];                 //!< The name of the vehicle.
+        ChecksumFunction checksum;                      //!< The checksum algorithm of the vehicle.
+        ScheduleEntry frames[PROFILE_MAX_FRAMES];       //!< All static frames.
+        uint16_t nrFrames;                              //!< The number of static frames.
+        ProfileGroup groups[PROFILE_MAX_GROUPS];        //!< The groups of static frames.
+        uint8_t nrGroups;                               //!< The number of groups.
+        ProfileCommand commands[PROFILE_MAX_COMMANDS];  //!< The command messages.
+        uint8_t nrCommands;                             //!< The number of command messages.
+        uint32_t tick_us;                               //!< The period of the tick the periods are converted to.
+    } VehicleProfile;
+
+    /**
+     * \fn int profile_load(VehicleProfile *vp, const char *path, uint32_t tick_us)
+     * \brief Load a vehicle profile from a file.
+     * \param vp Pointer to VehicleProfile struct.
+     * \param path The path of the profile.
+     * \param tick_us The period of the control loop in microseconds.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn const ProfileGroup *profile_group(const VehicleProfile *vp, const char *name)
+     * \brief Find a group of static frames.
+     * \param vp Pointer to VehicleProfile struct.
+     * \param name The name of the group.
+     * \return The group, NULL if the profile does not have it.
+     *
+     * \fn const ProfileCommand *profile_command(const VehicleProfile *vp, const char *name)
+     * \brief Find a command message.
+     * \param vp Pointer to VehicleProfile struct.
+     * \param name The name of the command.
+     * \return The command, NULL if the profile does not have it.
+     *
+     * \fn int profile_compile_group(const VehicleProfile *vp, const char *name, Schedule *s)
+     * \brief Compile the frames of a group into a send schedule. A missing group gives an empty schedule.
+     * \param vp Pointer to VehicleProfile struct.
+     * \param name The name of the group.
+     * \param s The schedule to compile.
+     * \return 0: Success
+     * \return <0: Fail
+     */
+
+    int profile_load(VehicleProfile *vp, const char *path, uint32_t tick_us);
+    const ProfileGroup *profile_group(const VehicleProfile *vp, const char *name);
+    const ProfileCommand *profile_command(const VehicleProfile *vp, const char *name);
+    int profile_compile_group(const VehicleProfile *vp, const char *name, Schedule *s);
+#endif
@@ -0,0 +1,65 @@
+# Toyota Rav4 Hybrid
+#
+# Replaces the camera (groups video and cam) and the DSU (group dsu).
+# Periods (and the div of a counter) are in milliseconds, they must be a whole number of ticks of the control loop.
+
+vehicle  toyotaRav4
+checksum toyota
+
+group video
+#     id     bus period data                       counter byte div mod add shift
+frame 0x340  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x341  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x342  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x343  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x344  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x345  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x363  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x364  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x365  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x370  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x371  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x372  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x373  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x374  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x375  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x380  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x381  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x382  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+frame 0x383  1   100    00 03 FF 00 00 00 00 00    counter 0 100 256 0 0  checksum
+
+group cam
+frame 0x367  0   400    06 00
+frame 0x414  0   1000   00 00 00 00 00 00 17 00
+frame 0x489  0   1000   00 00 00 00 00 00 00 00    counter 7 1000 15 1 0
+frame 0x48A  0   1000   00 00 00 00 00 00 00 80    counter 7 1000 15 1 0
+frame 0x48B  0   1000   66 06 08 0A 02 00 00 00
+frame 0x4D3  0   1000   1C 00 00 01 00 00 00 00
+frame 0x130  1   1000   00 00 00 00 00 00 38
+frame 0x240  1   50     00 00 10 01 00 10 01 00    counter 0 50 7 1 5
+frame 0x241  1   50     00 00 10 01 00 10 01 00    counter 0 50 7 1 5
+frame 0x244  1   50     00 00 10 01 00 10 01 00    counter 0 50 7 1 5
+frame 0x245  1   50     00 00 10 01 00 10 01 00    counter 0 50 7 1 5
+frame 0x248  1   50     00 00 00 00 00 00 00 01    counter 0 50 7 1 5
+frame 0x466  1   1000   20 20 AD
+
+group dsu
+frame 0x141  1   20     00 00 00 46
+frame 0x128  1   30     F4 01 90 83 00 37
+frame 0x283  0   30     00 00 00 00 00 00 8C
+frame 0x2E6  0   30     FF F8 00 08 7F E0 00 4E
+frame 0x2E7  0   30     A8 9C 31 9C 00 00 00 02
+frame 0x344  0   50     00 00 01 00 00 00 00 50
+frame 0x160  1   70     00 00 08 12 01 31 9C 51
+frame 0x161  1   70     00 1E 00 00 00 80 07
+frame 0x33E  0   200    0F FF 26 40 00 1F 00
+frame 0x365  0   200    00 00 00 80 03 00 08
+frame 0x366  0   200    00 00 4D 82 40 02 00
+frame 0x4CB  0   1000   0C 00 00 00 00 00 00 00
+frame 0x470  1   1000   00 00 02 7A
+
+#       name   id     bus length period
+command steer  0x2E4  0   5      10
+command accel  0x343  0   8      30
+command ui     0x412  0   8      1000
+command fcw    0x411  0   8      1000
@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <sys/epoll.h>
+
+#include "reactor.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+int reactor_setup(Reactor *r) {
+    for(int i = 0; i < REACTOR_MAX_SOURCES; i++) {
+        r->sources[i].fd = -1;
+        r->sources[i].cb = NULL;
+    }
+
+    r->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if(r->epfd < 0) {
+        terminalColor(31);
+        printf("Could not create epoll\n");
+        terminalColor(0);
+        return -1;
+    }
+
+    return 0;
+}
+
+int reactor_add(Reactor *r, int fd, uint32_t events, ReactorCallback cb, void *ctx) {
+    struct epoll_event ev;
+    ReactorSource *src = NULL;
+
+    for(int i = 0; i < REACTOR_MAX_SOURCES; i++) {
+        if(r->sources[i].fd == -1) {
+            src = &r->sources[i];
+            break;
+        }
+    }
+    if(src == NULL)
+        return -1;
+
+    ev.events = events;
+    ev.data.ptr = src;
+    if(epoll_ctl(r->epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        return -1;
+
+    src->fd = fd;
+    src->cb = cb;
+    src->ctx = ctx;
+
+    return 0;
+}
+
+int reactor_remove(Reactor *r, int fd) {
+    for(int i = 0; i < REACTOR_MAX_SOURCES; i++) {
+        if(r->sources[i].fd == fd) {
+            epoll_ctl(r->epfd, EPOLL_CTL_DEL, fd, NULL);
+            r->sources[i].fd = -1;
+            r->sources[i].cb = NULL;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int reactor_run_once(Reactor *r, int timeout_ms) {
+    struct epoll_event events[REACTOR_MAX_EVENTS];
+    ReactorSource *src;
+    int n;
+
+    n = epoll_wait(r->epfd, events, REACTOR_MAX_EVENTS, timeout_ms);
+    if(n < 0) {
+        /* A signal woke us up, let the caller check its flags. */
+        return (errno == EINTR) ? 0 : -1;
+    }
+
+    for(int i = 0; i < n; i++) {
+        src = events[i].data.ptr;
+
+        /* The source may have been removed by an earlier callback. */
+        if(src->cb != NULL)
+            src->cb(src->fd, events[i].events, src->ctx);
+    }
+
+    return n;
+}
+
+void reactor_close(Reactor *r) {
+    if(r->epfd >= 0)
+        close(r->epfd);
+    r->epfd = -1;
+}
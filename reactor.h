@@ -0,0 +1,81 @@
+/**
+ * \file reactor.h
+ * \date 16 October 2026
+ * \brief File containing the event loop of the program.
+ *
+ * This file contains the function declarations for waiting on multiple file descriptors at once
+ * (joystick, tick timer, USB), as well as the definition of the Reactor struct.
+ */
+
+#ifndef REACTOR
+#define REACTOR
+    #include <stdint.h>
+    #include <sys/epoll.h>
+
+    #define REACTOR_MAX_SOURCES 32  //!< The maximum number of file descriptors in one reactor.
+    #define REACTOR_MAX_EVENTS  16  //!< The maximum number of events handled per wake up.
+
+    /**
+     * \brief Function called when a file descriptor has work.
+     */
+    typedef void (*ReactorCallback)(int fd, uint32_t events, void *ctx);
+
+    /**
+     * \brief Defines one file descriptor that is watched by the reactor.
+     */
+    typedef struct {
+        int fd;                 //!< The watched file descriptor, -1 if the slot is free.
+        ReactorCallback cb;     //!< The function to call when the file descriptor has work.
+        void *ctx;              //!< The context passed to the callback.
+    } ReactorSource;
+
+    /**
+     * \brief Defines an epoll based event loop.
+     */
+    typedef struct {
+        int epfd;                                       //!< The epoll file descriptor.
+        ReactorSource sources[REACTOR_MAX_SOURCES];     //!< All the registered sources.
+    } Reactor;
+
+    /**
+     * \fn int reactor_setup(Reactor *r)
+     * \brief Setup the reactor.
+     * \param r Pointer to Reactor struct.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int reactor_add(Reactor *r, int fd, uint32_t events, ReactorCallback cb, void *ctx)
+     * \brief Watch a file descriptor.
+     * \param r Pointer to Reactor struct.
+     * \param fd The file descriptor to watch.
+     * \param events The epoll events to wait for (EPOLLIN, EPOLLOUT, ...).
+     * \param cb The function to call when the file descriptor has work.
+     * \param ctx The context passed to the callback.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int reactor_remove(Reactor *r, int fd)
+     * \brief Stop watching a file descriptor.
+     * \param r Pointer to Reactor struct.
+     * \param fd The file descriptor to remove.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int reactor_run_once(Reactor *r, int timeout_ms)
+     * \brief Wait until at least one source has work and run its callback.
+     * \param r Pointer to Reactor struct.
+     * \param timeout_ms The maximum time to wait, -1 to wait forever.
+     * \return >=0: The number of callbacks run (0 on timeout or signal)
+     * \return <0: Fail
+     *
+     * \fn void reactor_close(Reactor *r)
+     * \brief Close the reactor. The watched file descriptors are not closed.
+     * \param r Pointer to Reactor struct.
+     */
+
+    int reactor_setup(Reactor *r);
+    int reactor_add(Reactor *r, int fd, uint32_t events, ReactorCallback cb, void *ctx);
+    int reactor_remove(Reactor *r, int fd);
+    int reactor_run_once(Reactor *r, int timeout_ms);
+    void reactor_close(Reactor *r);
+#endif
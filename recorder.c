@@ -0,0 +1,334 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdatomic.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "recorder.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+_Static_assert(sizeof(RecorderRecord) == 32, "The records must stay 32 bytes");
+_Static_assert(sizeof(RecorderHeader) <= RECORDER_HEADER_SIZE, "The header must fit in its page");
+
+static uint64_t clock_ns(clockid_t clock) {
+    struct timespec now;
+
+    clock_gettime(clock, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static uint64_t page_align(uint64_t size) {
+    uint64_t page = sysconf(_SC_PAGESIZE);
+    return (size + page - 1) / page * page;
+}
+
+int recorder_open(Recorder *r, const char *path, uint64_t capacity, uint32_t tick_us) {
+    uint64_t blocks = (capacity + RECORDER_BLOCK - 1) / RECORDER_BLOCK;
+    uint64_t indexSize = page_align(blocks * sizeof(uint64_t));
+    RecorderHeader *h;
+    int ret;
+
+    memset(r, 0, sizeof(Recorder));
+    r->fd = -1;
+
+    if(blocks == 0)
+        return -1;
+
+    r->capacity = blocks * RECORDER_BLOCK;
+    r->size = RECORDER_HEADER_SIZE + indexSize + r->capacity * sizeof(RecorderRecord);
+
+    r->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(r->fd < 0) {
+        terminalColor(31);
+        printf("Could not create log %s\n", path);
+        terminalColor(0);
+        return -1;
+    }
+
+    /* Reserve all blocks now, so the disk can not fill up while recording. */
+    ret = posix_fallocate(r->fd, 0, r->size);
+    if(ret != 0 && ftruncate(r->fd, r->size) < 0)
+        goto error;
+
+    r->map = mmap(NULL, r->size, PROT_READ | PROT_WRITE, MAP_SHARED, r->fd, 0);
+    if(r->map == MAP_FAILED) {
+        r->map = NULL;
+        goto error;
+    }
+    madvise(r->map + RECORDER_HEADER_SIZE + indexSize, r->capacity * sizeof(RecorderRecord), MADV_SEQUENTIAL);
+
+    r->header = (RecorderHeader*)r->map;
+    r->index = (uint64_t*)(r->map + RECORDER_HEADER_SIZE);
+    r->records = (RecorderRecord*)(r->map + RECORDER_HEADER_SIZE + indexSize);
+
+    h = r->header;
+    memcpy(h->magic, RECORDER_MAGIC, sizeof(h->magic));
+    h->version = RECORDER_VERSION;
+    h->record_size = sizeof(RecorderRecord);
+    h->capacity = r->capacity;
+    h->block = RECORDER_BLOCK;
+    h->tick_us = tick_us;
+    h->index_offset = RECORDER_HEADER_SIZE;
+    h->records_offset = RECORDER_HEADER_SIZE + indexSize;
+    atomic_init(&h->count, 0);
+    h->start_monotonic_ns = clock_ns(CLOCK_MONOTONIC);
+    h->start_realtime_ns = clock_ns(CLOCK_REALTIME);
+
+    terminalColor(32);
+    printf("Recording to %s (%llu records)\n", path, (unsigned long long)r->capacity);
+    terminalColor(0);
+
+    return 0;
+
+    error:
+    terminalColor(31);
+    printf("Could not allocate log %s\n", path);
+    terminalColor(0);
+    close(r->fd);
+    r->fd = -1;
+    return -1;
+}
+
+void recorder_close(Recorder *r) {
+    uint64_t count;
+    off_t size;
+
+    if(r->records == NULL) {
+        if(r->fd >= 0)
+            close(r->fd);
+        r->fd = -1;
+        return;
+    }
+
+    count = atomic_load(&r->header->count);
+    if(count > r->capacity)
+        count = r->capacity;
+    atomic_store(&r->header->count, count);
+    size = r->header->records_offset + count * sizeof(RecorderRecord);
+
+    msync(r->map, r->size, MS_SYNC);
+    munmap(r->map, r->size);
+    if(ftruncate(r->fd, size) < 0) {
+        terminalColor(31);
+        printf("Could not shrink the log\n");
+        terminalColor(0);
+    }
+    close(r->fd);
+
+    r->fd = -1;
+    r->map = NULL;
+    r->header = NULL;
+    r->index = NULL;
+    r->records = NULL;
+}
+
+/* Claim length records, returns the first one, the number that fit is put in length. */
+static RecorderRecord *recorder_claim(Recorder *r, int *length, uint64_t timestamp_ns) {
+    uint64_t pos = atomic_fetch_add_explicit(&r->header->count, *length, memory_order_relaxed);
+
+    if(pos >= r->capacity) {
+        *length = 0;
+        return NULL;
+    }
+    if(pos + *length > r->capacity)
+        *length = r->capacity - pos;
+
+    /* The first record of a block sets the index. */
+    for(uint64_t b = (pos + RECORDER_BLOCK - 1) / RECORDER_BLOCK; b * RECORDER_BLOCK < pos + *length; b++)
+        r->index[b] = timestamp_ns;
+
+    return &r->records[pos];
+}
+
+static void recorder_publish(RecorderRecord *rec, RecordKind kind) {
+    atomic_thread_fence(memory_order_release);
+    rec->kind = kind;
+}
+
+void recorder_frames(Recorder *r, RecordKind kind, const CANFrame frames[], int length, uint64_t timestamp_ns) {
+    RecorderRecord *rec;
+
+    if(r->records == NULL || length <= 0)
+        return;
+
+    rec = recorder_claim(r, &length, timestamp_ns);
+    for(int i = 0; i < length; i++) {
+        rec[i].timestamp_ns = timestamp_ns;
+        rec[i].tick = r->tick;
+        rec[i].ID = frames[i].ID;
+        rec[i].bus = frames[i].bus;
+        rec[i].length = frames[i].length;
+        rec[i].flags = 0;
+        rec[i].device_time = 0;
+        memcpy(rec[i].data, frames[i].data, 8);
+        rec[i].reserved = 0;
+        recorder_publish(&rec[i], kind);
+    }
+}
+
+void recorder_arena(Recorder *r, RecordKind kind, const FrameArena *a, uint64_t timestamp_ns) {
+    RecorderRecord *rec;
+    CANFrame frame;
+    int length = a->length;
+
+    if(r->records == NULL || length <= 0)
+        return;
+
+    rec = recorder_claim(r, &length, timestamp_ns);
+    for(int i = 0; i < length; i++) {
+        arena_get(a, i, &frame);
+        rec[i].timestamp_ns = timestamp_ns;
+        rec[i].tick = r->tick;
+        rec[i].ID = frame.ID;
+        rec[i].bus = frame.bus;
+        rec[i].length = frame.length;
+        rec[i].flags = 0;
+        rec[i].device_time = 0;
+        memcpy(rec[i].data, frame.data, 8);
+        rec[i].reserved = 0;
+        recorder_publish(&rec[i], kind);
+    }
+}
+
+void recorder_rx(Recorder *r, const CANRxFrame *rx) {
+    RecorderRecord *rec;
+    int length = 1;
+
+    if(r->records == NULL)
+        return;
+
+    rec = recorder_claim(r, &length, rx->timestamp_ns);
+    if(length == 0)
+        return;
+
+    rec->timestamp_ns = rx->timestamp_ns;
+    rec->tick = r->tick;
+    rec->ID = rx->frame.ID;
+    rec->bus = rx->frame.bus;
+    rec->length = rx->frame.length;
+    rec->flags = rx->flags;
+    rec->device_time = rx->device_time;
+    memcpy(rec->data, rx->frame.data, 8);
+    rec->reserved = 0;
+    recorder_publish(rec, RECORD_RX);
+}
+
+void recorder_event(Recorder *r, RecordKind kind, const void *data, uint8_t length, uint64_t timestamp_ns) {
+    RecorderRecord *rec;
+    int n = 1;
+
+    if(r->records == NULL)
+        return;
+
+    rec = recorder_claim(r, &n, timestamp_ns);
+    if(n == 0)
+        return;
+
+    if(length > 8)
+        length = 8;
+
+    memset(rec, 0, sizeof(RecorderRecord));
+    rec->timestamp_ns = timestamp_ns;
+    rec->tick = r->tick;
+    rec->length = length;
+    memcpy(rec->data, data, length);
+    recorder_publish(rec, kind);
+}
+
+void recorder_tick(Recorder *r, RecordKind kind, uint32_t tick, uint64_t timestamp_ns) {
+    r->tick = tick;
+    recorder_event(r, kind, &tick, sizeof(tick), timestamp_ns);
+}
+
+uint64_t recorder_dropped(const Recorder *r) {
+    uint64_t count;
+
+    if(r->records == NULL)
+        return 0;
+
+    count = atomic_load_explicit(&r->header->count, memory_order_relaxed);
+    return (count > r->capacity) ? count - r->capacity : 0;
+}
+
+int recorder_load(RecorderLog *log, const char *path) {
+    const RecorderHeader *h;
+    struct stat st;
+    int fd;
+
+    memset(log, 0, sizeof(RecorderLog));
+
+    fd = open(path, O_RDONLY);
+    if(fd < 0 || fstat(fd, &st) < 0 || (size_t)st.st_size < RECORDER_HEADER_SIZE) {
+        terminalColor(31);
+        printf("Could not open log %s\n", path);
+        terminalColor(0);
+        if(fd >= 0)
+            close(fd);
+        return -1;
+    }
+
+    log->size = st.st_size;
+    log->map = mmap(NULL, log->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(log->map == MAP_FAILED) {
+        log->map = NULL;
+        return -1;
+    }
+
+    h = (const RecorderHeader*)log->map;
+    if(memcmp(h->magic, RECORDER_MAGIC, sizeof(RECORDER_MAGIC)) != 0 || h->version != RECORDER_VERSION ||
+       h->record_size != sizeof(RecorderRecord) || h->records_offset > log->size) {
+        terminalColor(31);
+        printf("%s is not a valid log\n", path);
+        terminalColor(0);
+        recorder_unload(log);
+        return -1;
+    }
+
+    log->header = h;
+    log->index = (const uint64_t*)(log->map + h->index_offset);
+    log->records = (const RecorderRecord*)(log->map + h->records_offset);
+    log->count = atomic_load((_Atomic uint64_t*)&h->count);
+
+    /* A log that was not closed still has the full size, only trust what is in the file. */
+    if(log->count > (log->size - h->records_offset) / sizeof(RecorderRecord))
+        log->count = (log->size - h->records_offset) / sizeof(RecorderRecord);
+
+    return 0;
+}
+
+void recorder_unload(RecorderLog *log) {
+    if(log->map != NULL)
+        munmap((void*)log->map, log->size);
+
+    memset(log, 0, sizeof(RecorderLog));
+}
+
+uint64_t recorder_seek(const RecorderLog *log, uint64_t timestamp_ns) {
+    uint64_t blocks = (log->count + log->header->block - 1) / log->header->block;
+    uint64_t lo = 0, hi = blocks, mid;
+    uint64_t pos;
+
+    /* Find the last block starting at or before the time. */
+    while(hi - lo > 1) {
+        mid = (lo + hi) / 2;
+        if(log->index[mid] <= timestamp_ns)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    for(pos = lo * log->header->block; pos < log->count; pos++) {
+        if(log->records[pos].timestamp_ns >= timestamp_ns)
+            break;
+    }
+
+    return pos;
+}
@@ -0,0 +1,189 @@
+/**
+ * \file recorder.h
+ * \date 16 October 2026
+ * \brief File containing the binary trace recorder of the sent and received CAN frames.
+ *
+ * This file contains the function declarations for recording every sent and received frame, the joystick events and the
+ * control ticks into a preallocated, memory-mapped log file, and for reading such a log back.
+ *
+ * The log file is laid out as:
+ * \code
+ * RecorderHeader                               (RECORDER_HEADER_SIZE bytes)
+ * uint64_t index[capacity / RECORDER_BLOCK]    (the timestamp of the first record of every block, page aligned)
+ * RecorderRecord records[capacity]             (fixed size records, in the order they were claimed)
+ * \endcode
+ * Writers claim records with one atomic add on the count in the header, so recording is lock-free and never makes a system call.
+ * When the log is full, new records are dropped.
+ */
+
+#ifndef RECORDER
+#define RECORDER
+    #include <stdint.h>
+    #include <stddef.h>
+    #include <stdatomic.h>
+    #include "canFrame.h"
+    #include "frameArena.h"
+
+    #define RECORDER_MAGIC          "DCTRACE"   //!< The first bytes of a log file.
+    #define RECORDER_VERSION        1           //!< The version of the log format.
+    #define RECORDER_HEADER_SIZE    4096        //!< The size of the header, one page.
+    #define RECORDER_BLOCK          4096        //!< The number of records per index block.
+
+    /**
+     * \brief Defines the kind of a record.
+     */
+    typedef enum {
+        RECORD_EMPTY = 0,   //!< The record was claimed but not written (yet).
+        RECORD_TX,          //!< A frame that was sent.
+        RECORD_RX,          //!< A frame that was received.
+        RECORD_JS,          //!< A joystick event, the data is a JoystickEvent.
+        RECORD_TICK,        //!< The start of a control tick.
+        RECORD_DROPPED      //!< The start of a control tick of which the frames were not sent.
+    } RecordKind;
+
+    /**
+     * \brief Defines one record of the log, 32 bytes.
+     */
+    typedef struct {
+        uint64_t timestamp_ns;  //!< The CLOCK_MONOTONIC time of the event, in ns.
+        uint32_t tick;          //!< The counter of the control tick the record belongs to.
+        uint16_t ID;            //!< The CAN ID of the frame.
+        uint8_t kind;           //!< The RecordKind, written last.
+        uint8_t bus;            //!< The bus of the frame.
+        uint8_t length;         //!< The number of valid data bytes.
+        uint8_t flags;          //!< The CAN_RX_ flags of a received frame.
+        uint16_t device_time;   //!< The timestamp of the CAN device of a received frame.
+        uint8_t data[8];        //!< The data of the frame or event.
+        uint32_t reserved;      //!< Always 0.
+    } RecorderRecord;
+
+    /**
+     * \brief Defines the header at the start of a log file.
+     */
+    typedef struct {
+        char magic[8];                  //!< RECORDER_MAGIC.
+        uint32_t version;               //!< RECORDER_VERSION.
+        uint32_t record_size;           //!< sizeof(RecorderRecord).
+        uint64_t capacity;              //!< The number of records the file was created for.
+        uint32_t block;                 //!< The number of records per index block.
+        uint32_t tick_us;               //!< The period of the control tick in microseconds, 0 if not known.
+        uint64_t index_offset;          //!< The file offset of the index.
+        uint64_t records_offset;        //!< The file offset of the first record.
+        _Atomic uint64_t count;         //!< The number of claimed records, can be larger than the capacity.
+        uint64_t start_monotonic_ns;    //!< The CLOCK_MONOTONIC time the log was created.
+        uint64_t start_realtime_ns;     //!< The CLOCK_REALTIME time the log was created.
+    } RecorderHeader;
+
+    /**
+     * \brief Defines a log that is being recorded.
+     *
+     * All record functions do nothing when the recorder is not opened, so they can be called unconditionally.
+     */
+    typedef struct {
+        int fd;                         //!< The file descriptor of the log, -1 when not opened.
+        uint8_t *map;                   //!< The mapping of the whole file.
+        size_t size;                    //!< The size of the mapping.
+        RecorderHeader *header;         //!< The header of the log.
+        uint64_t *index;                //!< The index of the log.
+        RecorderRecord *records;        //!< The records of the log.
+        uint64_t capacity;              //!< The number of records in the file.
+        uint32_t tick;                  //!< The counter of the current control tick, see recorder_tick().
+    } Recorder;
+
+    /**
+     * \brief Defines a log that is opened for reading.
+     */
+    typedef struct {
+        const uint8_t *map;             //!< The read-only mapping of the whole file.
+        size_t size;                    //!< The size of the mapping.
+        const RecorderHeader *header;   //!< The header of the log.
+        const uint64_t *index;          //!< The index of the log.
+        const RecorderRecord *records;  //!< The records of the log.
+        uint64_t count;                 //!< The number of records in the log.
+    } RecorderLog;
+
+    /**
+     * \fn int recorder_open(Recorder *r, const char *path, uint64_t capacity, uint32_t tick_us)
+     * \brief Create a log file with room for capacity records and map it.
+     * \param r Pointer to Recorder struct.
+     * \param path The path of the log file, it is overwritten.
+     * \param capacity The number of records, rounded up to a whole block.
+     * \param tick_us The period of the control tick in microseconds, so a replay runs at the same rate. 0 if not known.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void recorder_close(Recorder *r)
+     * \brief Finish the log, shrink the file to the recorded part and unmap it.
+     * \param r Pointer to Recorder struct.
+     *
+     * \fn void recorder_frames(Recorder *r, RecordKind kind, const CANFrame frames[], int length, uint64_t timestamp_ns)
+     * \brief Record frames that share one timestamp, for example all frames sent in one tick.
+     * \param r Pointer to Recorder struct.
+     * \param kind RECORD_TX or RECORD_RX.
+     * \param frames The frames to record.
+     * \param length The number of frames.
+     * \param timestamp_ns The CLOCK_MONOTONIC time of the frames.
+     *
+     * \fn void recorder_arena(Recorder *r, RecordKind kind, const FrameArena *a, uint64_t timestamp_ns)
+     * \brief Record the frames of an arena that share one timestamp, like recorder_frames().
+     * \param r Pointer to Recorder struct.
+     * \param kind RECORD_TX or RECORD_RX.
+     * \param a The arena with the frames.
+     * \param timestamp_ns The CLOCK_MONOTONIC time of the frames.
+     *
+     * \fn void recorder_rx(Recorder *r, const CANRxFrame *rx)
+     * \brief Record a received frame with its own timestamp.
+     * \param r Pointer to Recorder struct.
+     * \param rx The received frame.
+     *
+     * \fn void recorder_event(Recorder *r, RecordKind kind, const void *data, uint8_t length, uint64_t timestamp_ns)
+     * \brief Record an event that is not a CAN frame.
+     * \param r Pointer to Recorder struct.
+     * \param kind The kind of the event.
+     * \param data The data of the event, up to 8 bytes.
+     * \param length The number of bytes of data.
+     * \param timestamp_ns The CLOCK_MONOTONIC time of the event.
+     *
+     * \fn void recorder_tick(Recorder *r, RecordKind kind, uint32_t tick, uint64_t timestamp_ns)
+     * \brief Record the start of a control tick. All following records belong to this tick.
+     * \param r Pointer to Recorder struct.
+     * \param kind RECORD_TICK or RECORD_DROPPED.
+     * \param tick The counter of the control tick.
+     * \param timestamp_ns The CLOCK_MONOTONIC time the tick started.
+     *
+     * \fn uint64_t recorder_dropped(const Recorder *r)
+     * \brief Get the number of records that did not fit in the log.
+     * \param r Pointer to Recorder struct.
+     * \return The number of dropped records.
+     *
+     * \fn int recorder_load(RecorderLog *log, const char *path)
+     * \brief Map a log file for reading.
+     * \param log Pointer to RecorderLog struct.
+     * \param path The path of the log file.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void recorder_unload(RecorderLog *log)
+     * \brief Unmap a log file.
+     * \param log Pointer to RecorderLog struct.
+     *
+     * \fn uint64_t recorder_seek(const RecorderLog *log, uint64_t timestamp_ns)
+     * \brief Find the first record at or after a time, using the index.
+     * \param log Pointer to RecorderLog struct.
+     * \param timestamp_ns The CLOCK_MONOTONIC time to look for.
+     * \return The number of the record, log->count if there is none.
+     */
+
+    int recorder_open(Recorder *r, const char *path, uint64_t capacity, uint32_t tick_us);
+    void recorder_close(Recorder *r);
+    void recorder_frames(Recorder *r, RecordKind kind, const CANFrame frames[], int length, uint64_t timestamp_ns);
+    void recorder_arena(Recorder *r, RecordKind kind, const FrameArena *a, uint64_t timestamp_ns);
+    void recorder_rx(Recorder *r, const CANRxFrame *rx);
+    void recorder_event(Recorder *r, RecordKind kind, const void *data, uint8_t length, uint64_t timestamp_ns);
+    void recorder_tick(Recorder *r, RecordKind kind, uint32_t tick, uint64_t timestamp_ns);
+    uint64_t recorder_dropped(const Recorder *r);
+
+    int recorder_load(RecorderLog *log, const char *path);
+    void recorder_unload(RecorderLog *log);
+    uint64_t recorder_seek(const RecorderLog *log, uint64_t timestamp_ns);
+#endif
@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "replay.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+void replay_setup(Replay *rp, Control *c, FrameArena *a, CANCache *cache, Recorder *out) {
+    memset(rp, 0, sizeof(Replay));
+    rp->control = c;
+    rp->generated = a;
+    rp->cache = cache;
+    rp->out = out;
+}
+
+static int frames_equal(const CANFrame *a, const CANFrame *b) {
+    return a->ID == b->ID && a->bus == b->bus && a->length == b->length &&
+           memcmp(a->data, b->data, a->length <= 8 ? a->length : 8) == 0;
+}
+
+/* Compare the frames of the finished tick. */
+static void replay_compare(Replay *rp) {
+    int length = (rp->nrGenerated < rp->nrExpected) ? rp->nrGenerated : rp->nrExpected;
+    CANFrame generated;
+    int i;
+
+    for(i = 0; i < length; i++) {
+        arena_get(rp->generated, i, &generated);
+        if(!frames_equal(&generated, &rp->expected[i]))
+            break;
+    }
+
+    if(i != length || rp->nrGenerated != rp->nrExpected) {
+        if(rp->stats.mismatches < REPLAY_MAX_REPORTS) {
+            terminalColor(31);
+            printf("Tick %u: %d frames sent, %d generated, first difference at frame %d", rp->tick, rp->nrExpected, rp->nrGenerated, i);
+            if(i < rp->nrExpected)
+                printf(" (ID 0x%03X)", rp->expected[i].ID);
+            printf("\n");
+            terminalColor(0);
+        }
+        rp->stats.mismatches++;
+    }
+
+    rp->stats.generated += rp->nrGenerated;
+    rp->stats.expected += rp->nrExpected;
+    rp->inTick = 0;
+}
+
+static void replay_record(Replay *rp, const RecorderRecord *rec) {
+    JoystickEvent event;
+    CANRxFrame rx;
+
+    rp->now_ns = rec->timestamp_ns;
+
+    switch(rec->kind) {
+        case RECORD_TICK:
+        case RECORD_DROPPED:
+            if(rp->inTick)
+                replay_compare(rp);
+
+            rp->tick = rec->tick;
+            rp->control->count = rec->tick;
+            arena_reset(rp->generated);
+            rp->nrGenerated = control_tick(rp->control, &rp->js, rp->generated);
+            rp->nrExpected = 0;
+            rp->stats.ticks++;
+
+            /* The frames of a dropped tick were never sent, the tick only keeps the control law in step. */
+            if(rec->kind == RECORD_DROPPED) {
+                rp->stats.dropped++;
+                if(rp->out != NULL)
+                    recorder_tick(rp->out, RECORD_DROPPED, rp->tick, rp->now_ns);
+                break;
+            }
+
+            rp->inTick = 1;
+            if(rp->out != NULL) {
+                recorder_tick(rp->out, RECORD_TICK, rp->tick, rp->now_ns);
+                recorder_arena(rp->out, RECORD_TX, rp->generated, rp->now_ns);
+            }
+            break;
+        case RECORD_TX:
+            if(rp->inTick && rp->nrExpected < CONTROL_MAX_FRAMES) {
+                memset(&rp->expected[rp->nrExpected], 0, sizeof(CANFrame));
+                rp->expected[rp->nrExpected].ID = rec->ID;
+                rp->expected[rp->nrExpected].bus = rec->bus;
+                rp->expected[rp->nrExpected].length = rec->length;
+                memcpy(rp->expected[rp->nrExpected].data, rec->data, 8);
+                rp->nrExpected++;
+            }
+            break;
+        case RECORD_RX:
+            if(rp->cache != NULL) {
+                memset(&rx, 0, sizeof(CANRxFrame));
+                rx.frame.ID = rec->ID;
+                rx.frame.bus = rec->bus;
+                rx.frame.length = rec->length;
+                memcpy(rx.frame.data, rec->data, 8);
+                rx.device_time = rec->device_time;
+                rx.flags = rec->flags;
+                rx.timestamp_ns = rec->timestamp_ns;
+                cancache_update(rp->cache, &rx);
+            }
+            rp->stats.rx++;
+            break;
+        case RECORD_JS:
+            memcpy(&event, rec->data, sizeof(JoystickEvent));
+            updateJoystick(&rp->js, &event);
+            rp->stats.js++;
+            break;
+        default:
+            /* Records that were never written, the drive stopped while recording them. */
+            break;
+    }
+}
+
+int replay_run(Replay *rp, const RecorderLog *log) {
+    for(uint64_t i = 0; i < log->count; i++) {
+        if(i == 0)
+            rp->stats.first_ns = log->records[i].timestamp_ns;
+        replay_record(rp, &log->records[i]);
+        rp->stats.records++;
+    }
+
+    if(rp->inTick)
+        replay_compare(rp);
+    rp->stats.last_ns = rp->now_ns;
+
+    return rp->stats.mismatches;
+}
+
+void replay_print_stats(const Replay *rp) {
+    const ReplayStats *st = &rp->stats;
+
+    printf("Replay records: %llu  Ticks: %llu (%llu dropped)  RX: %llu  Joystick: %llu  Frames sent/generated: %llu/%llu  Duration: %.1f s\n",
+           (unsigned long long)st->records, (unsigned long long)st->ticks, (unsigned long long)st->dropped,
+           (unsigned long long)st->rx, (unsigned long long)st->js,
+           (unsigned long long)st->expected, (unsigned long long)st->generated,
+           (st->last_ns - st->first_ns) / 1e9);
+
+    if(st->mismatches == 0) {
+        terminalColor(32);
+        printf("All ticks identical\n");
+    } else {
+        terminalColor(31);
+        printf("%llu ticks differ\n", (unsigned long long)st->mismatches);
+    }
+    terminalColor(0);
+}
@@ -0,0 +1,79 @@
+/**
+ * \file replay.h
+ * \date 16 October 2026
+ * \brief File containing the offline replay of recorded logs through the control law.
+ *
+ * This file contains the function declarations for feeding the joystick events and received frames of a log into the control law,
+ * as well as the definition of the Replay struct. Time is taken from the records (a virtual clock), so a replay runs as fast as
+ * the control law allows and always gives the same result. The frames of every tick are compared with the frames sent during the drive.
+ */
+
+#ifndef REPLAY
+#define REPLAY
+    #include <stdint.h>
+    #include "canFrame.h"
+    #include "canCache.h"
+    #include "joystick.h"
+    #include "control.h"
+    #include "recorder.h"
+
+    #define REPLAY_MAX_REPORTS 10   //!< The number of differing ticks that are printed.
+
+    /**
+     * \brief Contains the results of a replay.
+     */
+    typedef struct {
+        uint64_t records;       //!< The number of records read.
+        uint64_t ticks;         //!< The number of ticks replayed.
+        uint64_t dropped;       //!< The number of replayed ticks of which the frames were not sent, so not compared.
+        uint64_t rx;            //!< The number of received frames fed to the cache.
+        uint64_t js;            //!< The number of joystick events applied.
+        uint64_t generated;     //!< The number of frames generated by the control law.
+        uint64_t expected;      //!< The number of frames sent during the drive.
+        uint64_t mismatches;    //!< The number of ticks of which the frames differ.
+        uint64_t first_ns;      //!< The virtual time of the first record.
+        uint64_t last_ns;       //!< The virtual time of the last record.
+    } ReplayStats;
+
+    /**
+     * \brief Defines a replay of a log.
+     */
+    typedef struct {
+        Control *control;                           //!< The control law to drive.
+        Joystick js;                                //!< The joystick, only updated from the log.
+        CANCache *cache;                            //!< The cache to put the received frames in, NULL if not used.
+        Recorder *out;                              //!< The log to record the generated frames to, NULL if not used.
+        uint64_t now_ns;                            //!< The virtual clock, the time of the current record.
+        uint32_t tick;                              //!< The counter of the current tick.
+        uint8_t inTick;                             //!< Has a tick been replayed whose frames are not compared yet?
+        FrameArena *generated;                      //!< The frames of the current tick from the control law.
+        int nrGenerated;                            //!< The number of generated frames.
+        CANFrame expected[CONTROL_MAX_FRAMES];      //!< The frames of the current tick from the log.
+        int nrExpected;                             //!< The number of expected frames.
+        ReplayStats stats;                          //!< The results of the replay.
+    } Replay;
+
+    /**
+     * \fn void replay_setup(Replay *rp, Control *c, FrameArena *a, CANCache *cache, Recorder *out)
+     * \brief Setup a replay.
+     * \param rp Pointer to Replay struct.
+     * \param c The control law to drive, set up with the same options as during the drive.
+     * \param a The arena to build the frames of a tick in.
+     * \param cache The cache to put the received frames in, NULL if not used.
+     * \param out The log to record the generated frames to, NULL if not used.
+     *
+     * \fn int replay_run(Replay *rp, const RecorderLog *log)
+     * \brief Replay a complete log.
+     * \param rp Pointer to Replay struct.
+     * \param log The log to replay.
+     * \return The number of ticks of which the frames differ from the log.
+     *
+     * \fn void replay_print_stats(const Replay *rp)
+     * \brief Print the results of the replay.
+     * \param rp Pointer to Replay struct.
+     */
+
+    void replay_setup(Replay *rp, Control *c, FrameArena *a, CANCache *cache, Recorder *out);
+    int replay_run(Replay *rp, const RecorderLog *log);
+    void replay_print_stats(const Replay *rp);
+#endif
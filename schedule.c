@@ -0,0 +1,164 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "schedule.h"
+
+#define SCHEDULE_MAX_TICKS 65536    //!< The schedule of the frame periods alone may not be longer than this.
+
+static uint64_t gcd(uint64_t a, uint64_t b) {
+    while(b != 0) {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+static uint64_t lcm(uint64_t a, uint64_t b) {
+    return a / gcd(a, b) * b;
+}
+
+static uint8_t counter_value(const CounterRule *c, uint8_t templ, uint32_t count) {
+    return templ + ((((count / c->div) % c->mod) + c->add) << c->shift);
+}
+
+int schedule_compile(Schedule *s, const ScheduleEntry entries[], int length, ChecksumFunction checksum) {
+    uint64_t hyperperiod = 1;
+    uint64_t period;
+    uint32_t nrFrames = 0;
+    uint32_t nrPatches = 0;
+    uint32_t n = 0;
+    uint32_t np = 0;
+    uint8_t *baked;
+    CANFrame frame;
+
+    memset(s, 0, sizeof(Schedule));
+    s->checksum = checksum;
+
+    for(int i = 0; i < length; i++) {
+        if(entries[i].frame.freq == 0)
+            return -1;
+        if(entries[i].hasCounter && (entries[i].counter.div == 0 || entries[i].counter.mod == 0))
+            return -1;
+
+        hyperperiod = lcm(hyperperiod, entries[i].frame.freq);
+        if(hyperperiod > SCHEDULE_MAX_TICKS)
+            return -1;
+    }
+
+    /* Stretch the schedule over the counters, as long as it stays small. */
+    for(int i = 0; i < length; i++) {
+        if(!entries[i].hasCounter)
+            continue;
+
+        period = lcm(hyperperiod, (uint64_t)entries[i].counter.div * entries[i].counter.mod);
+        if(period <= SCHEDULE_MAX_HYPERPERIOD)
+            hyperperiod = period;
+    }
+    s->hyperperiod = hyperperiod;
+
+    baked = calloc(length > 0 ? length : 1, sizeof(uint8_t));
+    if(baked == NULL)
+        return -1;
+
+    for(int i = 0; i < length; i++) {
+        period = (uint64_t)entries[i].counter.div * entries[i].counter.mod;
+        baked[i] = !entries[i].hasCounter || (hyperperiod % period == 0);
+
+        nrFrames += hyperperiod / entries[i].frame.freq;
+        if(!baked[i])
+            nrPatches += hyperperiod / entries[i].frame.freq;
+    }
+
+    s->frames = aligned_alloc(64, (((nrFrames > 0 ? nrFrames : 1) * ARENA_FRAME_SIZE) + 63) & ~(size_t)63);
+    s->first = calloc(hyperperiod + 1, sizeof(uint32_t));
+    s->patches = calloc(nrPatches > 0 ? nrPatches : 1, sizeof(SchedulePatch));
+    s->firstPatch = calloc(hyperperiod + 1, sizeof(uint32_t));
+    if(s->frames == NULL || s->first == NULL || s->patches == NULL || s->firstPatch == NULL) {
+        free(baked);
+        schedule_free(s);
+        return -1;
+    }
+
+    for(uint32_t t = 0; t < hyperperiod; t++) {
+        s->first[t] = n;
+        s->firstPatch[t] = np;
+
+        for(int i = 0; i < length; i++) {
+            if(t % entries[i].frame.freq != 0)
+                continue;
+
+            frame = entries[i].frame;
+            if(entries[i].hasCounter && baked[i]) {
+                frame.data[entries[i].counter.byte] = counter_value(&entries[i].counter,
+                                                                    frame.data[entries[i].counter.byte], t);
+                if(entries[i].checksum)
+                    checksum(&frame);
+            } else if(entries[i].hasCounter) {
+                s->patches[np].slot = n - s->first[t];
+                s->patches[np].checksum = entries[i].checksum;
+                s->patches[np].templ = frame.data[entries[i].counter.byte];
+                s->patches[np].counter = entries[i].counter;
+                np++;
+            } else if(entries[i].checksum) {
+                checksum(&frame);
+            }
+
+            arena_pack(&s->frames[n * ARENA_FRAME_SIZE], &frame);
+            n++;
+        }
+    }
+    s->first[hyperperiod] = n;
+    s->firstPatch[hyperperiod] = np;
+
+    free(baked);
+    return 0;
+}
+
+int schedule_emit(const Schedule *s, FrameArena *a, uint32_t count) {
+    uint32_t t = count % s->hyperperiod;
+    uint32_t length = s->first[t + 1] - s->first[t];
+    int first = a->length;
+    const SchedulePatch *patch;
+    CANFrame frame;
+
+    if(arena_append(a, &s->frames[s->first[t] * ARENA_FRAME_SIZE], length) < 0)
+        return 0;
+
+    /* The checksum functions work on a CANFrame, patches are rare so the frame is unpacked. */
+    for(uint32_t i = s->firstPatch[t]; i < s->firstPatch[t + 1]; i++) {
+        patch = &s->patches[i];
+        arena_get(a, first + patch->slot, &frame);
+
+        frame.data[patch->counter.byte] = counter_value(&patch->counter, patch->templ, count);
+        if(patch->checksum)
+            s->checksum(&frame);
+        memcpy(arena_data(a, first + patch->slot), frame.data, 8);
+    }
+
+    return length;
+}
+
+int schedule_max_frames(const Schedule *s) {
+    uint32_t max = 0;
+
+    for(uint32_t t = 0; t < s->hyperperiod; t++) {
+        if(s->first[t + 1] - s->first[t] > max)
+            max = s->first[t + 1] - s->first[t];
+    }
+
+    return max;
+}
+
+void schedule_free(Schedule *s) {
+    free(s->frames);
+    free(s->first);
+    free(s->patches);
+    free(s->firstPatch);
+    s->frames = NULL;
+    s->first = NULL;
+    s->patches = NULL;
+    s->firstPatch = NULL;
+}
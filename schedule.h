@@ -0,0 +1,108 @@
+/**
+ * \file schedule.h
+ * \date 16 October 2026
+ * \brief File containing the precomputed send schedule of the static CAN frames.
+ *
+ * This file contains the function declarations for compiling a list of periodic frames into a table with the
+ * ready to send frames of every tick, as well as the definition of the Schedule struct. The frames are stored in the
+ * format of the FrameArena, so a tick is added to the arena with one copy.
+ */
+
+#ifndef SCHEDULE
+#define SCHEDULE
+    #include <stdint.h>
+    #include "canFrame.h"
+    #include "frameArena.h"
+
+    #define SCHEDULE_MAX_HYPERPERIOD 4096   //!< Counters with a longer period are patched every tick instead of precomputed.
+
+    /**
+     * \brief Function that calculates the checksum of a frame and writes it in the frame.
+     */
+    typedef uint16_t (*ChecksumFunction)(CANFrame *frame);
+
+    /**
+     * \brief Defines a rolling counter in a byte of a frame.
+     *
+     * The byte becomes: template + ((((count / div) % mod) + add) << shift)
+     */
+    typedef struct {
+        uint8_t byte;       //!< The data byte of the counter.
+        uint16_t div;       //!< The number of ticks per counter step.
+        uint16_t mod;       //!< The number of counter steps before it rolls over.
+        uint8_t add;        //!< The value added to the counter.
+        uint8_t shift;      //!< The number of bits the counter is shifted left.
+    } CounterRule;
+
+    /**
+     * \brief Defines a periodic static frame.
+     *
+     * The freq of the frame is its period in ticks.
+     */
+    typedef struct {
+        CANFrame frame;         //!< The frame, with the data as template for the counter.
+        uint8_t hasCounter;     //!< Does the frame contain a rolling counter?
+        CounterRule counter;    //!< The rolling counter of the frame.
+        uint8_t checksum;       //!< Is the checksum recalculated after the counter is set?
+    } ScheduleEntry;
+
+    /**
+     * \brief Defines a byte that has to be set on every send, because it can not be precomputed.
+     */
+    typedef struct {
+        uint16_t slot;          //!< The index of the frame in the frames of the tick.
+        uint8_t checksum;       //!< Recalculate the checksum after setting the counter.
+        uint8_t templ;          //!< The template value of the byte.
+        CounterRule counter;    //!< The counter to write.
+    } SchedulePatch;
+
+    /**
+     * \brief Defines a compiled schedule.
+     *
+     * The frames of tick t are frame first[t] up to frame first[t + 1] in frames, with the patches
+     * patches[firstPatch[t]] up to patches[firstPatch[t + 1]].
+     */
+    typedef struct {
+        uint32_t hyperperiod;       //!< The number of ticks after which the schedule repeats.
+        uint8_t *frames;            //!< The precomputed frames of all ticks, ARENA_FRAME_SIZE bytes each.
+        uint32_t *first;            //!< The index of the first frame of every tick.
+        SchedulePatch *patches;     //!< The bytes to set on every send.
+        uint32_t *firstPatch;       //!< The index of the first patch of every tick.
+        ChecksumFunction checksum;  //!< The checksum used by the patches.
+    } Schedule;
+
+    /**
+     * \fn int schedule_compile(Schedule *s, const ScheduleEntry entries[], int length, ChecksumFunction checksum)
+     * \brief Compile the static frames into a schedule.
+     *
+     * The schedule covers the least common multiple of all periods. Counters whose period fits in
+     * SCHEDULE_MAX_HYPERPERIOD are precomputed (checksum included), all other counters become patches.
+     * \param s Pointer to Schedule struct.
+     * \param entries The static frames, in the order they are sent within a tick.
+     * \param length The number of static frames.
+     * \param checksum The checksum function of the frames.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int schedule_emit(const Schedule *s, FrameArena *a, uint32_t count)
+     * \brief Add the frames of a tick, all or none.
+     * \param s Pointer to Schedule struct.
+     * \param a The arena to add the messages to.
+     * \param count The counter of the program.
+     * \return Number of messages added, 0 if they did not fit.
+     *
+     * \fn int schedule_max_frames(const Schedule *s)
+     * \brief Get the highest number of frames that is added in one tick.
+     * \param s Pointer to Schedule struct.
+     * \return The maximum number of frames per tick.
+     *
+     * \fn void schedule_free(Schedule *s)
+     * \brief Free the tables of the schedule.
+     * \param s Pointer to Schedule struct.
+     */
+
+    int schedule_compile(Schedule *s, const ScheduleEntry entries[], int length, ChecksumFunction checksum);
+    int schedule_emit(const Schedule *s, FrameArena *a, uint32_t count);
+    int schedule_max_frames(const Schedule *s);
+    void schedule_free(Schedule *s);
+#endif
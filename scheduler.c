@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/timerfd.h>
+
+#include "scheduler.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+#define NSEC_PER_SEC 1000000000LL
+
+static int64_t timespec_diff_ns(const struct timespec *a, const struct timespec *b) {
+    return (a->tv_sec - b->tv_sec) * NSEC_PER_SEC + (a->tv_nsec - b->tv_nsec);
+}
+
+static void timespec_add_ns(struct timespec *t, int64_t ns) {
+    t->tv_sec  += ns / NSEC_PER_SEC;
+    t->tv_nsec += ns % NSEC_PER_SEC;
+    if(t->tv_nsec >= NSEC_PER_SEC) {
+        t->tv_nsec -= NSEC_PER_SEC;
+        t->tv_sec++;
+    }
+}
+
+int scheduler_setup(Scheduler *s, uint32_t period_us) {
+    memset(s, 0, sizeof(Scheduler));
+    s->timer_fd = -1;
+
+    if(period_us == 0)
+        return -1;
+
+    s->period_ns = period_us * 1000;
+    if(clock_gettime(CLOCK_MONOTONIC, &s->deadline) < 0)
+        return -1;
+
+    timespec_add_ns(&s->deadline, s->period_ns);
+
+    return 0;
+}
+
+int scheduler_wait(Scheduler *s) {
+    struct timespec now;
+    int ret;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if(timespec_diff_ns(&now, &s->deadline) >= 0) {
+        /* The previous tick is still running past its deadline. */
+        s->overruns++;
+    } else {
+        ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &s->deadline, NULL);
+        if(ret != 0)
+            return -ret;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    }
+
+    return scheduler_account(s, &now);
+}
+
+int scheduler_account(Scheduler *s, const struct timespec *now) {
+    int64_t late = timespec_diff_ns(now, &s->deadline);
+    int64_t skipped = 0;
+
+    if(late >= (int64_t)s->period_ns) {
+        /* Drop the deadlines that already passed, but stay on the grid. */
+        skipped = late / s->period_ns;
+        s->missed += skipped;
+        late -= skipped * s->period_ns;
+    }
+
+    s->last_late_ns = late;
+    if(late > s->max_late_ns)
+        s->max_late_ns = late;
+    s->sum_late_ns += late;
+
+    s->ticks += skipped + 1;
+    s->executed++;
+    timespec_add_ns(&s->deadline, (skipped + 1) * s->period_ns);
+
+    return (int)(skipped + 1);
+}
+
+int scheduler_timer_create(Scheduler *s) {
+    struct itimerspec spec;
+
+    s->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if(s->timer_fd < 0)
+        return -1;
+
+    spec.it_value = s->deadline;
+    spec.it_interval.tv_sec  = s->period_ns / NSEC_PER_SEC;
+    spec.it_interval.tv_nsec = s->period_ns % NSEC_PER_SEC;
+    if(timerfd_settime(s->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) < 0) {
+        close(s->timer_fd);
+        s->timer_fd = -1;
+        return -1;
+    }
+
+    return s->timer_fd;
+}
+
+int scheduler_timer_read(Scheduler *s) {
+    struct timespec now;
+    uint64_t expirations;
+
+    if(read(s->timer_fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+        return (errno == EAGAIN) ? 0 : -1;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    /* More than one expiration means the previous tick ran past a deadline. */
+    if(expirations > 1)
+        s->overruns++;
+
+    return scheduler_account(s, &now);
+}
+
+void scheduler_close(Scheduler *s) {
+    if(s->timer_fd >= 0)
+        close(s->timer_fd);
+    s->timer_fd = -1;
+}
+
+int scheduler_enable_realtime(int priority) {
+    struct sched_param param;
+
+    if(mlockall(MCL_CURRENT | MCL_FUTURE) < 0) {
+        terminalColor(31);
+        printf("Could not lock memory: %s\n", strerror(errno));
+        terminalColor(0);
+        return -1;
+    }
+
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+    if(sched_setscheduler(0, SCHED_FIFO, &param) < 0) {
+        terminalColor(31);
+        printf("Could not set SCHED_FIFO: %s\n", strerror(errno));
+        terminalColor(0);
+        return -1;
+    }
+
+    terminalColor(32);
+    printf("Real-time mode enabled\n");
+    terminalColor(0);
+
+    return 0;
+}
+
+void scheduler_print_stats(Scheduler *s) {
+    printf("Ticks: %llu  Executed: %llu  Overruns: %llu  Missed: %llu  Late avg/max: %lld/%lld us\n",
+           (unsigned long long)s->ticks, (unsigned long long)s->executed,
+           (unsigned long long)s->overruns, (unsigned long long)s->missed,
+           (long long)(s->executed ? (s->sum_late_ns / (int64_t)s->executed) / 1000 : 0),
+           (long long)(s->max_late_ns / 1000));
+}
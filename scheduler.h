@@ -0,0 +1,91 @@
+/**
+ * \file scheduler.h
+ * \date 16 October 2026
+ * \brief File containing the periodic tick scheduler of the control loop.
+ *
+ * This file contains the function declarations for running the control loop on fixed, absolute
+ * CLOCK_MONOTONIC deadlines, as well as the definition of the Scheduler struct.
+ */
+
+#ifndef SCHEDULER
+#define SCHEDULER
+    #include <stdint.h>
+    #include <time.h>
+
+    /**
+     * \brief Defines a periodic scheduler with absolute deadlines.
+     *
+     * Deadlines are kept on a fixed grid (start + n * period), so the tick never drifts,
+     * even when a single tick runs late. Deadlines that have already passed completely are skipped
+     * and counted as missed instead of being run back to back.
+     */
+    typedef struct {
+        struct timespec deadline;   //!< The absolute CLOCK_MONOTONIC time of the next tick.
+        uint32_t period_ns;         //!< The period of the tick in nanoseconds.
+        uint64_t ticks;             //!< The number of deadlines passed since the start, including missed ones.
+        uint64_t executed;          //!< The number of ticks that were actually run.
+        uint64_t overruns;          //!< The number of ticks that were still running when the next deadline passed.
+        uint64_t missed;            //!< The number of deadlines that were skipped because of an overrun.
+        int64_t last_late_ns;       //!< How late the last tick was woken up.
+        int64_t max_late_ns;        //!< The worst wake-up lateness seen.
+        int64_t sum_late_ns;        //!< The sum of all wake-up latenesses, to calculate the mean.
+        int timer_fd;               //!< The timerfd firing on the deadlines, -1 when not used.
+    } Scheduler;
+
+    /**
+     * \fn int scheduler_setup(Scheduler *s, uint32_t period_us)
+     * \brief Setup the scheduler. The first deadline is one period from now.
+     * \param s Pointer to Scheduler struct.
+     * \param period_us The period of the tick in microseconds.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int scheduler_wait(Scheduler *s)
+     * \brief Sleep until the next deadline.
+     * \param s Pointer to Scheduler struct.
+     * \return >0: The number of periods since the previous tick (1 unless deadlines were missed)
+     * \return <0: Interrupted by a signal, the deadline is not consumed.
+     *
+     * \fn int scheduler_account(Scheduler *s, const struct timespec *now)
+     * \brief Account a tick that was woken up at now, and move the deadline to the next period.
+     * \param s Pointer to Scheduler struct.
+     * \param now The CLOCK_MONOTONIC time the tick was started.
+     * \return The number of periods since the previous tick.
+     *
+     * \fn int scheduler_timer_create(Scheduler *s)
+     * \brief Create a timerfd that becomes readable on every deadline, to use the scheduler from an event loop.
+     * \param s Pointer to Scheduler struct.
+     * \return >=0: The file descriptor of the timer
+     * \return <0: Fail
+     *
+     * \fn int scheduler_timer_read(Scheduler *s)
+     * \brief Consume the expirations of the timerfd and account the tick.
+     * \param s Pointer to Scheduler struct.
+     * \return >0: The number of periods since the previous tick
+     * \return 0: The timer did not expire yet
+     * \return <0: Fail
+     *
+     * \fn void scheduler_close(Scheduler *s)
+     * \brief Close the timerfd of the scheduler, if any.
+     * \param s Pointer to Scheduler struct.
+     *
+     * \fn int scheduler_enable_realtime(int priority)
+     * \brief Lock all memory and run the calling thread with the SCHED_FIFO policy.
+     * \param priority The SCHED_FIFO priority (1-99).
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void scheduler_print_stats(Scheduler *s)
+     * \brief Print the tick statistics of the scheduler.
+     * \param s Pointer to Scheduler struct.
+     */
+
+    int scheduler_setup(Scheduler *s, uint32_t period_us);
+    int scheduler_wait(Scheduler *s);
+    int scheduler_account(Scheduler *s, const struct timespec *now);
+    int scheduler_timer_create(Scheduler *s);
+    int scheduler_timer_read(Scheduler *s);
+    void scheduler_close(Scheduler *s);
+    int scheduler_enable_realtime(int priority);
+    void scheduler_print_stats(Scheduler *s);
+#endif
@@ -0,0 +1,70 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "spscQueue.h"
+
+int spsc_setup(SpscQueue *q, uint32_t capacity, uint32_t item_size) {
+    uint32_t size = 1;
+
+    while(size < capacity)
+        size <<= 1;
+
+    /* Every item starts on its own cache line, so the two threads never share one. */
+    q->item_size = (item_size + 63) & ~63u;
+    q->items = aligned_alloc(64, (size_t)size * q->item_size);
+    if(q->items == NULL)
+        return -1;
+
+    q->mask = size - 1;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->tail_cache = 0;
+    q->head_cache = 0;
+    q->full = 0;
+
+    return 0;
+}
+
+void spsc_free(SpscQueue *q) {
+    free(q->items);
+    q->items = NULL;
+}
+
+void *spsc_claim(SpscQueue *q) {
+    uint64_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    if(head - q->tail_cache > q->mask) {
+        q->tail_cache = atomic_load_explicit(&q->tail, memory_order_acquire);
+        if(head - q->tail_cache > q->mask) {
+            q->full++;
+            return NULL;
+        }
+    }
+
+    return q->items + (size_t)(head & q->mask) * q->item_size;
+}
+
+void spsc_push(SpscQueue *q) {
+    uint64_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+}
+
+void *spsc_front(SpscQueue *q) {
+    uint64_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+    if(tail == q->head_cache) {
+        q->head_cache = atomic_load_explicit(&q->head, memory_order_acquire);
+        if(tail == q->head_cache)
+            return NULL;
+    }
+
+    return q->items + (size_t)(tail & q->mask) * q->item_size;
+}
+
+void spsc_pop(SpscQueue *q) {
+    uint64_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+}
@@ -0,0 +1,69 @@
+/**
+ * \file spscQueue.h
+ * \date 16 October 2026
+ * \brief File containing the lock-free single producer, single consumer queue.
+ *
+ * This file contains the function declarations of a bounded queue between exactly two threads, as well as the definition of
+ * the SpscQueue struct. The items are stored in the queue itself: the producer claims an item, fills it in and pushes it,
+ * the consumer reads the front item in place and pops it. Both sides keep a cached copy of the index of the other side,
+ * so the shared cache lines are only touched when the queue looks full or empty.
+ */
+
+#ifndef SPSC_QUEUE
+#define SPSC_QUEUE
+    #include <stdint.h>
+    #include <stdatomic.h>
+
+    /**
+     * \brief Defines the queue. The indices only grow, the item at index i is in slot i & mask.
+     */
+    typedef struct {
+        unsigned char *items;                   //!< The slots of the queue.
+        uint32_t mask;                          //!< The capacity of the queue minus one (the capacity is a power of 2).
+        uint32_t item_size;                     //!< The size of one slot, rounded up to a cache line.
+        _Alignas(64) _Atomic uint64_t head;     //!< The number of pushed items (written by the producer).
+        uint64_t tail_cache;                    //!< The last tail the producer has seen.
+        _Alignas(64) _Atomic uint64_t tail;     //!< The number of popped items (written by the consumer).
+        uint64_t head_cache;                    //!< The last head the consumer has seen.
+        _Alignas(64) uint64_t full;             //!< The number of times the producer found the queue full.
+    } SpscQueue;
+
+    /**
+     * \fn int spsc_setup(SpscQueue *q, uint32_t capacity, uint32_t item_size)
+     * \brief Allocate an empty queue.
+     * \param q Pointer to SpscQueue struct.
+     * \param capacity The minimum number of items, rounded up to a power of 2.
+     * \param item_size The size of one item in bytes.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void spsc_free(SpscQueue *q)
+     * \brief Free the queue.
+     * \param q Pointer to SpscQueue struct.
+     *
+     * \fn void *spsc_claim(SpscQueue *q)
+     * \brief Producer: get the next free item to fill in.
+     * \param q Pointer to SpscQueue struct.
+     * \return The item, followed by spsc_push(). NULL if the queue is full.
+     *
+     * \fn void spsc_push(SpscQueue *q)
+     * \brief Producer: make the claimed item visible to the consumer.
+     * \param q Pointer to SpscQueue struct.
+     *
+     * \fn void *spsc_front(SpscQueue *q)
+     * \brief Consumer: get the oldest item, without removing it.
+     * \param q Pointer to SpscQueue struct.
+     * \return The item, followed by spsc_pop() when done with it. NULL if the queue is empty.
+     *
+     * \fn void spsc_pop(SpscQueue *q)
+     * \brief Consumer: remove the item of spsc_front(), its slot can be claimed again.
+     * \param q Pointer to SpscQueue struct.
+     */
+
+    int spsc_setup(SpscQueue *q, uint32_t capacity, uint32_t item_size);
+    void spsc_free(SpscQueue *q);
+    void *spsc_claim(SpscQueue *q);
+    void spsc_push(SpscQueue *q);
+    void *spsc_front(SpscQueue *q);
+    void spsc_pop(SpscQueue *q);
+#endif
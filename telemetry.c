@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdatomic.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "telemetry.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+#define TELEMETRY_TRIES 1000    //!< The number of times a reader retries before giving up.
+
+int telemetry_open(Telemetry *t, const char *name) {
+    int fd;
+
+    t->block = NULL;
+    snprintf(t->name, sizeof(t->name), "%s", name);
+
+    fd = shm_open(t->name, O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if(fd < 0) {
+        terminalColor(31);
+        printf("Could not create the telemetry %s\n", t->name);
+        terminalColor(0);
+        return -1;
+    }
+    if(ftruncate(fd, sizeof(TelemetryBlock)) < 0) {
+        close(fd);
+        shm_unlink(t->name);
+        return -1;
+    }
+
+    /* Locked and written once, so the control loop never takes a page fault on it. */
+    t->block = mmap(NULL, sizeof(TelemetryBlock), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE | MAP_LOCKED, fd, 0);
+    if(t->block == MAP_FAILED)
+        t->block = mmap(NULL, sizeof(TelemetryBlock), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    close(fd);
+    if(t->block == MAP_FAILED) {
+        t->block = NULL;
+        shm_unlink(t->name);
+        return -1;
+    }
+
+    memset(t->block, 0, sizeof(TelemetryBlock));
+    t->block->version = TELEMETRY_VERSION;
+    t->block->size = sizeof(TelemetryState);
+    t->block->pid = getpid();
+    atomic_thread_fence(memory_order_release);
+    t->block->magic = TELEMETRY_MAGIC;
+
+    return 0;
+}
+
+void telemetry_close(Telemetry *t) {
+    if(t->block == NULL)
+        return;
+
+    t->block->magic = 0;
+    munmap(t->block, sizeof(TelemetryBlock));
+    shm_unlink(t->name);
+    t->block = NULL;
+}
+
+void telemetry_publish(Telemetry *t, const TelemetryState *state) {
+    TelemetryBlock *b = t->block;
+    uint32_t seq;
+
+    if(b == NULL)
+        return;
+
+    seq = atomic_load_explicit(&b->seq, memory_order_relaxed);
+    atomic_store_explicit(&b->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    b->state = *state;
+    atomic_store_explicit(&b->seq, seq + 2, memory_order_release);
+}
+
+const TelemetryBlock *telemetry_attach(const char *name) {
+    const TelemetryBlock *b;
+    int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+
+    if(fd < 0)
+        return NULL;
+
+    b = mmap(NULL, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(b == MAP_FAILED)
+        return NULL;
+
+    if(b->magic != TELEMETRY_MAGIC || b->version != TELEMETRY_VERSION || b->size != sizeof(TelemetryState)) {
+        telemetry_detach(b);
+        return NULL;
+    }
+
+    return b;
+}
+
+void telemetry_detach(const TelemetryBlock *block) {
+    munmap((void *)block, sizeof(TelemetryBlock));
+}
+
+int telemetry_read(const TelemetryBlock *block, TelemetryState *state) {
+    TelemetryBlock *b = (TelemetryBlock *)block;
+    uint32_t seq;
+
+    for(int i = 0; i < TELEMETRY_TRIES; i++) {
+        seq = atomic_load_explicit(&b->seq, memory_order_acquire);
+        if(seq & 1)
+            continue;
+
+        *state = b->state;
+        atomic_thread_fence(memory_order_acquire);
+        if(atomic_load_explicit(&b->seq, memory_order_relaxed) == seq)
+            return 0;
+    }
+
+    return -1;
+}
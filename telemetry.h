@@ -0,0 +1,117 @@
+/**
+ * \file telemetry.h
+ * \date 16 October 2026
+ * \brief File containing the telemetry of the control loop, published in shared memory.
+ *
+ * This file contains the function declarations for publishing the state of the control loop to other processes, as well
+ * as the definition of the TelemetryBlock struct. The state is written once per tick into a POSIX shared memory segment
+ * (/dev/shm/<name>), protected by a sequence lock:
+ * \code
+ * writer: seq++ (odd), copy the state, seq++ (even)
+ * reader: read seq, copy the state, read seq again; retry if it was odd or changed
+ * \endcode
+ * The writer never waits and makes no system call, so any number of readers, at any rate, cannot disturb the timing of the
+ * control loop. A reader only needs this header: see tools/telemetry.c.
+ */
+
+#ifndef TELEMETRY
+#define TELEMETRY
+    #include <stdint.h>
+    #include <stdatomic.h>
+    #include "panda.h"
+
+    #define TELEMETRY_NAME      "/driveCar"     //!< The default name of the shared memory segment.
+    #define TELEMETRY_MAGIC     0x54454C4D      //!< "TELM", to recognise the segment.
+    #define TELEMETRY_VERSION   3               //!< Changed with every change of TelemetryState.
+
+    /**
+     * \brief Contains the state of the control loop after one tick.
+     */
+    typedef struct {
+        uint64_t timestamp_ns;      //!< The CLOCK_MONOTONIC time of the start of the tick.
+        uint64_t ticks;             //!< The number of deadlines passed since the start, including missed ones.
+        uint64_t executed;          //!< The number of ticks that were run.
+        uint64_t overruns;          //!< The number of ticks still running when the next deadline passed.
+        uint64_t missed;            //!< The number of deadlines skipped.
+        int64_t late_ns;            //!< How late the tick was woken up.
+        int64_t max_late_ns;        //!< The worst wake-up lateness seen.
+        int64_t build_ns;           //!< The time to build the frames of the tick.
+        uint32_t count;             //!< The counter of the tick, the same as in the log.
+        int16_t steer;              //!< The steering torque requested by the joystick.
+        int16_t steer_count;        //!< The steering torque sent, ramped towards steer.
+        int16_t accel;              //!< The acceleration sent.
+        int16_t decel;              //!< The deceleration sent.
+        uint16_t buttons;           //!< The buttons of the joystick, bit n is button n.
+        int16_t axes[6];            //!< The axes of the joystick (X and Y of every stick).
+        uint64_t js_events;         //!< The number of joystick events applied.
+        uint64_t tx_frames;         //!< The number of frames sent.
+        uint64_t rx_frames;         //!< The number of frames received.
+        uint16_t speed;             //!< The speed of the car in 0.01 km/h.
+        int16_t steer_angle;        //!< The steering angle of the car in 1.5 degrees.
+        int16_t steer_echo;         //!< The steering torque the CAN device last confirmed sending.
+        uint64_t steer_echo_ns;     //!< The CLOCK_MONOTONIC time of that confirmation, 0 if never.
+        uint64_t health_ns;         //!< The CLOCK_MONOTONIC time the health was read, 0 if never.
+        Health health;              //!< The last health of the CAN device.
+    } TelemetryState;
+
+    /**
+     * \brief Defines the shared memory segment.
+     */
+    typedef struct {
+        uint32_t magic;                         //!< TELEMETRY_MAGIC.
+        uint16_t version;                       //!< TELEMETRY_VERSION.
+        uint16_t size;                          //!< sizeof(TelemetryState).
+        uint32_t pid;                           //!< The process that publishes.
+        _Alignas(64) _Atomic uint32_t seq;      //!< The sequence lock, odd while the state is written.
+        TelemetryState state;                   //!< The state.
+    } TelemetryBlock;
+
+    /**
+     * \brief Defines the writer of the telemetry.
+     */
+    typedef struct {
+        TelemetryBlock *block;  //!< The mapped segment, NULL if not open.
+        char name[64];          //!< The name of the segment.
+    } Telemetry;
+
+    /**
+     * \fn int telemetry_open(Telemetry *t, const char *name)
+     * \brief Create the shared memory segment and start publishing.
+     * \param t Pointer to Telemetry struct.
+     * \param name The name of the segment, starting with '/'.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void telemetry_close(Telemetry *t)
+     * \brief Stop publishing and remove the segment.
+     * \param t Pointer to Telemetry struct.
+     *
+     * \fn void telemetry_publish(Telemetry *t, const TelemetryState *state)
+     * \brief Writer: publish a new state, never waits. Does nothing if the telemetry is not open.
+     * \param t Pointer to Telemetry struct.
+     * \param state The state.
+     *
+     * \fn const TelemetryBlock *telemetry_attach(const char *name)
+     * \brief Reader: map the segment of a running writer, read-only.
+     * \param name The name of the segment.
+     * \return The segment, NULL if there is none or it has another version.
+     *
+     * \fn void telemetry_detach(const TelemetryBlock *block)
+     * \brief Reader: unmap the segment.
+     * \param block The segment.
+     *
+     * \fn int telemetry_read(const TelemetryBlock *block, TelemetryState *state)
+     * \brief Reader: copy the newest consistent state.
+     * \param block The segment.
+     * \param state The copy of the state.
+     * \return 0: Success
+     * \return <0: The writer kept writing during every try
+     */
+
+    int telemetry_open(Telemetry *t, const char *name);
+    void telemetry_close(Telemetry *t);
+    void telemetry_publish(Telemetry *t, const TelemetryState *state);
+    const TelemetryBlock *telemetry_attach(const char *name);
+    void telemetry_detach(const TelemetryBlock *block);
+    int telemetry_read(const TelemetryBlock *block, TelemetryState *state);
+#endif
@@ -0,0 +1,1202 @@
+/**
+ * \file canconv.c
+ * \date 16 October 2026
+ * \brief Converter between the logs of driveCar and candump, Vector ASC and Vector BLF.
+ *
+ * Reads one log and writes it in another format, frame by frame, in constant memory:
+ * \code
+ * trace    The binary log of driveCar -l (see recorder.h), read with recorder_load(), written with recorder_open().
+ * candump  The log file format of can-utils (candump -L): "(1436509052.249713) can0 123#DEADBEEF".
+ * asc      Vector ASC, text: "   0.015991 1  123             Rx   d 8 01 02 03 04 05 06 07 08".
+ * blf      Vector BLF, binary: CAN_MESSAGE objects in zlib compressed LOG_CONTAINER objects.
+ * \endcode
+ * The text formats are split into lines in a fixed input buffer and tokenized in place, without any allocation or
+ * sscanf(). The containers of BLF are inflated in chunks into a fixed window, objects that cross two containers are
+ * kept in the window. Extended IDs, remote frames and CAN FD frames are skipped and counted, CANFrame only holds 11 bit
+ * data frames.
+ *
+ * Bus n is can<n> in candump (-i to change the prefix) and channel n + 1 in ASC and BLF. The format is taken from the
+ * first bytes of the input (trace and BLF) or the extension (.log, .asc, .blf, anything else is a trace), or set with -f
+ * and -F. "-" is stdin or stdout, not for BLF.
+ * \code
+ * tools/canconv [-f <format>] [-F <format>] [-i <prefix>] [-n <records>] [-x] <input> <output>
+ * \endcode
+ */
+
+#define _GNU_SOURCE     // strptime()
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "canFrame.h"
+#include "recorder.h"
+
+#define CONV_BUFFER     (1 << 20)   //!< The size of the input and output buffers, the longest possible line.
+#define BLF_WINDOW      (1 << 18)   //!< The size of the window of inflated objects.
+#define BLF_CONTAINER   (128 << 10) //!< The uncompressed size of a written container.
+#define BLF_HEADER_SIZE 144         //!< The size of the file header.
+#define BLF_OBJ_BASE    16          //!< The size of the base header of an object.
+#define BLF_OBJ_V1      16          //!< The size of the version 1 header of an object.
+#define BLF_CAN_MESSAGE 1           //!< The object type of a CAN frame.
+#define BLF_CONTAINER_T 10          //!< The object type of a LOG_CONTAINER.
+#define BLF_CAN_MESSAGE2 86         //!< The object type of a CAN frame with bit timing.
+#define BLF_CAN_FD_64   101         //!< The object type of a CAN FD frame of up to 64 bytes, not padded.
+#define BLF_DIR_TX      0x01        //!< The direction flag of a CAN_MESSAGE.
+#define BLF_REMOTE      0x80        //!< The remote frame flag of a CAN_MESSAGE.
+#define BLF_EXTENDED    0x80000000u //!< The extended ID flag of a CAN_MESSAGE.
+#define BLF_TEN_MICROS  1           //!< The object timestamp is in 10 us, otherwise in ns.
+#define DEFAULT_RECORDS (1 << 24)   //!< The default capacity of a written trace, as driveCar.
+
+/**
+ * \brief Defines the formats.
+ */
+typedef enum {
+    FORMAT_TRACE = 0,
+    FORMAT_CANDUMP,
+    FORMAT_ASC,
+    FORMAT_BLF
+} Format;
+
+static const char *formatNames[] = {"trace", "candump", "asc", "blf"};
+
+/**
+ * \brief Defines one frame between a reader and a writer.
+ */
+typedef struct {
+    uint64_t timestamp_ns;  //!< CLOCK_REALTIME of the frame, or the time since the start for a relative log (see conv_relative()).
+    CANFrame frame;         //!< The frame.
+    uint8_t tx;             //!< Was the frame sent, instead of received?
+} ConvFrame;
+
+/**
+ * \brief Defines a buffered input file.
+ */
+typedef struct {
+    int fd;                         //!< The file.
+    uint8_t buf[CONV_BUFFER];       //!< The buffer.
+    size_t pos;                     //!< The first byte not consumed yet.
+    size_t len;                     //!< The number of bytes in the buffer.
+    uint8_t eof;                    //!< Was the end of the file read?
+} Input;
+
+/**
+ * \brief Defines a buffered output file.
+ */
+typedef struct {
+    int fd;                         //!< The file.
+    uint8_t buf[CONV_BUFFER];       //!< The buffer.
+    size_t len;                     //!< The number of bytes in the buffer.
+    int error;                      //!< The errno of the first failed write, 0 if none.
+} Output;
+
+/**
+ * \brief Defines the state of the reader of an ASC file.
+ */
+typedef struct {
+    int base;                       //!< The base of the IDs and data, 16 or 10.
+    uint64_t start_ns;              //!< The start of the measurement from the date line, the times are relative to it.
+} AscReader;
+
+/**
+ * \brief Defines the state of the reader of a BLF file.
+ */
+typedef struct {
+    z_stream z;                     //!< The inflater of the current container.
+    uint8_t zlib;                   //!< Is the current container compressed?
+    uint64_t left;                  //!< The bytes of the current container (or top level object) still in the input.
+    uint32_t padding;               //!< The padding after the current container.
+    uint8_t data[BLF_WINDOW];       //!< The inflated objects.
+    size_t pos;                     //!< The first byte of data not parsed yet.
+    size_t len;                     //!< The number of bytes in data.
+    uint64_t skip;                  //!< The bytes of an object too big for the window still to drop.
+    uint64_t start_ns;              //!< The start of the measurement, the object timestamps are relative to it.
+} BlfReader;
+
+/**
+ * \brief Defines the state of the writer of a BLF file.
+ */
+typedef struct {
+    uint8_t data[BLF_CONTAINER];    //!< The objects of the next container.
+    size_t len;                     //!< The number of bytes in data.
+    uint8_t zdata[BLF_CONTAINER + 1024];    //!< The compressed container, compressBound() of data.
+    uint64_t start_ns;              //!< The start of the measurement, set by the first frame.
+    uint64_t last_ns;               //!< The time of the last frame.
+    uint64_t size;                  //!< The number of bytes written.
+    uint64_t uncompressed;          //!< The number of bytes written, if nothing was compressed.
+    uint32_t objects;               //!< The number of CAN objects.
+} BlfWriter;
+
+/**
+ * \brief Contains the options and the state of a conversion.
+ */
+typedef struct {
+    Format from;                    //!< The input format.
+    Format to;                      //!< The output format.
+    const char *prefix;             //!< The interface name of a bus in candump, followed by the bus number.
+    uint64_t capacity;              //!< The number of records of a written trace.
+    uint8_t direction;              //!< Write the direction (R or T) in candump.
+    RecorderLog log;                //!< The trace that is read.
+    uint64_t next;                  //!< The next record of the trace.
+    int64_t offset_ns;              //!< Trace: CLOCK_REALTIME - CLOCK_MONOTONIC of the log.
+    Recorder recorder;              //!< The trace that is written.
+    uint8_t started;                //!< Was the first frame written?
+    uint64_t first_ns;              //!< The time of the first frame written, in whole milliseconds.
+    uint64_t read;                  //!< The number of frames read.
+    uint64_t written;               //!< The number of frames written.
+    uint64_t skipped;               //!< The number of lines or objects that are not a frame CANFrame can hold.
+} Conv;
+
+static Input in;
+static Output out;
+static AscReader ascIn = {.base = 16};
+static BlfReader blfIn;
+static BlfWriter blfOut;
+
+static const char hexDigits[] = "0123456789ABCDEF";
+
+/*
+ * Buffered input and output.
+ */
+
+static int input_fill(Input *i) {
+    ssize_t n;
+
+    if(i->pos > 0) {
+        memmove(i->buf, i->buf + i->pos, i->len - i->pos);
+        i->len -= i->pos;
+        i->pos = 0;
+    }
+    if(i->eof || i->len == CONV_BUFFER)
+        return 0;
+
+    do {
+        n = read(i->fd, i->buf + i->len, CONV_BUFFER - i->len);
+    } while(n < 0 && errno == EINTR);
+    if(n < 0)
+        return -1;
+    if(n == 0)
+        i->eof = 1;
+    i->len += n;
+
+    return (int)(n > 0);
+}
+
+/* Make sure n bytes can be read from buf + pos, returns 0 at the end of the file. */
+static int input_need(Input *i, size_t n) {
+    while(i->len - i->pos < n) {
+        if(input_fill(i) <= 0)
+            return (i->len - i->pos >= n) ? 1 : 0;
+    }
+
+    return 1;
+}
+
+static int input_skip(Input *i, uint64_t n) {
+    size_t step;
+
+    while(n > 0) {
+        if(i->pos == i->len && input_fill(i) <= 0)
+            return -1;
+        step = (n < i->len - i->pos) ? n : i->len - i->pos;
+        i->pos += step;
+        n -= step;
+    }
+
+    return 0;
+}
+
+/* The next line without the '\n', in the buffer, NULL at the end of the file. A line longer than the buffer is cut. */
+static const char *input_line(Input *i, const char **end) {
+    const char *line;
+    uint8_t *nl;
+
+    for(;;) {
+        nl = memchr(i->buf + i->pos, '\n', i->len - i->pos);
+        if(nl != NULL || i->eof || (i->pos == 0 && i->len == CONV_BUFFER))
+            break;
+        if(input_fill(i) < 0)
+            return NULL;
+    }
+
+    if(i->pos == i->len)
+        return NULL;
+
+    line = (const char *)i->buf + i->pos;
+    if(nl == NULL) {
+        *end = (const char *)i->buf + i->len;
+        i->pos = i->len;
+    } else {
+        *end = (const char *)nl;
+        i->pos = nl - i->buf + 1;
+    }
+    if(*end > line && (*end)[-1] == '\r')
+        (*end)--;
+
+    return line;
+}
+
+static void out_flush(Output *o) {
+    size_t done = 0;
+    ssize_t n;
+
+    while(done < o->len && o->error == 0) {
+        n = write(o->fd, o->buf + done, o->len - done);
+        if(n < 0 && errno != EINTR)
+            o->error = errno;
+        else if(n > 0)
+            done += n;
+    }
+    o->len = 0;
+}
+
+static void out_bytes(Output *o, const void *data, size_t length) {
+    if(o->len + length > CONV_BUFFER)
+        out_flush(o);
+    memcpy(o->buf + o->len, data, length);
+    o->len += length;
+}
+
+/* Reserve room for one line, so the formatting below never checks the size. */
+static char *out_reserve(Output *o, size_t length) {
+    if(o->len + length > CONV_BUFFER)
+        out_flush(o);
+
+    return (char *)o->buf + o->len;
+}
+
+static char *put_dec(char *p, uint64_t v, int width, char pad) {
+    char digits[20];
+    int n = 0;
+
+    do {
+        digits[n++] = '0' + v % 10;
+        v /= 10;
+    } while(v > 0);
+    while(width-- > n)
+        *p++ = pad;
+    while(n > 0)
+        *p++ = digits[--n];
+
+    return p;
+}
+
+static char *put_hex(char *p, uint32_t v, int digits) {
+    for(int i = digits - 1; i >= 0; i--)
+        *p++ = hexDigits[(v >> (4 * i)) & 0xf];
+
+    return p;
+}
+
+/* Seconds with 6 decimals, padded to width. */
+static char *put_time(char *p, uint64_t ns, int width, char pad) {
+    uint64_t us = ns / 1000;
+
+    p = put_dec(p, us / 1000000, width - 7, pad);
+    *p++ = '.';
+    return put_dec(p, us % 1000000, 6, '0');
+}
+
+/*
+ * The tokenizer of the text formats: pointers into the line, nothing is copied or terminated.
+ */
+
+static const char *skip_spaces(const char *p, const char *end) {
+    while(p < end && (*p == ' ' || *p == '\t'))
+        p++;
+
+    return p;
+}
+
+static const char *token_end(const char *p, const char *end) {
+    while(p < end && *p != ' ' && *p != '\t')
+        p++;
+
+    return p;
+}
+
+static int hex_value(char c) {
+    if(c >= '0' && c <= '9')
+        return c - '0';
+    if(c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+
+    return -1;
+}
+
+/* Parse the number from p to end, returns the number of digits, -1 if there is anything else. */
+static int parse_number(const char *p, const char *end, int base, uint64_t *value) {
+    int digit, n = 0;
+
+    *value = 0;
+    for(; p < end; p++, n++) {
+        digit = hex_value(*p);
+        if(digit < 0 || digit >= base)
+            return -1;
+        *value = *value * base + digit;
+    }
+
+    return n;
+}
+
+/* Parse seconds with up to 9 decimals to ns, returns -1 if it is not a time. */
+static int parse_time(const char *p, const char *end, uint64_t *ns) {
+    const char *dot = p;
+    uint64_t sec, frac;
+    int digits;
+
+    while(dot < end && *dot != '.')
+        dot++;
+    if(parse_number(p, dot, 10, &sec) <= 0)
+        return -1;
+
+    frac = 0;
+    digits = 0;
+    if(dot < end) {
+        if(end - dot - 1 > 9)
+            end = dot + 10;
+        digits = parse_number(dot + 1, end, 10, &frac);
+        if(digits < 0)
+            return -1;
+    }
+    for(; digits < 9; digits++)
+        frac *= 10;
+
+    *ns = sec * 1000000000ULL + frac;
+    return 0;
+}
+
+/*
+ * candump: (1436509052.249713) can0 123#DEADBEEF [R|T]
+ */
+
+static int candump_parse(Conv *c, const char *p, const char *end, ConvFrame *f) {
+    const char *t, *bus;
+    uint64_t v;
+    int n;
+
+    p = skip_spaces(p, end);
+    if(p == end || *p != '(')
+        return -1;
+    t = ++p;
+    while(p < end && *p != ')')
+        p++;
+    if(p == end || parse_time(t, p, &f->timestamp_ns) < 0)
+        return -1;
+
+    /* The bus is the number at the end of the interface name. */
+    p = skip_spaces(p + 1, end);
+    t = token_end(p, end);
+    for(bus = t; bus > p && bus[-1] >= '0' && bus[-1] <= '9'; bus--);
+    if(parse_number(bus, t, 10, &v) <= 0 || v >= CAN_BUS_RETURNED)
+        return -1;
+    f->frame.bus = v;
+
+    p = skip_spaces(t, end);
+    for(t = p; t < end && *t != '#'; t++);
+    /* 3 digits: standard ID, 8: extended. */
+    if(t == end || t - p != 3 || parse_number(p, t, 16, &v) != 3 || v > 0x7ff)
+        return -1;
+    f->frame.ID = v;
+
+    p = t + 1;
+    memset(f->frame.data, 0, sizeof(f->frame.data));
+    f->frame.length = 0;
+    /* CAN FD and remote frames, CANFrame can not hold them and driveCar never sends or receives them. */
+    if(p < end && (*p == '#' || *p == 'R'))
+        return -1;
+    for(n = 0; p + 1 < end && hex_value(p[0]) >= 0 && hex_value(p[1]) >= 0; n++) {
+        if(n == 8)
+            return -1;
+        f->frame.data[n] = hex_value(p[0]) << 4 | hex_value(p[1]);
+        p += 2;
+        if(p < end && *p == '.')
+            p++;
+    }
+    f->frame.length = n;
+
+    p = skip_spaces(p, end);
+    f->tx = (p < end && *p == 'T');
+    f->frame.freq = 0;
+
+    return 0;
+}
+
+static int candump_read(Conv *c, ConvFrame *f) {
+    const char *line, *end;
+
+    while((line = input_line(&in, &end)) != NULL) {
+        if(candump_parse(c, line, end, f) == 0)
+            return 1;
+        if(skip_spaces(line, end) != end)
+            c->skipped++;
+    }
+
+    return 0;
+}
+
+static void candump_write(Conv *c, const ConvFrame *f) {
+    char *p = out_reserve(&out, 128), *start = p;
+    const char *n;
+
+    *p++ = '(';
+    p = put_time(p, f->timestamp_ns, 17, '0');
+    *p++ = ')';
+    *p++ = ' ';
+    for(n = c->prefix; *n != '\0' && p - start < 64; n++)
+        *p++ = *n;
+    p = put_dec(p, f->frame.bus, 1, ' ');
+    *p++ = ' ';
+    p = put_hex(p, f->frame.ID, 3);
+    *p++ = '#';
+    for(int i = 0; i < f->frame.length && i < 8; i++)
+        p = put_hex(p, f->frame.data[i], 2);
+    if(c->direction) {
+        *p++ = ' ';
+        *p++ = f->tx ? 'T' : 'R';
+    }
+    *p++ = '\n';
+
+    out.len += p - start;
+}
+
+/*
+ * Vector ASC:    0.015991 1  123             Rx   d 8 01 02 03 04 05 06 07 08
+ */
+
+/* "date Fri Oct 16 03:17:52.953 am 2026", or with a 24 hour clock, in local time. */
+static void asc_date(AscReader *a, const char *p, const char *end) {
+    char date[64], *ms;
+    struct tm tm;
+    int millis = 0;
+
+    snprintf(date, sizeof(date), "%.*s", (int)(end - p), p);
+    ms = strchr(date, '.');
+    if(ms != NULL) {
+        millis = atoi(ms + 1);
+        memmove(ms, ms + 4, strlen(ms + 4) + 1);
+    }
+
+    memset(&tm, 0, sizeof(tm));
+    if(strptime(date, "%a %b %d %I:%M:%S %p %Y", &tm) == NULL) {
+        memset(&tm, 0, sizeof(tm));
+        if(strptime(date, "%a %b %d %H:%M:%S %Y", &tm) == NULL)
+            return;
+    }
+    tm.tm_isdst = -1;
+    a->start_ns = mktime(&tm) * 1000000000ULL + millis * 1000000ULL;
+}
+
+static int asc_parse(Conv *c, const char *p, const char *end, ConvFrame *f) {
+    AscReader *a = &ascIn;
+    const char *t;
+    uint64_t v;
+
+    p = skip_spaces(p, end);
+    t = token_end(p, end);
+    if(t - p == 4 && memcmp(p, "base", 4) == 0) {
+        p = skip_spaces(t, end);
+        a->base = (end - p >= 3 && memcmp(p, "dec", 3) == 0) ? 10 : 16;
+        return -2;
+    }
+    if(t - p == 4 && memcmp(p, "date", 4) == 0) {
+        asc_date(a, skip_spaces(t, end), end);
+        return -2;
+    }
+    if(parse_time(p, t, &f->timestamp_ns) < 0)
+        return -2;
+    f->timestamp_ns += a->start_ns;
+
+    /* Only "<channel> <ID> Rx|Tx d <length> <data>", not the events, error frames or CAN FD. */
+    p = skip_spaces(t, end);
+    t = token_end(p, end);
+    if(parse_number(p, t, 10, &v) <= 0)
+        return -2;
+    if(v == 0 || v > CAN_BUS_RETURNED)
+        return -1;
+    f->frame.bus = v - 1;
+
+    p = skip_spaces(t, end);
+    t = token_end(p, end);
+    if(parse_number(p, t, ascIn.base, &v) <= 0 || v > 0x7ff)
+        return -1;
+    f->frame.ID = v;
+
+    p = skip_spaces(t, end);
+    t = token_end(p, end);
+    if(t - p != 2 || (memcmp(p, "Rx", 2) != 0 && memcmp(p, "Tx", 2) != 0))
+        return -1;
+    f->tx = (*p == 'T');
+
+    /* Only data frames, a remote frame (r) is skipped like in candump and BLF. */
+    p = skip_spaces(t, end);
+    if(p == end || *p != 'd')
+        return -1;
+    memset(f->frame.data, 0, sizeof(f->frame.data));
+    f->frame.freq = 0;
+
+    p = skip_spaces(p + 1, end);
+    t = token_end(p, end);
+    if(parse_number(p, t, 16, &v) != 1 || v > 8)
+        return -1;
+    f->frame.length = v;
+
+    for(int i = 0; i < f->frame.length; i++) {
+        p = skip_spaces(t, end);
+        t = token_end(p, end);
+        if(parse_number(p, t, ascIn.base, &v) <= 0 || v > 0xff)
+            return -1;
+        f->frame.data[i] = v;
+    }
+
+    return 0;
+}
+
+static int asc_read(Conv *c, ConvFrame *f) {
+    const char *line, *end;
+    int ret;
+
+    while((line = input_line(&in, &end)) != NULL) {
+        ret = asc_parse(c, line, end, f);
+        if(ret == 0)
+            return 1;
+        if(ret == -1)
+            c->skipped++;
+    }
+
+    return 0;
+}
+
+static void asc_header(Conv *c, uint64_t timestamp_ns) {
+    time_t sec = timestamp_ns / 1000000000ULL;
+    char date[64], line[256];
+    struct tm tm;
+    int n;
+
+    localtime_r(&sec, &tm);
+    n = strftime(date, sizeof(date), "%a %b %d %I:%M:%S", &tm);
+    n += snprintf(date + n, sizeof(date) - n, ".%03d ", (int)(timestamp_ns / 1000000 % 1000));
+    strftime(date + n, sizeof(date) - n, "%p %Y", &tm);
+    date[n] = (date[n] == 'P') ? 'p' : 'a';
+    date[n + 1] = 'm';
+
+    n = snprintf(line, sizeof(line), "date %s\nbase hex  timestamps absolute\ninternal events logged\n// version 9.0.0\n"
+                 "Begin Triggerblock %s\n   0.000000 Start of measurement\n", date, date);
+    out_bytes(&out, line, n);
+}
+
+static void asc_write(Conv *c, const ConvFrame *f) {
+    char *p = out_reserve(&out, 128), *start = p, *id;
+
+    /* The times are relative to the first frame. */
+    p = put_time(p, f->timestamp_ns - c->first_ns, 11, ' ');
+    *p++ = ' ';
+    p = put_dec(p, f->frame.bus + 1, 1, ' ');
+    memcpy(p, "  ", 2);
+    p += 2;
+    id = p;
+    p = put_hex(p, f->frame.ID, (f->frame.ID > 0xff) ? 3 : (f->frame.ID > 0xf) ? 2 : 1);
+    while(p - id < 15)
+        *p++ = ' ';
+    memcpy(p, f->tx ? " Tx   d " : " Rx   d ", 8);
+    p += 8;
+    *p++ = hexDigits[f->frame.length & 0xf];
+    for(int i = 0; i < f->frame.length && i < 8; i++) {
+        *p++ = ' ';
+        p = put_hex(p, f->frame.data[i], 2);
+    }
+    *p++ = '\n';
+
+    out.len += p - start;
+}
+
+/*
+ * Vector BLF: file header, then LOBJ objects, the CAN objects in LOG_CONTAINER objects.
+ */
+
+static uint16_t get16(const uint8_t *p) {
+    return p[0] | p[1] << 8;
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t get64(const uint8_t *p) {
+    return get32(p) | (uint64_t)get32(p + 4) << 32;
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    put16(p, v);
+    put16(p + 2, v >> 16);
+}
+
+static void put64(uint8_t *p, uint64_t v) {
+    put32(p, v);
+    put32(p + 4, v >> 32);
+}
+
+/* SYSTEMTIME: year, month, day of the week, day, hour, minute, second, milliseconds, in local time. */
+static uint64_t blf_systemtime_ns(const uint8_t *p) {
+    struct tm tm;
+
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_year = get16(p) - 1900;
+    tm.tm_mon = get16(p + 2) - 1;
+    tm.tm_mday = get16(p + 6);
+    tm.tm_hour = get16(p + 8);
+    tm.tm_min = get16(p + 10);
+    tm.tm_sec = get16(p + 12);
+    tm.tm_isdst = -1;
+    if(tm.tm_year < 70)
+        return 0;
+
+    return mktime(&tm) * 1000000000ULL + get16(p + 14) * 1000000ULL;
+}
+
+static void blf_put_systemtime(uint8_t *p, uint64_t ns) {
+    time_t sec = ns / 1000000000ULL;
+    struct tm tm;
+
+    localtime_r(&sec, &tm);
+    put16(p, tm.tm_year + 1900);
+    put16(p + 2, tm.tm_mon + 1);
+    put16(p + 4, tm.tm_wday);
+    put16(p + 6, tm.tm_mday);
+    put16(p + 8, tm.tm_hour);
+    put16(p + 10, tm.tm_min);
+    put16(p + 12, tm.tm_sec);
+    put16(p + 14, ns / 1000000 % 1000);
+}
+
+static int blf_open(Conv *c) {
+    BlfReader *b = &blfIn;
+    uint32_t size;
+
+    if(!input_need(&in, BLF_HEADER_SIZE) || memcmp(in.buf, "LOGG", 4) != 0)
+        return -1;
+    size = get32(in.buf + 4);
+    b->start_ns = blf_systemtime_ns(in.buf + 40);
+    if(size < 72 || input_skip(&in, size) < 0)
+        return -1;
+
+    memset(&b->z, 0, sizeof(z_stream));
+    if(inflateInit(&b->z) != Z_OK)
+        return -1;
+
+    return 0;
+}
+
+/* Add bytes to the window: from the current container, or from the next top level object. */
+static int blf_more(BlfReader *b) {
+    const uint8_t *h;
+    size_t room, avail, n;
+    int ret;
+
+    for(;;) {
+        room = BLF_WINDOW - b->len;
+        if(b->left > 0) {
+            if(in.pos == in.len && input_fill(&in) <= 0)
+                return -1;
+            avail = (in.len - in.pos < b->left) ? in.len - in.pos : b->left;
+
+            if(!b->zlib) {
+                n = (avail < room) ? avail : room;
+                memcpy(b->data + b->len, in.buf + in.pos, n);
+                b->len += n;
+                in.pos += n;
+                b->left -= n;
+                return 1;
+            }
+
+            b->z.next_in = in.buf + in.pos;
+            b->z.avail_in = avail;
+            b->z.next_out = b->data + b->len;
+            b->z.avail_out = room;
+            ret = inflate(&b->z, Z_NO_FLUSH);
+            in.pos += avail - b->z.avail_in;
+            b->left -= avail - b->z.avail_in;
+            b->len = room - b->z.avail_out + b->len;
+            if(ret == Z_STREAM_END) {
+                if(input_skip(&in, b->left) < 0)
+                    return -1;
+                b->left = 0;
+            } else if(ret != Z_OK && ret != Z_BUF_ERROR) {
+                return -1;
+            }
+            if(b->z.avail_out < room)
+                return 1;
+            continue;
+        }
+
+        if(input_skip(&in, b->padding) < 0 || !input_need(&in, BLF_OBJ_BASE))
+            return 0;
+        b->padding = 0;
+
+        h = in.buf + in.pos;
+        if(memcmp(h, "LOBJ", 4) != 0 || get32(h + 8) < BLF_OBJ_BASE)
+            return -1;
+        if(get32(h + 12) == BLF_CONTAINER_T) {
+            if(!input_need(&in, BLF_OBJ_BASE + 16))
+                return -1;
+            h = in.buf + in.pos;
+            b->left = get32(h + 8) - BLF_OBJ_BASE - 16;
+            b->padding = get32(h + 8) % 4;
+            b->zlib = (get16(h + BLF_OBJ_BASE) == 2);
+            if(b->zlib)
+                inflateReset(&b->z);
+            in.pos += BLF_OBJ_BASE + 16;
+        } else {
+            /* An object outside a container is parsed from the window as well. */
+            if(room < BLF_OBJ_BASE)
+                return -1;
+            memcpy(b->data + b->len, h, BLF_OBJ_BASE);
+            b->len += BLF_OBJ_BASE;
+            b->left = get32(h + 8) - BLF_OBJ_BASE;
+            b->padding = get32(h + 8) % 4;
+            b->zlib = 0;
+            in.pos += BLF_OBJ_BASE;
+            return 1;
+        }
+    }
+}
+
+static int blf_parse(Conv *c, const uint8_t *o, ConvFrame *f) {
+    uint32_t headerSize = get16(o + 4), type = get32(o + 12), size = get32(o + 8);
+    uint64_t timestamp;
+    const uint8_t *m;
+
+    if(type != BLF_CAN_MESSAGE && type != BLF_CAN_MESSAGE2)
+        return -2;
+    if(get16(o + 6) > 2 || headerSize + 16 > size) {
+        c->skipped++;
+        return -1;
+    }
+
+    /* Version 1 and 2 headers both have the flags at 16 and the timestamp at 24. */
+    timestamp = get64(o + 24);
+    f->timestamp_ns = blfIn.start_ns + ((get32(o + 16) & BLF_TEN_MICROS) ? timestamp * 10000 : timestamp);
+
+    m = o + headerSize;
+    if((get32(m + 4) & BLF_EXTENDED) || get32(m + 4) > 0x7ff || get16(m) == 0 || get16(m) > CAN_BUS_RETURNED || (m[2] & BLF_REMOTE)) {
+        c->skipped++;
+        return -1;
+    }
+    f->frame.bus = get16(m) - 1;
+    f->tx = m[2] & BLF_DIR_TX;
+    f->frame.length = (m[3] > 8) ? 8 : m[3];
+    f->frame.ID = get32(m + 4);
+    memset(f->frame.data, 0, sizeof(f->frame.data));
+    memcpy(f->frame.data, m + 8, f->frame.length);
+    f->frame.freq = 0;
+
+    return 0;
+}
+
+static int blf_read(Conv *c, ConvFrame *f) {
+    BlfReader *b = &blfIn;
+    const uint8_t *o;
+    uint64_t total, n;
+    int ret;
+
+    for(;;) {
+        if(b->skip > 0) {
+            n = (b->skip < b->len - b->pos) ? b->skip : b->len - b->pos;
+            b->pos += n;
+            b->skip -= n;
+        }
+
+        while(b->skip == 0 && b->len - b->pos >= BLF_OBJ_BASE) {
+            o = b->data + b->pos;
+            if(memcmp(o, "LOBJ", 4) != 0 || get32(o + 8) < BLF_OBJ_BASE)
+                return -1;
+
+            /* The objects are padded to 4 bytes, except CAN FD 64. */
+            total = get32(o + 8);
+            if(get32(o + 12) != BLF_CAN_FD_64)
+                total += total % 4;
+            if(total > BLF_WINDOW) {
+                b->skip = total - (b->len - b->pos);
+                b->pos = b->len;
+                c->skipped++;
+                break;
+            }
+            if(b->len - b->pos < total)
+                break;
+
+            ret = blf_parse(c, o, f);
+            b->pos += total;
+            if(ret == 0)
+                return 1;
+        }
+
+        /* Keep the unparsed part of the window, the next container continues it. */
+        memmove(b->data, b->data + b->pos, b->len - b->pos);
+        b->len -= b->pos;
+        b->pos = 0;
+
+        ret = blf_more(b);
+        if(ret <= 0) {
+            if(ret == 0 && b->len > 0)
+                c->skipped++;
+            return ret;
+        }
+    }
+}
+
+static int blf_write_header(Conv *c) {
+    BlfWriter *b = &blfOut;
+    uint8_t h[BLF_HEADER_SIZE];
+
+    memset(h, 0, sizeof(h));
+    memcpy(h, "LOGG", 4);
+    put32(h + 4, BLF_HEADER_SIZE);
+    h[8] = 5;           // The application ID, as python-can.
+    h[12] = 2;          // The version of the BLF format: 2.6.8.1.
+    h[13] = 6;
+    h[14] = 8;
+    h[15] = 1;
+    put64(h + 16, b->size);
+    put64(h + 24, b->uncompressed);
+    put32(h + 32, b->objects);
+    if(b->objects > 0) {
+        blf_put_systemtime(h + 40, b->start_ns);
+        blf_put_systemtime(h + 56, b->last_ns);
+    }
+
+    if(pwrite(out.fd, h, sizeof(h), 0) != sizeof(h))
+        return -1;
+
+    return 0;
+}
+
+static void blf_flush(Conv *c) {
+    BlfWriter *b = &blfOut;
+    uLongf length = sizeof(b->zdata);
+    uint8_t h[BLF_OBJ_BASE + 16], pad[4] = {0};
+
+    if(b->len == 0)
+        return;
+
+    if(compress2(b->zdata, &length, b->data, b->len, Z_BEST_SPEED) != Z_OK) {
+        out.error = ENOMEM;
+        return;
+    }
+
+    memset(h, 0, sizeof(h));
+    memcpy(h, "LOBJ", 4);
+    put16(h + 4, BLF_OBJ_BASE);
+    put16(h + 6, 1);
+    put32(h + 8, BLF_OBJ_BASE + 16 + length);
+    put32(h + 12, BLF_CONTAINER_T);
+    put16(h + BLF_OBJ_BASE, 2);     // zlib
+    put32(h + BLF_OBJ_BASE + 8, b->len);
+
+    out_bytes(&out, h, sizeof(h));
+    out_bytes(&out, b->zdata, length);
+    out_bytes(&out, pad, length % 4);
+    b->size += sizeof(h) + length + length % 4;
+    b->uncompressed += sizeof(h) + b->len;
+    b->len = 0;
+}
+
+static void blf_write(Conv *c, const ConvFrame *f) {
+    BlfWriter *b = &blfOut;
+    uint8_t *o;
+
+    if(b->len + 48 > BLF_CONTAINER)
+        blf_flush(c);
+    if(b->objects == 0)
+        b->start_ns = f->timestamp_ns / 1000000 * 1000000;     // SYSTEMTIME has milliseconds.
+    b->last_ns = f->timestamp_ns;
+
+    o = b->data + b->len;
+    memset(o, 0, 48);
+    memcpy(o, "LOBJ", 4);
+    put16(o + 4, BLF_OBJ_BASE + BLF_OBJ_V1);
+    put16(o + 6, 1);
+    put32(o + 8, 48);
+    put32(o + 12, BLF_CAN_MESSAGE);
+    put32(o + 16, 2);       // The timestamp is in ns.
+    put64(o + 24, (f->timestamp_ns > b->start_ns) ? f->timestamp_ns - b->start_ns : 0);
+    put16(o + 32, f->frame.bus + 1);
+    o[34] = f->tx ? BLF_DIR_TX : 0;
+    o[35] = f->frame.length;
+    put32(o + 36, f->frame.ID);
+    memcpy(o + 40, f->frame.data, (f->frame.length > 8) ? 8 : f->frame.length);
+
+    b->len += 48;
+    b->objects++;
+}
+
+/*
+ * The trace of driveCar.
+ */
+
+static int trace_read(Conv *c, ConvFrame *f) {
+    const RecorderRecord *r;
+
+    while(c->next < c->log.count) {
+        r = &c->log.records[c->next++];
+        /* The echo of a sent frame is already in the log as sent. */
+        if((r->kind != RECORD_TX && r->kind != RECORD_RX) || (r->bus & CAN_BUS_RETURNED))
+            continue;
+
+        f->timestamp_ns = r->timestamp_ns + c->offset_ns;
+        f->frame.ID = r->ID;
+        f->frame.bus = r->bus;
+        f->frame.length = (r->length > 8) ? 8 : r->length;
+        f->frame.freq = 0;
+        memcpy(f->frame.data, r->data, 8);
+        f->tx = (r->kind == RECORD_TX);
+        return 1;
+    }
+
+    return 0;
+}
+
+/* candump, BLF and a trace have absolute times. ASC times are relative, only a date line makes them absolute. */
+static int conv_relative(const Conv *c) {
+    return c->from == FORMAT_ASC && ascIn.start_ns == 0;
+}
+
+static void trace_write(Conv *c, const ConvFrame *f) {
+    RecorderHeader *h = c->recorder.header;
+    uint64_t timestamp;
+
+    /* The measurement of an absolute log started at its first frame, not when it is converted. */
+    if(c->written == 0 && !conv_relative(c))
+        h->start_realtime_ns = f->timestamp_ns;
+
+    /* Absolute times are put on the monotonic clock of the log, relative times start at the start of the log. */
+    if(conv_relative(c))
+        timestamp = h->start_monotonic_ns + f->timestamp_ns;
+    else
+        timestamp = h->start_monotonic_ns + (f->timestamp_ns - h->start_realtime_ns);
+
+    recorder_frames(&c->recorder, f->tx ? RECORD_TX : RECORD_RX, &f->frame, 1, timestamp);
+}
+
+/*
+ * The conversion.
+ */
+
+static Format format_of(const char *option, const char *path, uint8_t input) {
+    const char *dot = strrchr(path, '.');
+    char magic[8] = {0};
+    int fd;
+
+    for(int i = 0; option != NULL && i < (int)(sizeof(formatNames) / sizeof(formatNames[0])); i++) {
+        if(strcmp(option, formatNames[i]) == 0)
+            return i;
+    }
+    if(option != NULL)
+        return -1;
+
+    /* The binary formats of an input are recognised by their first bytes, a trace is often called .log too. */
+    fd = input ? open(path, O_RDONLY) : -1;
+    if(fd >= 0) {
+        if(read(fd, magic, sizeof(magic)) < 0)
+            magic[0] = '\0';
+        close(fd);
+        if(memcmp(magic, RECORDER_MAGIC, sizeof(RECORDER_MAGIC)) == 0)
+            return FORMAT_TRACE;
+        if(memcmp(magic, "LOGG", 4) == 0)
+            return FORMAT_BLF;
+    }
+
+    if(dot != NULL && strcmp(dot, ".log") == 0)
+        return FORMAT_CANDUMP;
+    if(dot != NULL && strcmp(dot, ".asc") == 0)
+        return FORMAT_ASC;
+    if(dot != NULL && strcmp(dot, ".blf") == 0)
+        return FORMAT_BLF;
+
+    return FORMAT_TRACE;
+}
+
+static int conv_open(Conv *c, const char *from, const char *to) {
+    if(c->from == FORMAT_TRACE) {
+        if(recorder_load(&c->log, from) < 0)
+            return -1;
+        c->offset_ns = c->log.header->start_realtime_ns - c->log.header->start_monotonic_ns;
+    } else {
+        in.fd = (strcmp(from, "-") == 0) ? STDIN_FILENO : open(from, O_RDONLY);
+        if(in.fd < 0) {
+            fprintf(stderr, "Could not open %s\n", from);
+            return -1;
+        }
+        if(c->from == FORMAT_BLF && blf_open(c) < 0) {
+            fprintf(stderr, "%s is not a BLF file\n", from);
+            return -1;
+        }
+    }
+
+    if(c->to == FORMAT_TRACE)
+        return recorder_open(&c->recorder, to, c->capacity, (c->from == FORMAT_TRACE) ? c->log.header->tick_us : 0);
+    if(c->to == FORMAT_BLF && strcmp(to, "-") == 0) {
+        fprintf(stderr, "BLF can not be written to stdout\n");
+        return -1;
+    }
+
+    out.fd = (strcmp(to, "-") == 0) ? STDOUT_FILENO : open(to, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(out.fd < 0) {
+        fprintf(stderr, "Could not create %s\n", to);
+        return -1;
+    }
+    if(c->to == FORMAT_BLF) {
+        /* Rewritten at the end, with the sizes and the times. */
+        blfOut.size = BLF_HEADER_SIZE;
+        blfOut.uncompressed = BLF_HEADER_SIZE;
+        if(blf_write_header(c) < 0 || lseek(out.fd, BLF_HEADER_SIZE, SEEK_SET) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+static int conv_run(Conv *c) {
+    ConvFrame f;
+    int ret;
+
+    for(;;) {
+        switch(c->from) {
+            case FORMAT_CANDUMP: ret = candump_read(c, &f); break;
+            case FORMAT_ASC: ret = asc_read(c, &f); break;
+            case FORMAT_BLF: ret = blf_read(c, &f); break;
+            default: ret = trace_read(c, &f); break;
+        }
+        if(ret <= 0)
+            return ret;
+        c->read++;
+
+        if(!c->started) {
+            c->started = 1;
+            /* The date of ASC has milliseconds, the times are relative to it. */
+            c->first_ns = f.timestamp_ns / 1000000 * 1000000;
+            if(c->to == FORMAT_ASC)
+                asc_header(c, f.timestamp_ns);
+        }
+
+        switch(c->to) {
+            case FORMAT_CANDUMP: candump_write(c, &f); break;
+            case FORMAT_ASC: asc_write(c, &f); break;
+            case FORMAT_BLF: blf_write(c, &f); break;
+            default: trace_write(c, &f); break;
+        }
+        c->written++;
+    }
+}
+
+static int conv_close(Conv *c) {
+    const char *end = "End TriggerBlock\n";
+    int ret = 0;
+
+    if(c->to == FORMAT_TRACE) {
+        if(recorder_dropped(&c->recorder) > 0) {
+            fprintf(stderr, "The trace is full, dropped %llu frames (-n to make it bigger)\n",
+                    (unsigned long long)recorder_dropped(&c->recorder));
+            ret = -1;
+        }
+        recorder_close(&c->recorder);
+    } else if(out.fd >= 0) {
+        if(c->to == FORMAT_ASC && c->started)
+            out_bytes(&out, end, strlen(end));
+        if(c->to == FORMAT_BLF)
+            blf_flush(c);
+        out_flush(&out);
+        if(c->to == FORMAT_BLF && blf_write_header(c) < 0)
+            out.error = errno;
+        if(out.error != 0) {
+            fprintf(stderr, "Could not write: %s\n", strerror(out.error));
+            ret = -1;
+        }
+        if(out.fd != STDOUT_FILENO)
+            close(out.fd);
+    }
+
+    if(c->from == FORMAT_TRACE)
+        recorder_unload(&c->log);
+    else if(in.fd >= 0 && in.fd != STDIN_FILENO)
+        close(in.fd);
+    if(c->from == FORMAT_BLF)
+        inflateEnd(&blfIn.z);
+
+    return ret;
+}
+
+static double now_s(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    const char *from = NULL, *to = NULL;
+    Conv c;
+    double start, wall;
+    int opt, ret;
+
+    memset(&c, 0, sizeof(c));
+    c.prefix = "can";
+    c.capacity = DEFAULT_RECORDS;
+    c.recorder.fd = -1;
+    in.fd = -1;
+    out.fd = -1;
+
+    while((opt = getopt(argc, argv, "f:F:i:n:x")) != -1) {
+        switch(opt) {
+            case 'f': from = optarg; break;
+            case 'F': to = optarg; break;
+            case 'i': c.prefix = optarg; break;
+            case 'n': c.capacity = strtoull(optarg, NULL, 0); break;
+            case 'x': c.direction = 1; break;
+            default: optind = argc; break;
+        }
+    }
+    if(argc - optind != 2) {
+        printf("%s [-f <format>] [-F <format>] [-i <prefix>] [-n <records>] [-x] <input> <output>\n"
+               " -f, -F\t Format of the input and of the output: trace, candump, asc or blf\t(default: from the extension)\n"
+               " -i\t Name of the interfaces in candump, followed by the bus\t(default: can)\n"
+               " -n\t Number of records of a written trace\t(default: %d)\n"
+               " -x\t Write the direction (R or T) in candump\n", argv[0], DEFAULT_RECORDS);
+        return 2;
+    }
+
+    c.from = format_of(from, argv[optind], 1);
+    c.to = format_of(to, argv[optind + 1], 0);
+    if((int)c.from < 0 || (int)c.to < 0) {
+        fprintf(stderr, "Unknown format\n");
+        return 2;
+    }
+
+    start = now_s();
+    ret = conv_open(&c, argv[optind], argv[optind + 1]);
+    if(ret == 0)
+        ret = conv_run(&c);
+    if(ret < 0)
+        fprintf(stderr, "Could not read %s after %llu frames\n", argv[optind], (unsigned long long)c.read);
+    if(conv_close(&c) < 0)
+        ret = -1;
+    wall = now_s() - start;
+
+    fprintf(stderr, "%s -> %s: %llu frames, %llu skipped, in %.3f s (%.1f M frames/s)\n", formatNames[c.from],
+            formatNames[c.to], (unsigned long long)c.written, (unsigned long long)c.skipped, wall,
+            (wall > 0) ? c.written / wall / 1e6 : 0.0);
+
+    return (ret < 0) ? 1 : 0;
+}
@@ -0,0 +1,448 @@
+/**
+ * \file dbcgen.c
+ * \date 16 October 2026
+ * \brief Generates C pack and unpack functions from a DBC file.
+ *
+ * For every message a struct with the raw signal values is generated, together with a pack and an unpack function.
+ * All bit positions are resolved here, so the generated functions only contain constant shifts and masks.
+ * For every scaled signal, functions to convert between raw and physical values are generated as well.
+ * Finally the IDs of all messages with a CHECKSUM signal in the last byte are listed, to verify the received frames.
+ *
+ * With -t a test program is generated instead, that packs and unpacks every signal of every message with the edge values of
+ * its raw range and of its physical min and max, on a background of the other signals at their own minimum and maximum.
+ * It fails when a value does not come back, when a signal changes another one, when a byte past the length of the message is
+ * written, or when a physical min or max does not survive fromPhys() and toPhys().
+ *
+ * Usage: dbcgen <file.dbc> <GUARD> > header.h
+ *        dbcgen -t <file.dbc> <header.h> > test.c
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define MAX_MESSAGES    64
+#define MAX_SIGNALS     64
+#define MAX_CHUNKS      9
+#define NAME_LENGTH     64
+
+typedef struct {
+    uint8_t byte;       //!< The data byte of the chunk.
+    uint8_t lo;         //!< The lowest bit of the chunk in the byte.
+    uint8_t width;      //!< The number of bits in the chunk.
+    uint8_t rawShift;   //!< The position of the lowest bit of the chunk in the raw value.
+} Chunk;
+
+typedef struct {
+    char name[NAME_LENGTH];
+    unsigned int start;
+    unsigned int length;
+    char order;         //!< '0' Motorola (big endian), '1' Intel (little endian)
+    char sign;          //!< '+' unsigned, '-' signed
+    double scale;
+    double offset;
+    double min;
+    double max;
+    Chunk chunks[MAX_CHUNKS];
+    int nrChunks;
+} Signal;
+
+typedef struct {
+    char name[NAME_LENGTH];
+    unsigned int ID;
+    unsigned int length;
+    Signal signals[MAX_SIGNALS];
+    int nrSignals;
+} Message;
+
+static Message messages[MAX_MESSAGES];
+static int nrMessages = 0;
+
+static int layout_signal(Signal *s, unsigned int msgLength) {
+    int pos[64];
+    int p = s->start;
+
+    if(s->length == 0 || s->length > 64)
+        return -1;
+
+    if(s->order == '1') {
+        for(unsigned int i = 0; i < s->length; i++)
+            pos[i] = s->start + i;
+    } else {
+        /* The start bit is the most significant bit, walk down in the sawtooth numbering. */
+        for(int i = s->length - 1; i >= 0; i--) {
+            pos[i] = p;
+            p = (p % 8 == 0) ? p + 15 : p - 1;
+        }
+    }
+
+    s->nrChunks = 0;
+    for(unsigned int i = 0; i < s->length; i++) {
+        Chunk *c = (s->nrChunks > 0) ? &s->chunks[s->nrChunks - 1] : NULL;
+
+        if(pos[i] < 0 || pos[i] >= (int)msgLength * 8)
+            return -1;
+
+        if(c != NULL && c->byte == pos[i] / 8 && c->lo + c->width == pos[i] % 8) {
+            c->width++;
+            continue;
+        }
+
+        if(s->nrChunks == MAX_CHUNKS)
+            return -1;
+
+        c = &s->chunks[s->nrChunks++];
+        c->byte = pos[i] / 8;
+        c->lo = pos[i] % 8;
+        c->width = 1;
+        c->rawShift = i;
+    }
+
+    return 0;
+}
+
+static const char *raw_type(const Signal *s, int forceUnsigned) {
+    int bits = (s->length <= 8) ? 8 : (s->length <= 16) ? 16 : (s->length <= 32) ? 32 : 64;
+    static char type[16];
+
+    snprintf(type, sizeof(type), "%sint%d_t", (s->sign == '-' && !forceUnsigned) ? "" : "u", bits);
+    return type;
+}
+
+static int parse(FILE *f) {
+    char line[512];
+    Message *m = NULL;
+    Signal *s;
+    int nr = 0;
+
+    while(fgets(line, sizeof(line), f) != NULL) {
+        nr++;
+
+        if(strncmp(line, "BO_ ", 4) == 0) {
+            if(nrMessages == MAX_MESSAGES)
+                return -1;
+
+            m = &messages[nrMessages++];
+            memset(m, 0, sizeof(Message));
+            if(sscanf(line, "BO_ %u %63[^:]: %u", &m->ID, m->name, &m->length) != 3 || m->length > 8) {
+                fprintf(stderr, "%d: Invalid message\n", nr);
+                return -1;
+            }
+        } else if(strncmp(line, " SG_ ", 5) == 0) {
+            if(m == NULL || m->nrSignals == MAX_SIGNALS)
+                return -1;
+
+            s = &m->signals[m->nrSignals++];
+            memset(s, 0, sizeof(Signal));
+            if(sscanf(line, " SG_ %63s : %u|%u@%c%c (%lf,%lf) [%lf|%lf]", s->name, &s->start, &s->length,
+                      &s->order, &s->sign, &s->scale, &s->offset, &s->min, &s->max) != 9) {
+                fprintf(stderr, "%d: Invalid or multiplexed signal\n", nr);
+                return -1;
+            }
+
+            if(layout_signal(s, m->length) < 0) {
+                fprintf(stderr, "%d: Signal %s does not fit in %s\n", nr, s->name, m->name);
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void generate_message(const Message *m) {
+    const Signal *s;
+    const Chunk *c;
+    int first;
+
+    printf("    /*\n     * %s\n     */\n", m->name);
+    printf("    #define %s_ID %*s0x%03X\n", m->name, 8, "", m->ID);
+    printf("    #define %s_LENGTH %*s%u\n\n", m->name, 4, "", m->length);
+
+    printf("    typedef struct {\n");
+    for(int i = 0; i < m->nrSignals; i++) {
+        s = &m->signals[i];
+        printf("        %-9s %s;%*s//!< %u|%u@%c%c (%g,%g) [%g|%g]\n", raw_type(s, 0), s->name,
+               (int)(24 - strlen(s->name)), "", s->start, s->length, s->order, s->sign,
+               s->scale, s->offset, s->min, s->max);
+    }
+    printf("    } %s_t;\n\n", m->name);
+
+    /* Pack: every byte is one expression of constant shifts and masks. */
+    printf("    static inline void %s_pack(uint8_t data[8], const %s_t *m) {\n", m->name, m->name);
+    for(unsigned int b = 0; b < m->length; b++) {
+        first = 1;
+        printf("        data[%u] = (uint8_t)(", b);
+        for(int i = 0; i < m->nrSignals; i++) {
+            s = &m->signals[i];
+            for(int k = 0; k < s->nrChunks; k++) {
+                c = &s->chunks[k];
+                if(c->byte != b)
+                    continue;
+
+                printf("%s((((%s)m->%s >> %u) & 0x%X) << %u)", first ? "" : "\n                           | ",
+                       raw_type(s, 1), s->name, c->rawShift, (1u << c->width) - 1, c->lo);
+                first = 0;
+            }
+        }
+        printf("%s);\n", first ? "0" : "");
+    }
+    printf("    }\n\n");
+
+    /* Unpack: gather the chunks, sign extend the signed signals. */
+    printf("    static inline void %s_unpack(const uint8_t data[8], %s_t *m) {\n", m->name, m->name);
+    for(int i = 0; i < m->nrSignals; i++) {
+        s = &m->signals[i];
+        int wide = s->length > 32;
+
+        printf("        m->%s = (%s)", s->name, raw_type(s, 0));
+        if(s->sign == '-')
+            printf("((int%d_t)(", wide ? 64 : 32);
+        printf("(");
+        for(int k = 0; k < s->nrChunks; k++) {
+            c = &s->chunks[k];
+            printf("%s((uint%d_t)((data[%u] >> %u) & 0x%X) << %u)", k ? " | " : "", wide ? 64 : 32,
+                   c->byte, c->lo, (1u << c->width) - 1, c->rawShift);
+        }
+        printf(")");
+        if(s->sign == '-')
+            printf(" << %u) >> %u)", (wide ? 64 : 32) - s->length, (wide ? 64 : 32) - s->length);
+        printf(";\n");
+    }
+    printf("    }\n\n");
+
+    /* Physical values of the scaled signals. */
+    for(int i = 0; i < m->nrSignals; i++) {
+        s = &m->signals[i];
+        if(s->scale == 1.0 && s->offset == 0.0)
+            continue;
+
+        printf("    static inline double %s_%s_toPhys(%s raw) {\n", m->name, s->name, raw_type(s, 0));
+        printf("        return raw * %.10g + %.10g;\n", s->scale, s->offset);
+        printf("    }\n\n");
+        printf("    static inline %s %s_%s_fromPhys(double phys) {\n", raw_type(s, 0), m->name, s->name);
+        printf("        double raw = (phys - %.10g) / %.10g;\n", s->offset, s->scale);
+        printf("        return (%s)(raw < 0 ? raw - 0.5 : raw + 0.5);\n", raw_type(s, 0));
+        printf("    }\n\n");
+    }
+}
+
+/* The raw range of a signal, and a C literal for a raw value (INT64_MIN has no literal). */
+static void raw_range(const Signal *s, int64_t *min, uint64_t *max) {
+    if(s->sign == '-') {
+        *min = (s->length == 64) ? INT64_MIN : -((int64_t)1 << (s->length - 1));
+        *max = (s->length == 64) ? (uint64_t)INT64_MAX : ((uint64_t)1 << (s->length - 1)) - 1;
+    } else {
+        *min = 0;
+        *max = (s->length == 64) ? UINT64_MAX : ((uint64_t)1 << s->length) - 1;
+    }
+}
+
+static const char *raw_literal(const Signal *s, int64_t value) {
+    static char literal[32];
+
+    if(s->sign != '-')
+        snprintf(literal, sizeof(literal), "%lluULL", (unsigned long long)value);
+    else if(value == INT64_MIN)
+        snprintf(literal, sizeof(literal), "INT64_MIN");
+    else
+        snprintf(literal, sizeof(literal), "%lldLL", (long long)value);
+    return literal;
+}
+
+/* Is the physical value a raw value of the signal? Then store the raw value. */
+static int phys_to_raw(const Signal *s, double phys, int64_t *raw) {
+    double value = round((phys - s->offset) / s->scale);
+    int64_t min;
+    uint64_t max;
+
+    raw_range(s, &min, &max);
+    if(value < (double)min || value > (double)max)
+        return 0;
+
+    *raw = (int64_t)value;
+    return 1;
+}
+
+static void generate_test(const Message *m) {
+    const Signal *s;
+    int64_t min, raw;
+    uint64_t max;
+
+    printf("static void test_%s(void) {\n", m->name);
+    printf("    %s_t in, out;\n", m->name);
+    printf("    uint8_t data[8];\n\n");
+
+    /* Every value of every signal, on the two backgrounds. */
+    for(int i = 0; i < m->nrSignals; i++) {
+        s = &m->signals[i];
+        raw_range(s, &min, &max);
+
+        printf("    {\n        static const %s values[] = {", raw_type(s, 0));
+        printf("%s, ", raw_literal(s, min));
+        printf("%s, ", raw_literal(s, (int64_t)max));
+        printf("%s, ", raw_literal(s, 0));
+        printf("%s", raw_literal(s, (int64_t)(max >> 1)));
+        if(s->min < s->max && phys_to_raw(s, s->min, &raw))
+            printf(", %s", raw_literal(s, raw));
+        if(s->min < s->max && phys_to_raw(s, s->max, &raw))
+            printf(", %s", raw_literal(s, raw));
+        printf("};\n\n");
+
+        printf("        for(int bg = 0; bg < 2; bg++) {\n");
+        printf("            for(unsigned int v = 0; v < sizeof(values) / sizeof(values[0]); v++) {\n");
+        for(int k = 0; k < m->nrSignals; k++) {
+            raw_range(&m->signals[k], &min, &max);
+            printf("                in.%s = bg ? %s", m->signals[k].name, raw_literal(&m->signals[k], (int64_t)max));
+            printf(" : %s;\n", raw_literal(&m->signals[k], min));
+        }
+        printf("                in.%s = values[v];\n", s->name);
+        printf("                memset(data, 0xA5, sizeof(data));\n");
+        printf("                memset(&out, 0, sizeof(out));\n");
+        printf("                %s_pack(data, &in);\n", m->name);
+        printf("                %s_unpack(data, &out);\n", m->name);
+        printf("                check_tail(\"%s\", \"%s\", data, %s_LENGTH);\n", m->name, s->name, m->name);
+        for(int k = 0; k < m->nrSignals; k++) {
+            printf("                check_raw(\"%s\", \"%s\", \"%s\", (int64_t)values[v], (int64_t)out.%s, (int64_t)in.%s);\n",
+                   m->name, s->name, m->signals[k].name, m->signals[k].name, m->signals[k].name);
+        }
+        printf("            }\n        }\n    }\n");
+    }
+
+    /* The physical min and max through the raw value and back. */
+    for(int i = 0; i < m->nrSignals; i++) {
+        s = &m->signals[i];
+        if((s->scale == 1.0 && s->offset == 0.0) || !(s->min < s->max))
+            continue;
+
+        printf("    check_phys(\"%s\", \"%s\", %.10g, %s_%s_toPhys(%s_%s_fromPhys(%.10g)), %.10g, %d);\n",
+               m->name, s->name, s->min, m->name, s->name, m->name, s->name, s->min, fabs(s->scale), phys_to_raw(s, s->min, &raw));
+        printf("    check_phys(\"%s\", \"%s\", %.10g, %s_%s_toPhys(%s_%s_fromPhys(%.10g)), %.10g, %d);\n",
+               m->name, s->name, s->max, m->name, s->name, m->name, s->name, s->max, fabs(s->scale), phys_to_raw(s, s->max, &raw));
+    }
+
+    printf("}\n\n");
+}
+
+static void generate_tests(const char *dbc, const char *header) {
+    printf("/**\n");
+    printf(" * \\file\n");
+    printf(" * \\brief Round trip test of %s, generated by tools/dbcgen -t from %s. Do not edit.\n", header, dbc);
+    printf(" */\n\n");
+    printf("#include <stdio.h>\n#include <stdint.h>\n#include <string.h>\n#include <math.h>\n\n");
+    printf("#include \"%s\"\n\n", header);
+    printf("static unsigned int checks = 0;\n");
+    printf("static unsigned int failures = 0;\n\n");
+
+    printf("static void check_raw(const char *msg, const char *sig, const char *field, int64_t value, int64_t got, int64_t expected) {\n");
+    printf("    checks++;\n");
+    printf("    if(got != expected && failures++ < 20)\n");
+    printf("        printf(\"%%s.%%s = %%lld: %%s.%%s is %%lld, expected %%lld\\n\", msg, sig, (long long)value,\n");
+    printf("               msg, field, (long long)got, (long long)expected);\n");
+    printf("}\n\n");
+
+    printf("static void check_tail(const char *msg, const char *sig, const uint8_t data[8], int length) {\n");
+    printf("    for(int i = length; i < 8; i++) {\n");
+    printf("        checks++;\n");
+    printf("        if(data[i] != 0xA5 && failures++ < 20)\n");
+    printf("            printf(\"%%s.%%s: byte %%d written, the message has %%d bytes\\n\", msg, sig, i, length);\n");
+    printf("    }\n");
+    printf("}\n\n");
+
+    printf("static void check_phys(const char *msg, const char *sig, double phys, double got, double scale, int representable) {\n");
+    printf("    checks++;\n");
+    printf("    if((!representable || fabs(got - phys) > scale / 2) && failures++ < 20)\n");
+    printf("        printf(\"%%s.%%s: physical %%g comes back as %%g\\n\", msg, sig, phys, got);\n");
+    printf("}\n\n");
+
+    for(int i = 0; i < nrMessages; i++)
+        generate_test(&messages[i]);
+
+    printf("int main(void) {\n");
+    for(int i = 0; i < nrMessages; i++)
+        printf("    test_%s();\n", messages[i].name);
+    printf("\n    printf(\"%%u checks, %%u failed\\n\", checks, failures);\n");
+    printf("    return (failures > 0) ? 1 : 0;\n");
+    printf("}\n");
+}
+
+static int has_checksum(const Message *m) {
+    const Signal *s;
+
+    /* A checksum is an 8 bit signal named CHECKSUM in the last byte. */
+    for(int i = 0; i < m->nrSignals; i++) {
+        s = &m->signals[i];
+        if(strcmp(s->name, "CHECKSUM") == 0 && s->length == 8 && s->nrChunks == 1 && s->chunks[0].byte == m->length - 1)
+            return 1;
+    }
+
+    return 0;
+}
+
+static void generate_checksum_ids(const char *guard) {
+    int first = 1;
+    int count = 0;
+
+    for(int i = 0; i < nrMessages; i++)
+        count += has_checksum(&messages[i]);
+    if(count == 0)
+        return;
+
+    printf("    /*\n     * The messages with a checksum in the last byte.\n     */\n");
+    printf("    static const uint16_t %s_CHECKSUM_IDS[] = {", guard);
+    for(int i = 0; i < nrMessages; i++) {
+        if(!has_checksum(&messages[i]))
+            continue;
+
+        printf("%s0x%03X", first ? "" : ", ", messages[i].ID);
+        first = 0;
+    }
+    printf("};\n");
+}
+
+int main(int argc, char *argv[]) {
+    int test = (argc > 1 && strcmp(argv[1], "-t") == 0);
+    const char *name = argv[0];
+    FILE *f;
+
+    argv += test;
+    argc -= test;
+    if(argc < 3) {
+        fprintf(stderr, "%s <file.dbc> <GUARD>\n%s -t <file.dbc> <header.h>\n", name, name);
+        return 1;
+    }
+
+    f = fopen(argv[1], "r");
+    if(f == NULL) {
+        fprintf(stderr, "Could not open %s\n", argv[1]);
+        return 1;
+    }
+    if(parse(f) < 0) {
+        fclose(f);
+        return 1;
+    }
+    fclose(f);
+
+    if(test) {
+        generate_tests(argv[1], argv[2]);
+        return 0;
+    }
+
+    printf("/**\n");
+    printf(" * \\file\n");
+    printf(" * \\brief Signal pack and unpack functions, generated by tools/dbcgen from %s. Do not edit.\n", argv[1]);
+    printf(" */\n\n");
+    printf("#ifndef %s\n#define %s\n", argv[2], argv[2]);
+    printf("    #include <stdint.h>\n\n");
+
+    for(int i = 0; i < nrMessages; i++)
+        generate_message(&messages[i]);
+
+    generate_checksum_ids(argv[2]);
+
+    printf("#endif\n");
+
+    return 0;
+}
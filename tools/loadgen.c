@@ -0,0 +1,832 @@
+/**
+ * \file loadgen.c
+ * \date 16 October 2026
+ * \brief Load generator to stress the control loop.
+ *
+ * Generates joystick events at a high rate, from a pattern or a script, and received CAN traffic at a configurable load
+ * of the busses. There are two targets:
+ * \code
+ * loop     Run the control loop of driveCar in this process, against the loopback transport (default) or a SocketCAN
+ *          transport. The joystick events go through a pipe into readJoystickBatch(), like from a real joystick. At the end
+ *          the missed ticks, the growth of the queues and the latency histograms are printed.
+ * uinput   Create a virtual gamepad (/dev/uinput) for a driveCar running next to it, and send the CAN traffic to the
+ *          interfaces of -c (for example vcan0). driveCar prints its own statistics when it stops.
+ * \endcode
+ * A load of 100% is 500 kbps of frames with 8 data bytes on every bus, about 4000 frames per second per bus.
+ * \code
+ * tools/loadgen [-d <seconds>] [-r <events/s>] [-p sweep|step|random|<script>] [-L <load %>] [-B <busses>]
+ *               [-t <transport>] [-c <if>[,<if>...]] [-T] [-M <cpu>,<cpu>,<cpu>] [-f <Hz>] [-s <seed>]
+ *               [loop|uinput]
+ * \endcode
+ * A script has one event per line, "a <axis> <value>" or "b <button> <value>", sent one per step and repeated. -f sets
+ * the rate of the control loop of the loop target, like -f of driveCar (default 100 Hz). -T and -M run the loop target
+ * with the threads of driveCar -T and -M: with -M every tick goes through the pipeline, and the dropped and lost ticks
+ * and the deepest queue are printed as well.
+ */
+
+#define _GNU_SOURCE     // pipe2() and F_SETPIPE_SZ
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <linux/input.h>
+#include <linux/joystick.h>
+#include <linux/uinput.h>
+
+#include "canFrame.h"
+#include "canRing.h"
+#include "canCache.h"
+#include "checksum.h"
+#include "control.h"
+#include "joystick.h"
+#include "joystickInput.h"
+#include "latency.h"
+#include "pipeline.h"
+#include "profile.h"
+#include "reactor.h"
+#include "scheduler.h"
+#include "toyotaRav4.h"
+#include "transport.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+#define DEFAULT_PROFILE     "profiles/toyotaRav4.profile"
+#define DEFAULT_RATE        100         //!< The default rate of the control loop in Hz, the default of driveCar.
+#define MAX_RATE            1000        //!< The highest rate of the control loop in Hz, as driveCar.
+#define LOAD_BITRATE        500000      //!< The bitrate of a bus.
+#define LOAD_FRAME_BITS     125         //!< The bits of a frame with 8 data bytes on the bus, with stuffing and interframe space.
+#define LOAD_MAX_BUSSES     3           //!< The maximum number of busses to load.
+#define LOAD_INJECT_US      1000        //!< The period of injecting received frames.
+#define LOAD_INJECT_BATCH   64          //!< The maximum number of frames injected at once.
+#define LOAD_WAKE_NS        100000      //!< The shortest sleep of the joystick generator, faster rates send several steps per wake.
+#define LOAD_STEP_EVENTS    4           //!< The maximum number of events of one step of a pattern.
+#define LOAD_MAX_SCRIPT     4096        //!< The maximum number of lines of a script.
+#define LOAD_RX_RING        16384       //!< The size of the receive ring.
+#define LOAD_PIPE_SIZE      (1 << 20)   //!< The size of the pipe between the generator and the joystick.
+
+/**
+ * \brief Contains one generated joystick event, before it is written in the format of the target.
+ */
+typedef struct {
+    uint8_t button;     //!< 1 for a button, 0 for an axis.
+    uint8_t number;     //!< The number of the axis or button.
+    int16_t value;      //!< The new value.
+} LoadEvent;
+
+/**
+ * \brief Defines the joystick generator, running on its own thread.
+ */
+typedef struct {
+    const char *pattern;            //!< sweep, step, random, or the name of the script.
+    LoadEvent *script;              //!< The events of the script.
+    int scriptLength;               //!< The number of events of the script.
+    uint64_t random;                //!< The state of the random generator.
+    uint8_t buttons[12];            //!< The state of the buttons, to toggle them.
+    uint32_t rate;                  //!< The number of steps per second.
+    int fd;                         //!< The pipe (loop) or the uinput device.
+    uint8_t uinput;                 //!< Write input_events instead of js_events.
+    uint64_t duration_ns;           //!< How long to generate.
+    pthread_t thread;               //!< The generator thread.
+    _Atomic uint8_t running;        //!< Cleared to stop the generator.
+    _Atomic uint64_t events;        //!< The number of events written.
+    _Atomic uint64_t dropped;       //!< The number of events that did not fit in the pipe.
+} LoadJoystick;
+
+/**
+ * \brief Defines the generator of received CAN traffic.
+ */
+typedef struct {
+    double fps;                             //!< The frames per second over all busses.
+    uint8_t busses;                         //!< The number of busses.
+    uint64_t start_ns;                      //!< The start of the traffic.
+    uint64_t sent;                          //!< The number of frames injected.
+    uint64_t dropped;                       //!< The number of frames that could not be injected.
+    uint64_t random;                        //!< The state of the random generator.
+    Transport *t;                           //!< The loopback transport to inject into, NULL if the sockets are used.
+    int sockets[LOAD_MAX_BUSSES];           //!< The raw CAN sockets, one per bus.
+    int nrSockets;                          //!< The number of sockets.
+} LoadCan;
+
+typedef struct {
+    double duration;
+    uint32_t rate;
+    const char *pattern;
+    double load;
+    uint8_t busses;
+    const char *transport;
+    char *interfaces;
+    uint8_t threadedInput;
+    uint64_t seed;
+    const char *target;
+    uint32_t tick_us;
+    uint8_t pipeline;
+    int cpus[PIPELINE_STAGES];
+} LoadParams;
+
+static volatile sig_atomic_t running = 1;
+static void signal_handler(int signal) {
+    running = 0;
+}
+
+static uint64_t load_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static uint64_t load_random(uint64_t *state) {
+    /* xorshift64 */
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/* A triangle from -32767 to 32767 and back, once per period. */
+static int16_t load_triangle(uint64_t step, uint64_t period) {
+    uint64_t phase = step % period;
+    int64_t value = (int64_t)(phase * 4 * 32767 / period);
+
+    if(value > 2 * 32767)
+        value = 4 * 32767 - value;
+    return value - 32767;
+}
+
+static int load_read_script(LoadJoystick *g) {
+    FILE *fp = fopen(g->pattern, "r");
+    char type;
+    int number, value;
+
+    if(fp == NULL)
+        return -1;
+
+    g->script = malloc(LOAD_MAX_SCRIPT * sizeof(LoadEvent));
+    if(g->script == NULL) {
+        fclose(fp);
+        return -1;
+    }
+
+    while(g->scriptLength < LOAD_MAX_SCRIPT && fscanf(fp, " %c %d %d", &type, &number, &value) == 3) {
+        g->script[g->scriptLength].button = (type == 'b');
+        g->script[g->scriptLength].number = number;
+        g->script[g->scriptLength].value = value;
+        g->scriptLength++;
+    }
+    fclose(fp);
+
+    return (g->scriptLength > 0) ? 0 : -1;
+}
+
+/* The events of one step of the pattern. */
+static int load_pattern_step(LoadJoystick *g, uint64_t step, LoadEvent events[]) {
+    uint64_t r;
+    int n = 0;
+
+    if(g->script != NULL) {
+        events[n++] = g->script[step % g->scriptLength];
+        return n;
+    }
+
+    if(strcmp(g->pattern, "step") == 0) {
+        /* Full steering steps at 10 Hz, the lowest bit changes every step so evdev does not drop the events. */
+        events[n++] = (LoadEvent){0, 0, (int16_t)((((step * 10 / g->rate) & 1) ? 32766 : -32766) + (step & 1))};
+    } else if(strcmp(g->pattern, "random") == 0) {
+        r = load_random(&g->random);
+        events[n++] = (LoadEvent){0, (uint8_t)(r % 6), (int16_t)(r >> 16)};
+        if((r >> 40) % 64 == 0) {
+            g->buttons[1 + (r >> 48) % 3] ^= 1;
+            events[n++] = (LoadEvent){1, (uint8_t)(1 + (r >> 48) % 3), g->buttons[1 + (r >> 48) % 3]};
+        }
+    } else {
+        /* sweep: the steering once per second, the other stick once per two seconds, accelerate every other second. */
+        events[n++] = (LoadEvent){0, 0, load_triangle(step, g->rate)};
+        events[n++] = (LoadEvent){0, 1, load_triangle(step, 2 * (uint64_t)g->rate)};
+        if(step % g->rate == 0) {
+            g->buttons[1] ^= 1;
+            events[n++] = (LoadEvent){1, 1, g->buttons[1]};
+        }
+    }
+
+    return n;
+}
+
+static const uint16_t axisCodes[6] = {ABS_X, ABS_Y, ABS_Z, ABS_RX, ABS_RY, ABS_RZ};
+static const uint16_t buttonCodes[12] = {BTN_SOUTH, BTN_EAST, BTN_C, BTN_NORTH, BTN_WEST, BTN_Z,
+                                         BTN_TL, BTN_TR, BTN_TL2, BTN_TR2, BTN_SELECT, BTN_START};
+
+/* Write the events of one step, in the format of the target. */
+static void load_write_step(LoadJoystick *g, const LoadEvent events[], int n, uint64_t now) {
+    struct input_event ie[LOAD_STEP_EVENTS + 1];
+    struct js_event je[LOAD_STEP_EVENTS];
+    ssize_t ret;
+
+    if(g->uinput) {
+        memset(ie, 0, sizeof(ie));
+        for(int i = 0; i < n; i++) {
+            ie[i].type = events[i].button ? EV_KEY : EV_ABS;
+            ie[i].code = events[i].button ? buttonCodes[events[i].number % 12] : axisCodes[events[i].number % 6];
+            ie[i].value = events[i].value;
+        }
+        ie[n].type = EV_SYN;
+        ie[n].code = SYN_REPORT;
+        ret = write(g->fd, ie, (n + 1) * sizeof(struct input_event));
+    } else {
+        for(int i = 0; i < n; i++) {
+            je[i].time = (uint32_t)(now / 1000000);
+            je[i].value = events[i].value;
+            je[i].type = events[i].button ? JS_EVENT_BUTTON : JS_EVENT_AXIS;
+            je[i].number = events[i].number;
+        }
+        ret = write(g->fd, je, n * sizeof(struct js_event));
+    }
+
+    if(ret < 0)
+        atomic_fetch_add_explicit(&g->dropped, n, memory_order_relaxed);
+    else
+        atomic_fetch_add_explicit(&g->events, n, memory_order_relaxed);
+}
+
+static void *load_joystick_worker(void *arg) {
+    LoadJoystick *g = arg;
+    LoadEvent events[LOAD_STEP_EVENTS];
+    uint64_t start = load_now();
+    uint64_t now, due, next, step = 0;
+    struct timespec wake;
+    int n;
+
+    while(atomic_load_explicit(&g->running, memory_order_relaxed)) {
+        now = load_now();
+        if(now - start >= g->duration_ns)
+            break;
+
+        /* Catch up with all steps that are due, then sleep until the next one. */
+        due = (now - start) * g->rate / 1000000000ULL;
+        for(; step <= due; step++) {
+            n = load_pattern_step(g, step, events);
+            load_write_step(g, events, n, now);
+        }
+
+        next = start + step * 1000000000ULL / g->rate;
+        if(next < now + LOAD_WAKE_NS)
+            next = now + LOAD_WAKE_NS;
+        wake.tv_sec = next / 1000000000ULL;
+        wake.tv_nsec = next % 1000000000ULL;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+    }
+
+    return NULL;
+}
+
+static int load_open_sockets(LoadCan *c, char *interfaces) {
+    struct sockaddr_can addr;
+    struct ifreq ifr;
+    char *name;
+
+    for(name = strtok(interfaces, ","); name != NULL && c->nrSockets < LOAD_MAX_BUSSES; name = strtok(NULL, ",")) {
+        int fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+
+        if(fd < 0)
+            return -1;
+        c->sockets[c->nrSockets++] = fd;
+
+        memset(&ifr, 0, sizeof(ifr));
+        strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+        memset(&addr, 0, sizeof(addr));
+        addr.can_family = AF_CAN;
+        if(ioctl(fd, SIOCGIFINDEX, &ifr) < 0)
+            return -1;
+        addr.can_ifindex = ifr.ifr_ifindex;
+        if(bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+/* Inject all frames that are due at this time. */
+static void load_can_inject(LoadCan *c, uint64_t now) {
+    CANFrame frames[LOAD_INJECT_BATCH];
+    struct can_frame cf;
+    uint64_t due = (uint64_t)((now - c->start_ns) * c->fps / 1e9);
+    uint64_t r;
+    int n;
+
+    /* After a long stall, skip the backlog instead of bursting it. */
+    if(due - c->sent > 16 * LOAD_INJECT_BATCH)
+        c->sent = due - 16 * LOAD_INJECT_BATCH;
+
+    while(c->sent < due) {
+        n = (due - c->sent < LOAD_INJECT_BATCH) ? (int)(due - c->sent) : LOAD_INJECT_BATCH;
+        for(int i = 0; i < n; i++) {
+            r = load_random(&c->random);
+            frames[i].ID = 0x100 + r % 0x600;
+            memcpy(frames[i].data, &r, 8);
+            frames[i].bus = (c->sent + i) % c->busses;
+            frames[i].length = 8;
+            frames[i].freq = 0;
+        }
+        checksum_toyota_fill(frames, n);
+
+        if(c->t != NULL) {
+            transport_loopback_inject(c->t, frames, n);
+        } else {
+            for(int i = 0; i < n; i++) {
+                memset(&cf, 0, sizeof(cf));
+                cf.can_id = frames[i].ID;
+                cf.can_dlc = 8;
+                memcpy(cf.data, frames[i].data, 8);
+                if(write(c->sockets[frames[i].bus % c->nrSockets], &cf, sizeof(cf)) < 0)
+                    c->dropped++;
+            }
+        }
+        c->sent += n;
+    }
+}
+
+static void load_can_close(LoadCan *c) {
+    for(int i = 0; i < c->nrSockets; i++)
+        close(c->sockets[i]);
+    c->nrSockets = 0;
+}
+
+static int load_uinput_open(void) {
+    struct uinput_setup setup;
+    struct uinput_abs_setup abs;
+    int fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+
+    if(fd < 0)
+        return -1;
+
+    ioctl(fd, UI_SET_EVBIT, EV_KEY);
+    ioctl(fd, UI_SET_EVBIT, EV_ABS);
+    for(int i = 0; i < 12; i++)
+        ioctl(fd, UI_SET_KEYBIT, buttonCodes[i]);
+    for(int i = 0; i < 6; i++) {
+        ioctl(fd, UI_SET_ABSBIT, axisCodes[i]);
+        memset(&abs, 0, sizeof(abs));
+        abs.code = axisCodes[i];
+        abs.absinfo.minimum = -32767;
+        abs.absinfo.maximum = 32767;
+        if(ioctl(fd, UI_ABS_SETUP, &abs) < 0) {
+            close(fd);
+            return -1;
+        }
+    }
+
+    memset(&setup, 0, sizeof(setup));
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = 0x1234;
+    setup.id.product = 0x5678;
+    strcpy(setup.name, "driveCar load generator");
+    if(ioctl(fd, UI_DEV_SETUP, &setup) < 0 || ioctl(fd, UI_DEV_CREATE) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/* Print the device nodes of the virtual gamepad, to pass to driveCar. */
+static void load_uinput_print(int fd) {
+    char sysname[64], path[128];
+    struct dirent *entry;
+    DIR *dir;
+
+    if(ioctl(fd, UI_GET_SYSNAME(sizeof(sysname)), sysname) < 0)
+        return;
+
+    snprintf(path, sizeof(path), "/sys/devices/virtual/input/%s", sysname);
+    dir = opendir(path);
+    if(dir == NULL)
+        return;
+    while((entry = readdir(dir)) != NULL) {
+        if(strncmp(entry->d_name, "event", 5) == 0 || strncmp(entry->d_name, "js", 2) == 0)
+            printf("Virtual gamepad: /dev/input/%s\n", entry->d_name);
+    }
+    closedir(dir);
+}
+
+static int load_joystick_start(LoadJoystick *g) {
+    atomic_store_explicit(&g->running, 1, memory_order_relaxed);
+    return pthread_create(&g->thread, NULL, load_joystick_worker, g) == 0 ? 0 : -1;
+}
+
+static void load_joystick_stop(LoadJoystick *g) {
+    atomic_store_explicit(&g->running, 0, memory_order_relaxed);
+    pthread_join(g->thread, NULL);
+}
+
+static void load_print_load(const LoadParams *params, const LoadJoystick *g, const LoadCan *c, double seconds) {
+    printf("Joystick: %llu events (%.0f/s), %llu dropped\n", (unsigned long long)atomic_load(&g->events),
+           seconds > 0 ? atomic_load(&g->events) / seconds : 0.0, (unsigned long long)atomic_load(&g->dropped));
+    printf("CAN: %llu frames (%.0f/s on %d busses, %.0f%% of %d kbps), %llu dropped\n", (unsigned long long)c->sent,
+           seconds > 0 ? c->sent / seconds : 0.0, params->busses, params->load, LOAD_BITRATE / 1000,
+           (unsigned long long)c->dropped);
+}
+
+/* Drive a virtual gamepad and the CAN interfaces for a driveCar running next to this process. */
+static int load_run_uinput(LoadParams *params, LoadJoystick *g, LoadCan *c) {
+    struct timespec wake;
+    uint64_t start, next;
+
+    g->uinput = 1;
+    g->fd = load_uinput_open();
+    if(g->fd < 0) {
+        terminalColor(31);
+        printf("Could not create a virtual gamepad (is /dev/uinput writable?)\n");
+        terminalColor(0);
+        return -1;
+    }
+    load_uinput_print(g->fd);
+    /* Give udev and the reader time to open the new device. */
+    sleep(1);
+
+    start = load_now();
+    c->start_ns = start;
+    if(load_joystick_start(g) < 0) {
+        ioctl(g->fd, UI_DEV_DESTROY);
+        close(g->fd);
+        return -1;
+    }
+
+    next = start;
+    while(running && load_now() - start < g->duration_ns) {
+        if(c->nrSockets > 0)
+            load_can_inject(c, load_now());
+
+        next += LOAD_INJECT_US * 1000ULL;
+        wake.tv_sec = next / 1000000000ULL;
+        wake.tv_nsec = next % 1000000000ULL;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+    }
+
+    load_joystick_stop(g);
+    load_print_load(params, g, c, (load_now() - start) / 1e9);
+    ioctl(g->fd, UI_DEV_DESTROY);
+    close(g->fd);
+
+    return 0;
+}
+
+typedef struct {
+    Scheduler *sched;
+    Joystick *js;
+    LoadCan *can;
+    LoadJoystick *g;
+    Transport *t;
+    CANRing *rx_ring;
+    CANRingReader *rx_reader;
+    uint64_t origin;
+    uint64_t maxDepth;
+    uint64_t maxBacklog;
+    uint64_t rxFrames;
+} LoadLoop;
+
+static void onTimer(int fd, uint32_t events, void *ctx) {
+    scheduler_timer_read(((LoadLoop *)ctx)->sched);
+}
+
+static void onInject(int fd, uint32_t events, void *ctx) {
+    LoadLoop *l = ctx;
+    uint64_t expirations;
+
+    if(read(fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+        load_can_inject(l->can, load_now());
+}
+
+static void onJoystick(int fd, uint32_t events, void *ctx) {
+    JoystickEvent batch[JOYSTICK_BATCH];
+    LoadLoop *l = ctx;
+    int n;
+
+    do {
+        n = readJoystickBatch(l->js, batch, JOYSTICK_BATCH);
+        if(n > 0 && l->origin == 0)
+            l->origin = l->js->timestamp_ns;
+    } while(n == JOYSTICK_BATCH);
+}
+
+static void onPipeline(int fd, uint32_t events, void *ctx) {
+    uint64_t ticks;
+
+    if(read(fd, &ticks, sizeof(ticks)) < 0) {}
+}
+
+/* The I/O of one tick, like handleTick() of driveCar without the log and the telemetry. */
+static void load_handle_tick(LoadLoop *l, PipelineTick *tick) {
+    uint64_t depth, backlog;
+
+    /* The queues: frames received but not handled yet, and joystick events generated but not applied yet. */
+    depth = atomic_load_explicit(&l->rx_ring->head, memory_order_acquire) - l->rx_reader->pos;
+    if(depth > l->maxDepth)
+        l->maxDepth = depth;
+    backlog = atomic_load_explicit(&l->g->events, memory_order_relaxed) - tick->js.events;
+    if((int64_t)backlog > (int64_t)l->maxBacklog)
+        l->maxBacklog = backlog;
+
+    while(canring_peek(l->rx_reader) != NULL) {
+        if(canring_release(l->rx_reader) == 0)
+            l->rxFrames++;
+    }
+
+    latency_set_origin(tick->origin_ns);
+    if(tick->frames.length > 0)
+        transport_send_arena(l->t, &tick->frames);
+}
+
+/* Run the control loop of driveCar in this process, with the generated input. */
+static int load_run_loop(LoadParams *params, LoadJoystick *g, LoadCan *c) {
+    static CANCache rx_cache;
+    static Pipeline pipe;
+    PipelineTick tick;
+    PipelineTick *built;
+    struct itimerspec period = {{0, LOAD_INJECT_US * 1000L}, {0, LOAD_INJECT_US * 1000L}};
+    JoystickInput input;
+    ChecksumIdSet rx_checksum;
+    CANRingReader rx_reader;
+    CANRing rx_ring;
+    Joystick js;
+    Transport t;
+    Scheduler sched;
+    const Scheduler *stats = &sched;
+    Reactor reactor;
+    Control control;
+    LoadLoop l;
+    uint64_t handled = 0, start;
+    int pipefd[2] = {-1, -1};
+    int injectFd = -1;
+    int ret = -1;
+
+    memset(&js, 0, sizeof(js));
+    memset(&l, 0, sizeof(l));
+    t.ops = NULL;
+    tick.frames.frames = NULL;
+    tick.dropped = 0;
+    reactor.epfd = -1;
+    sched.timer_fd = -1;
+    rx_ring.slots = NULL;
+    input.started = 0;
+    input.wake_fd = -1;
+    input.events.items = NULL;
+
+    if(transport_open(&t, params->transport) < 0 || arena_init(&tick.frames) < 0)
+        goto end;
+    if(t.ops == &transport_loopback)
+        c->t = &t;
+    else if(c->nrSockets == 0)
+        printf("No -c interfaces, no CAN traffic is generated\n");
+
+    /* The generator writes into a pipe, the loop reads it as a joystick. */
+    if(pipe2(pipefd, O_NONBLOCK | O_CLOEXEC) < 0)
+        goto end;
+    fcntl(pipefd[1], F_SETPIPE_SZ, LOAD_PIPE_SIZE);
+    g->fd = pipefd[1];
+    js.fd = pipefd[0];
+    js.name = "loadgen";
+    js.numberOfAxes = 6;
+    js.numberOfButtons = 12;
+
+    control_setup(&control, 1, 1, params->tick_us);
+    if(reactor_setup(&reactor) < 0)
+        goto end;
+
+    l.sched = &sched;
+    l.js = &js;
+    l.can = c;
+    l.g = g;
+    l.t = &t;
+    l.rx_ring = &rx_ring;
+    l.rx_reader = &rx_reader;
+    if(!params->pipeline) {
+        if(scheduler_setup(&sched, params->tick_us) < 0)
+            goto end;
+        if(reactor_add(&reactor, scheduler_timer_create(&sched), EPOLLIN, onTimer, &l) < 0)
+            goto end;
+    }
+    if(params->threadedInput) {
+        if(jsinput_start(&input, &js) < 0)
+            goto end;
+    } else if(reactor_add(&reactor, js.fd, EPOLLIN, onJoystick, &l) < 0) {
+        goto end;
+    }
+    if(c->t != NULL || c->nrSockets > 0) {
+        injectFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if(injectFd < 0 || timerfd_settime(injectFd, 0, &period, NULL) < 0)
+            goto end;
+        if(reactor_add(&reactor, injectFd, EPOLLIN, onInject, &l) < 0)
+            goto end;
+    }
+    if(transport_add_to_reactor(&t, &reactor) < 0)
+        goto end;
+    if(canring_setup(&rx_ring, LOAD_RX_RING) < 0)
+        goto end;
+    cancache_setup(&rx_cache);
+    setupToyotaRav4Checksums(&rx_checksum);
+    transport_rx_verify(&t, &rx_checksum);
+    canring_reader_setup(&rx_reader, &rx_ring);
+    if(transport_rx_start(&t, &rx_ring, &rx_cache) < 0)
+        goto end;
+    if(params->pipeline) {
+        /* From here on the control law belongs to the control thread. */
+        if(pipeline_start(&pipe, &control, &input, params->tick_us, params->cpus) < 0)
+            goto end;
+        if(reactor_add(&reactor, pipe.event_fd, EPOLLIN, onPipeline, &pipe) < 0)
+            goto end;
+        stats = &pipe.sched;
+    }
+
+    start = load_now();
+    c->start_ns = start;
+    if(load_joystick_start(g) < 0)
+        goto end;
+
+    while(running && load_now() - start < g->duration_ns) {
+        reactor_run_once(&reactor, 100);
+
+        if(params->pipeline) {
+            while((built = pipeline_front(&pipe)) != NULL) {
+                load_handle_tick(&l, built);
+                pipeline_pop(&pipe);
+            }
+        } else if(sched.executed != handled) {
+            handled = sched.executed;
+            tick.tick_ns = load_now();
+
+            if(params->threadedInput)
+                l.origin = jsinput_read(&input, &tick.js);
+            else
+                tick.js = js;
+            tick.origin_ns = l.origin;
+            l.origin = 0;
+
+            pipeline_build(&tick, &control, &sched);
+            load_handle_tick(&l, &tick);
+        }
+    }
+
+    /* The control thread still builds ticks and records their latency, stop it before the statistics are printed. */
+    pipeline_join(&pipe);
+    load_joystick_stop(g);
+    if(params->threadedInput)
+        jsinput_stop(&input);
+
+    printf("\n");
+    load_print_load(params, g, c, (load_now() - start) / 1e9);
+    printf("Joystick events applied: %llu  Max backlog: %llu events\n",
+           (unsigned long long)js.events, (unsigned long long)l.maxBacklog);
+    printf("RX frames handled: %llu  Max ring depth: %llu of %d  Reader overruns: %llu\n", (unsigned long long)l.rxFrames,
+           (unsigned long long)l.maxDepth, LOAD_RX_RING, (unsigned long long)rx_reader.overruns);
+    if(params->pipeline)
+        pipeline_print_stats(&pipe);
+    else
+        scheduler_print_stats(&sched);
+    transport_print_stats(&t);
+    latency_print();
+
+    if(stats->missed > 0) {
+        terminalColor(31);
+        printf("Missed %llu of %llu ticks\n", (unsigned long long)stats->missed, (unsigned long long)stats->ticks);
+        terminalColor(0);
+    } else {
+        terminalColor(32);
+        printf("No missed ticks\n");
+        terminalColor(0);
+    }
+    ret = 0;
+
+    end:
+    pipeline_stop(&pipe);
+    jsinput_stop(&input);
+    scheduler_close(&sched);
+    if(injectFd >= 0)
+        close(injectFd);
+    transport_close(&t);
+    arena_free(&tick.frames);
+    canring_free(&rx_ring);
+    reactor_close(&reactor);
+    for(int i = 0; i < 2; i++) {
+        if(pipefd[i] >= 0)
+            close(pipefd[i]);
+    }
+
+    return ret;
+}
+
+int main(int argc, char *argv[]) {
+    static VehicleProfile profile;
+    LoadParams params = {10.0, 1000, "sweep", 30.0, LOAD_MAX_BUSSES, "loopback", NULL, 0, 0x9E3779B97F4A7C15ULL, "loop",
+                         1000000 / DEFAULT_RATE};
+    LoadJoystick g;
+    LoadCan c;
+    long rate;
+    char *end;
+    int ret;
+    int opt;
+
+    while((opt = getopt(argc, argv, "d:r:p:L:B:t:c:TM:f:s:")) != -1) {
+        switch(opt) {
+            case 'd': params.duration = atof(optarg); break;
+            case 'r': params.rate = atoi(optarg); break;
+            case 'p': params.pattern = optarg; break;
+            case 'L': params.load = atof(optarg); break;
+            case 'B': params.busses = atoi(optarg); break;
+            case 't': params.transport = optarg; break;
+            case 'c': params.interfaces = optarg; break;
+            case 'T': params.threadedInput = 1; break;
+            case 'M':
+                if(sscanf(optarg, "%d,%d,%d", &params.cpus[PIPELINE_INPUT], &params.cpus[PIPELINE_CONTROL],
+                          &params.cpus[PIPELINE_IO]) != PIPELINE_STAGES) {
+                    terminalColor(31);
+                    printf("-M needs the CPU of the input, control and I/O threads, -1 to not pin one\n");
+                    terminalColor(0);
+                    return 2;
+                }
+                params.pipeline = 1;
+                params.threadedInput = 1;
+                break;
+            case 'f':
+                rate = strtol(optarg, &end, 10);
+                if(*end != '\0' || rate <= 0 || rate > MAX_RATE) {
+                    terminalColor(31);
+                    printf("The rate must be 1 to %d Hz\n", MAX_RATE);
+                    terminalColor(0);
+                    return 2;
+                }
+                params.tick_us = 1000000 / rate;
+                break;
+            case 's': params.seed = strtoull(optarg, NULL, 0) | 1; break;
+            default:
+                printf("%s [-d <seconds>] [-r <events/s>] [-p sweep|step|random|<script>] [-L <load %%>] [-B <busses>]\n"
+                       "    [-t <transport>] [-c <if>[,<if>...]] [-T] [-M <cpu>,<cpu>,<cpu>] [-f <Hz>] [-s <seed>] [loop|uinput]\n",
+                       argv[0]);
+                return 2;
+        }
+    }
+    if(optind < argc)
+        params.target = argv[optind];
+    if(params.rate < 1)
+        params.rate = 1;
+    if(params.busses < 1 || params.busses > LOAD_MAX_BUSSES)
+        params.busses = LOAD_MAX_BUSSES;
+    if(params.load < 0)
+        params.load = 0;
+
+    signal(SIGINT, signal_handler);
+
+    memset(&g, 0, sizeof(g));
+    g.pattern = params.pattern;
+    g.random = params.seed;
+    g.rate = params.rate;
+    g.duration_ns = (uint64_t)(params.duration * 1e9);
+    if(strcmp(g.pattern, "sweep") != 0 && strcmp(g.pattern, "step") != 0 && strcmp(g.pattern, "random") != 0 &&
+       load_read_script(&g) < 0) {
+        terminalColor(31);
+        printf("Could not read the script %s\n", g.pattern);
+        terminalColor(0);
+        return 2;
+    }
+
+    memset(&c, 0, sizeof(c));
+    c.busses = params.busses;
+    c.fps = params.load / 100.0 * params.busses * LOAD_BITRATE / LOAD_FRAME_BITS;
+    c.random = params.seed;
+    if(params.interfaces != NULL && load_open_sockets(&c, params.interfaces) < 0) {
+        terminalColor(31);
+        printf("Could not open the CAN interfaces %s\n", params.interfaces);
+        terminalColor(0);
+        load_can_close(&c);
+        return 2;
+    }
+
+    if(strcmp(params.target, "uinput") == 0) {
+        ret = load_run_uinput(&params, &g, &c);
+    } else {
+        ret = profile_load(&profile, DEFAULT_PROFILE, params.tick_us);
+        if(ret >= 0)
+            ret = setupToyotaRav4(&profile);
+        if(ret >= 0)
+            ret = load_run_loop(&params, &g, &c);
+        closeToyotaRav4();
+    }
+
+    load_can_close(&c);
+    free(g.script);
+    return (ret < 0) ? 2 : 0;
+}
@@ -0,0 +1,540 @@
+/**
+ * \file logstat.c
+ * \date 16 October 2026
+ * \brief Statistics of recorded CAN logs.
+ *
+ * Maps logs recorded with driveCar -l (see recorder.h) and calculates, for every sent, received and returned frame per bus
+ * and ID: the count, the rate, the mean period and its jitter (standard deviation), the shortest and longest gap, and the
+ * number of wrong Toyota checksums. Signals can be added, for which a histogram of the values is made.
+ *
+ * The records of a log are split into one chunk per thread. Every thread scans its chunk into its own tables, without any
+ * sharing, and the tables are merged in the order of the chunks afterwards, so the gap between two chunks is counted too.
+ * The checksums are verified in batches with checksum_toyota_verify().
+ * \code
+ * tools/logstat [-j <threads>] [-s <signal>]... [-b <bins>] [-o <prefix>] <log>...
+ * \endcode
+ * A signal is written like in a DBC file, or the comments in toyotaRav4Dbc.h, after the ID of its message, the scaling and
+ * the range are optional:
+ * \code
+ * 0x0AA:7|16@0+ (0.01,-67.67) [0|250]
+ * \endcode
+ * With -o the statistics are also written as <prefix>ids.csv and <prefix>signals.csv, one column per field, for plotting.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <sys/mman.h>
+
+#include "canFrame.h"
+#include "checksum.h"
+#include "recorder.h"
+#include "pandaPool.h"
+#include "toyotaRav4Dbc.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof(array[0]))
+
+#define STAT_KINDS      3           //!< Sent, received and returned (the echo of a sent frame).
+#define STAT_BUSSES     PANDA_POOL_MAX_BUSSES   //!< The number of busses kept apart, all logical busses of a pool.
+#define STAT_KEYS       (STAT_KINDS * STAT_BUSSES * CHECKSUM_ID_COUNT)
+#define STAT_BATCH      256         //!< The number of frames of which the checksum is verified at once.
+#define STAT_MIN_CHUNK  65536       //!< The smallest chunk worth a thread.
+#define MAX_SIGNALS     16          //!< The maximum number of signals with a histogram.
+#define DEFAULT_BINS    20          //!< The default number of bins of a histogram.
+
+static const char *kindNames[STAT_KINDS] = {"tx", "rx", "echo"};
+
+/**
+ * \brief Contains the statistics of the frames of one kind, bus and ID.
+ */
+typedef struct {
+    uint64_t count;             //!< The number of frames.
+    uint64_t first_ns;          //!< The time of the first frame.
+    uint64_t last_ns;           //!< The time of the last frame.
+    uint64_t intervals;         //!< The number of gaps between two frames.
+    double sum_ns;              //!< The sum of the gaps, to calculate the mean period.
+    double sum_sq_ns;           //!< The sum of the squared gaps, to calculate the jitter.
+    int64_t min_ns;             //!< The shortest gap.
+    int64_t max_ns;             //!< The longest gap.
+    uint64_t checksum_errors;   //!< The number of frames with a wrong checksum, verified by this tool.
+    uint64_t flagged;           //!< The number of frames driveCar already flagged with CAN_RX_CHECKSUM_ERROR.
+} IdStats;
+
+/**
+ * \brief Defines a signal of which a histogram is made.
+ */
+typedef struct {
+    char text[64];              //!< The signal as it was given.
+    uint16_t ID;                //!< The ID of the message.
+    uint8_t start;              //!< The start bit, as in a DBC file.
+    uint8_t length;             //!< The number of bits.
+    uint8_t motorola;           //!< Is the signal big endian (@0)?
+    uint8_t isSigned;           //!< Is the signal signed (-)?
+    double factor;              //!< The scaling of the physical value.
+    double offset;              //!< The offset of the physical value.
+    double min;                 //!< The physical value of the start of the first bin.
+    double max;                 //!< The physical value of the end of the last bin.
+} Signal;
+
+/**
+ * \brief Defines a part of a log, scanned by one thread.
+ */
+typedef struct {
+    const RecorderRecord *records;  //!< The records of the log.
+    uint64_t begin;                 //!< The first record of the chunk.
+    uint64_t end;                   //!< The record after the chunk.
+    IdStats *ids;                   //!< The statistics, STAT_KEYS entries.
+    uint64_t *histograms;           //!< The histograms, (bins + 2) per signal: underflow, bins, overflow.
+    uint64_t frames;                //!< The number of frames.
+    uint64_t skipped;               //!< The number of frames not counted (extended ID, bus too high).
+    pthread_t thread;               //!< The thread scanning the chunk.
+    uint8_t started;                //!< Is the thread running?
+} Chunk;
+
+static Signal signals[MAX_SIGNALS];
+static int nrSignals = 0;
+static int bins = DEFAULT_BINS;
+static uint32_t signalMask[CHECKSUM_ID_COUNT];  //!< For every ID the signals of its message, bit n is signal n.
+static ChecksumIdSet checksumIds;
+
+static int stat_key(const RecorderRecord *r) {
+    int kind = (r->kind == RECORD_TX) ? 0 : ((r->bus & CAN_BUS_RETURNED) ? 2 : 1);
+
+    return (kind * STAT_BUSSES + (r->bus & ~CAN_BUS_RETURNED)) * CHECKSUM_ID_COUNT + r->ID;
+}
+
+static void stats_interval(IdStats *s, int64_t gap) {
+    if(s->intervals == 0 || gap < s->min_ns)
+        s->min_ns = gap;
+    if(s->intervals == 0 || gap > s->max_ns)
+        s->max_ns = gap;
+    s->intervals++;
+    s->sum_ns += gap;
+    s->sum_sq_ns += (double)gap * gap;
+}
+
+/* Merge statistics of later frames, join adds the gap between both: set for the next chunk of the same log. */
+static void stats_merge(IdStats *to, const IdStats *from, uint8_t join) {
+    if(from->count == 0)
+        return;
+    if(to->count == 0) {
+        *to = *from;
+        return;
+    }
+
+    if(join)
+        stats_interval(to, (int64_t)(from->first_ns - to->last_ns));
+    if(from->intervals > 0) {
+        if(to->intervals == 0 || from->min_ns < to->min_ns)
+            to->min_ns = from->min_ns;
+        if(to->intervals == 0 || from->max_ns > to->max_ns)
+            to->max_ns = from->max_ns;
+    }
+    to->intervals += from->intervals;
+    to->sum_ns += from->sum_ns;
+    to->sum_sq_ns += from->sum_sq_ns;
+    to->count += from->count;
+    to->last_ns = from->last_ns;
+    to->checksum_errors += from->checksum_errors;
+    to->flagged += from->flagged;
+}
+
+static int signal_bit_next(const Signal *s, int bit) {
+    if(!s->motorola)
+        return bit + 1;
+
+    return (bit % 8 == 0) ? bit + 15 : bit - 1;
+}
+
+static int signal_parse(Signal *s, const char *text) {
+    int id, start, length, n = 0, bit;
+    char order, sign;
+    double raw_min, raw_max;
+
+    memset(s, 0, sizeof(Signal));
+    snprintf(s->text, sizeof(s->text), "%s", text);
+    if(sscanf(text, "%i:%d|%d@%c%c%n", &id, &start, &length, &order, &sign, &n) < 5 || id < 0 ||
+       id >= CHECKSUM_ID_COUNT || start < 0 || start > 63 || length < 1 || length > 32 ||
+       (order != '0' && order != '1') || (sign != '+' && sign != '-'))
+        return -1;
+
+    s->ID = id;
+    s->start = start;
+    s->length = length;
+    s->motorola = (order == '0');
+    s->isSigned = (sign == '-');
+    s->factor = 1;
+    text += n;
+
+    /* Every bit of the signal has to be inside the 8 data bytes. */
+    bit = start;
+    for(int i = 1; i < length; i++) {
+        bit = signal_bit_next(s, bit);
+        if(bit < 0 || bit > 63)
+            return -1;
+    }
+
+    if(sscanf(text, " (%lf,%lf)%n", &s->factor, &s->offset, &n) == 2)
+        text += n;
+    if(s->factor == 0)
+        return -1;
+
+    if(sscanf(text, " [%lf|%lf]", &s->min, &s->max) != 2 || s->max <= s->min) {
+        raw_min = s->isSigned ? -(double)(1ULL << (length - 1)) : 0;
+        raw_max = s->isSigned ? (double)(1ULL << (length - 1)) - 1 : (double)((1ULL << length) - 1);
+        s->min = ((s->factor > 0) ? raw_min : raw_max) * s->factor + s->offset;
+        s->max = ((s->factor > 0) ? raw_max : raw_min) * s->factor + s->offset;
+    }
+
+    return 0;
+}
+
+static int64_t signal_raw(const Signal *s, const uint8_t data[8]) {
+    uint64_t raw = 0;
+    int bit = s->start;
+
+    for(int i = 0; i < s->length; i++) {
+        if(s->motorola)
+            raw = (raw << 1) | ((data[bit / 8] >> (bit % 8)) & 1);
+        else
+            raw |= (uint64_t)((data[bit / 8] >> (bit % 8)) & 1) << i;
+        bit = signal_bit_next(s, bit);
+    }
+
+    if(s->isSigned && (raw >> (s->length - 1)) & 1)
+        raw |= ~0ULL << s->length;
+
+    return (int64_t)raw;
+}
+
+static void signal_count(const Signal *s, uint64_t histogram[], const uint8_t data[8]) {
+    double value = signal_raw(s, data) * s->factor + s->offset;
+    int bin;
+
+    if(value < s->min) {
+        histogram[0]++;
+    } else if(value > s->max) {
+        histogram[bins + 1]++;
+    } else {
+        bin = (int)((value - s->min) / (s->max - s->min) * bins);
+        histogram[1 + ((bin < bins) ? bin : bins - 1)]++;
+    }
+}
+
+static void chunk_verify(Chunk *c, const CANFrame frames[], const int keys[], int length) {
+    uint8_t valid[STAT_BATCH];
+
+    if(checksum_toyota_verify(frames, length, sizeof(CANFrame), valid) == 0)
+        return;
+
+    for(int i = 0; i < length; i++)
+        c->ids[keys[i]].checksum_errors += !valid[i];
+}
+
+static void *chunk_scan(void *arg) {
+    Chunk *c = arg;
+    CANFrame batch[STAT_BATCH];
+    int keys[STAT_BATCH];
+    const RecorderRecord *r;
+    IdStats *s;
+    uint32_t mask;
+    int key, n = 0;
+
+    for(uint64_t i = c->begin; i < c->end; i++) {
+        r = &c->records[i];
+        if(r->kind != RECORD_TX && r->kind != RECORD_RX)
+            continue;
+        if(r->ID >= CHECKSUM_ID_COUNT || (r->bus & ~CAN_BUS_RETURNED) >= STAT_BUSSES || r->length > 8) {
+            c->skipped++;
+            continue;
+        }
+
+        c->frames++;
+        key = stat_key(r);
+        s = &c->ids[key];
+        if(s->count == 0)
+            s->first_ns = r->timestamp_ns;
+        else
+            stats_interval(s, (int64_t)(r->timestamp_ns - s->last_ns));
+        s->last_ns = r->timestamp_ns;
+        s->count++;
+        if(r->flags & CAN_RX_CHECKSUM_ERROR)
+            s->flagged++;
+
+        if(checksum_ids_has(&checksumIds, r->ID) && r->length > 0) {
+            batch[n].ID = r->ID;
+            batch[n].length = r->length;
+            memcpy(batch[n].data, r->data, 8);
+            keys[n++] = key;
+            if(n == STAT_BATCH) {
+                chunk_verify(c, batch, keys, n);
+                n = 0;
+            }
+        }
+
+        /* The echo of a sent frame would count the same value twice. */
+        mask = signalMask[r->ID];
+        if(mask != 0 && !(r->bus & CAN_BUS_RETURNED)) {
+            for(int j = 0; j < nrSignals; j++) {
+                if(mask & (1u << j))
+                    signal_count(&signals[j], c->histograms + j * (bins + 2), r->data);
+            }
+        }
+    }
+    chunk_verify(c, batch, keys, n);
+
+    return NULL;
+}
+
+static int scan_log(const RecorderLog *log, int threads, IdStats *total, uint64_t *histograms, uint64_t *frames,
+                    uint64_t *skipped) {
+    static IdStats joined[STAT_KEYS];
+    Chunk chunks[threads];
+    uint64_t length;
+    int nrChunks, ret = 0;
+
+    nrChunks = (log->count / STAT_MIN_CHUNK < (uint64_t)threads) ? (int)(log->count / STAT_MIN_CHUNK) + 1 : threads;
+    length = (log->count + nrChunks - 1) / nrChunks;
+    madvise((void *)log->map, log->size, MADV_SEQUENTIAL);
+
+    memset(chunks, 0, sizeof(chunks));
+    for(int i = 0; i < nrChunks; i++) {
+        chunks[i].records = log->records;
+        chunks[i].begin = i * length;
+        chunks[i].end = (i + 1 == nrChunks) ? log->count : (i + 1) * length;
+        chunks[i].ids = calloc(STAT_KEYS, sizeof(IdStats));
+        chunks[i].histograms = calloc(nrSignals * (bins + 2) + 1, sizeof(uint64_t));
+        if(chunks[i].ids == NULL || chunks[i].histograms == NULL) {
+            ret = -1;
+            continue;
+        }
+        if(pthread_create(&chunks[i].thread, NULL, chunk_scan, &chunks[i]) == 0)
+            chunks[i].started = 1;
+        else
+            chunk_scan(&chunks[i]);     // On this thread instead.
+
+    }
+
+    /* The chunks of one log are joined in order, the gap between two logs is not a period. */
+    memset(joined, 0, sizeof(joined));
+    for(int i = 0; i < nrChunks; i++) {
+        if(chunks[i].started)
+            pthread_join(chunks[i].thread, NULL);
+        if(chunks[i].ids != NULL && chunks[i].histograms != NULL) {
+            for(int k = 0; k < STAT_KEYS; k++)
+                stats_merge(&joined[k], &chunks[i].ids[k], 1);
+            for(int k = 0; k < nrSignals * (bins + 2); k++)
+                histograms[k] += chunks[i].histograms[k];
+            *frames += chunks[i].frames;
+            *skipped += chunks[i].skipped;
+        }
+        free(chunks[i].ids);
+        free(chunks[i].histograms);
+    }
+    for(int k = 0; k < STAT_KEYS; k++)
+        stats_merge(&total[k], &joined[k], 0);
+
+    return ret;
+}
+
+static double stats_period(const IdStats *s) {
+    return (s->intervals > 0) ? s->sum_ns / s->intervals : 0;
+}
+
+static double stats_jitter(const IdStats *s) {
+    double mean = stats_period(s), variance;
+
+    if(s->intervals < 2)
+        return 0;
+
+    variance = s->sum_sq_ns / s->intervals - mean * mean;
+    return (variance > 0) ? sqrt(variance) : 0;
+}
+
+static void print_ids(const IdStats *total) {
+    const IdStats *s;
+
+    printf("%-4s %3s %5s %10s %9s %11s %11s %11s %11s %8s %8s\n", "kind", "bus", "ID", "count", "rate Hz", "period ms",
+           "jitter ms", "min ms", "max ms", "bad sum", "flagged");
+    for(int k = 0; k < STAT_KEYS; k++) {
+        s = &total[k];
+        if(s->count == 0)
+            continue;
+
+        printf("%-4s %3d 0x%03x %10llu %9.2f %11.3f %11.3f %11.3f %11.3f %8llu %8llu\n",
+               kindNames[k / (STAT_BUSSES * CHECKSUM_ID_COUNT)], (k / CHECKSUM_ID_COUNT) % STAT_BUSSES, k % CHECKSUM_ID_COUNT,
+               (unsigned long long)s->count, (s->intervals > 0) ? 1e9 / stats_period(s) : 0.0, stats_period(s) / 1e6,
+               stats_jitter(s) / 1e6, (s->intervals > 0) ? s->min_ns / 1e6 : 0.0, (s->intervals > 0) ? s->max_ns / 1e6 : 0.0,
+               (unsigned long long)s->checksum_errors, (unsigned long long)s->flagged);
+    }
+}
+
+static void print_histograms(const uint64_t *histograms) {
+    const uint64_t *h;
+    uint64_t most;
+    double width;
+
+    for(int j = 0; j < nrSignals; j++) {
+        h = histograms + j * (bins + 2);
+        width = (signals[j].max - signals[j].min) / bins;
+        most = 1;
+        for(int b = 0; b < bins + 2; b++)
+            most = (h[b] > most) ? h[b] : most;
+
+        printf("\n%s\n", signals[j].text);
+        printf("%12s %12s %10llu\n", "", "< min", (unsigned long long)h[0]);
+        for(int b = 0; b < bins; b++) {
+            printf("%12g %12g %10llu ", signals[j].min + b * width, signals[j].min + (b + 1) * width,
+                   (unsigned long long)h[b + 1]);
+            for(uint64_t i = 0; i < h[b + 1] * 40 / most; i++)
+                putchar('#');
+            putchar('\n');
+        }
+        printf("%12s %12s %10llu\n", "", "> max", (unsigned long long)h[bins + 1]);
+    }
+}
+
+static int write_csv(const char *prefix, const IdStats *total, const uint64_t *histograms) {
+    char path[4096];
+    const IdStats *s;
+    const uint64_t *h;
+    double width;
+    FILE *f;
+
+    snprintf(path, sizeof(path), "%sids.csv", prefix);
+    f = fopen(path, "w");
+    if(f == NULL)
+        return -1;
+    fprintf(f, "kind,bus,id,count,first_ns,last_ns,rate_hz,period_ns,jitter_ns,min_ns,max_ns,checksum_errors,flagged\n");
+    for(int k = 0; k < STAT_KEYS; k++) {
+        s = &total[k];
+        if(s->count == 0)
+            continue;
+        fprintf(f, "%s,%d,%d,%llu,%llu,%llu,%.3f,%.0f,%.0f,%lld,%lld,%llu,%llu\n",
+                kindNames[k / (STAT_BUSSES * CHECKSUM_ID_COUNT)], (k / CHECKSUM_ID_COUNT) % STAT_BUSSES, k % CHECKSUM_ID_COUNT,
+                (unsigned long long)s->count, (unsigned long long)s->first_ns, (unsigned long long)s->last_ns,
+                (s->intervals > 0) ? 1e9 / stats_period(s) : 0.0, stats_period(s), stats_jitter(s),
+                (long long)((s->intervals > 0) ? s->min_ns : 0), (long long)((s->intervals > 0) ? s->max_ns : 0),
+                (unsigned long long)s->checksum_errors, (unsigned long long)s->flagged);
+    }
+    fclose(f);
+
+    if(nrSignals == 0)
+        return 0;
+
+    snprintf(path, sizeof(path), "%ssignals.csv", prefix);
+    f = fopen(path, "w");
+    if(f == NULL)
+        return -1;
+    fprintf(f, "signal,id,from,to,count\n");
+    for(int j = 0; j < nrSignals; j++) {
+        h = histograms + j * (bins + 2);
+        width = (signals[j].max - signals[j].min) / bins;
+        fprintf(f, "%d,%d,-inf,%g,%llu\n", j, signals[j].ID, signals[j].min, (unsigned long long)h[0]);
+        for(int b = 0; b < bins; b++)
+            fprintf(f, "%d,%d,%g,%g,%llu\n", j, signals[j].ID, signals[j].min + b * width, signals[j].min + (b + 1) * width,
+                    (unsigned long long)h[b + 1]);
+        fprintf(f, "%d,%d,%g,inf,%llu\n", j, signals[j].ID, signals[j].max, (unsigned long long)h[bins + 1]);
+    }
+    fclose(f);
+
+    return 0;
+}
+
+static double now_s(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    static IdStats total[STAT_KEYS];
+    const char *prefix = NULL;
+    uint64_t *histograms;
+    uint64_t records = 0, frames = 0, skipped = 0, bytes = 0;
+    int threads = sysconf(_SC_NPROCESSORS_ONLN);
+    RecorderLog log;
+    double start, wall;
+    int opt, ret = 0;
+
+    while((opt = getopt(argc, argv, "j:s:b:o:")) != -1) {
+        switch(opt) {
+            case 'j': threads = atoi(optarg); break;
+            case 'b': bins = atoi(optarg); break;
+            case 'o': prefix = optarg; break;
+            case 's':
+                if(nrSignals == MAX_SIGNALS || signal_parse(&signals[nrSignals], optarg) < 0) {
+                    terminalColor(31);
+                    printf("Invalid signal %s, or more than %d\n", optarg, MAX_SIGNALS);
+                    terminalColor(0);
+                    return 2;
+                }
+                nrSignals++;
+                break;
+            default:
+                optind = argc + 1;
+                break;
+        }
+    }
+    if(optind >= argc) {
+        printf("%s [-j <threads>] [-s <signal>]... [-b <bins>] [-o <prefix>] <log>...\n"
+               " -j\t Number of threads\t(default: all CPUs)\n"
+               " -s\t Make a histogram of a signal, for example -s \"0x0AA:7|16@0+ (0.01,-67.67) [0|250]\"\n"
+               " -b\t Number of bins of the histograms\t(default: %d)\n"
+               " -o\t Also write <prefix>ids.csv and <prefix>signals.csv\n", argv[0], DEFAULT_BINS);
+        return 2;
+    }
+    if(threads < 1)
+        threads = 1;
+    if(bins < 1)
+        bins = DEFAULT_BINS;
+
+    checksum_ids_clear(&checksumIds);
+    for(unsigned int i = 0; i < ARRAY_LENGTH(TOYOTA_RAV4_DBC_CHECKSUM_IDS); i++)
+        checksum_ids_add(&checksumIds, TOYOTA_RAV4_DBC_CHECKSUM_IDS[i]);
+    for(int j = 0; j < nrSignals; j++)
+        signalMask[signals[j].ID] |= 1u << j;
+
+    histograms = calloc(nrSignals * (bins + 2) + 1, sizeof(uint64_t));
+    if(histograms == NULL)
+        return 1;
+
+    start = now_s();
+    for(int i = optind; i < argc; i++) {
+        if(recorder_load(&log, argv[i]) < 0) {
+            ret = 1;
+            continue;
+        }
+        if(scan_log(&log, threads, total, histograms, &frames, &skipped) < 0)
+            ret = 1;
+        records += log.count;
+        bytes += log.size;
+        recorder_unload(&log);
+    }
+    wall = now_s() - start;
+
+    print_ids(total);
+    print_histograms(histograms);
+    printf("\n%llu records, %llu frames (%llu not counted) in %.3f s: %.0f MB/s, %d threads, checksum engine %s\n",
+           (unsigned long long)records, (unsigned long long)frames, (unsigned long long)skipped, wall,
+           (wall > 0) ? bytes / 1e6 / wall : 0.0, threads, checksum_engine());
+
+    if(prefix != NULL && write_csv(prefix, total, histograms) < 0) {
+        terminalColor(31);
+        printf("Could not write %sids.csv\n", prefix);
+        terminalColor(0);
+        ret = 1;
+    }
+
+    free(histograms);
+    return ret;
+}
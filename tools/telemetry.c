@@ -0,0 +1,121 @@
+/**
+ * \file telemetry.c
+ * \date 16 October 2026
+ * \brief Reader of the telemetry of a running driveCar.
+ *
+ * Maps the shared memory of driveCar read-only and prints its state, as text or as CSV. Reading never makes driveCar wait,
+ * see telemetry.h.
+ * \code
+ * tools/telemetry [-n <name>] [-r <Hz>] [-c <count>] [-C]
+ * \endcode
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+
+#include "telemetry.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+#define DEFAULT_RATE 10     //!< The default number of prints per second.
+
+static volatile sig_atomic_t running = 1;
+static void signal_handler(int signal) {
+    running = 0;
+}
+
+static void print_header(uint8_t csv) {
+    if(csv)
+        printf("timestamp_ns,executed,missed,overruns,late_us,max_late_us,build_us,count,steer,steer_count,accel,decel,"
+               "axis0,axis1,buttons,js_events,tx_frames,rx_frames,speed,steer_angle,steer_echo,voltage,started,controls_allowed\n");
+    else
+        printf("%10s %6s %6s %8s %8s %6s %6s %6s %6s %6s %7s %6s %8s %8s %7s %6s %6s %6s %4s\n", "executed", "missed", "late",
+               "build", "count", "steer", "sent", "accel", "decel", "axis0", "buttons", "events", "tx", "rx", "km/h", "angle",
+               "echo", "V", "ctl");
+}
+
+static void print_state(const TelemetryState *s, uint8_t csv) {
+    if(csv) {
+        printf("%llu,%llu,%llu,%llu,%.1f,%.1f,%.1f,%u,%d,%d,%d,%d,%d,%d,%u,%llu,%llu,%llu,%.2f,%.1f,%d,%u,%u,%u\n",
+               (unsigned long long)s->timestamp_ns, (unsigned long long)s->executed, (unsigned long long)s->missed,
+               (unsigned long long)s->overruns, s->late_ns / 1e3, s->max_late_ns / 1e3, s->build_ns / 1e3, s->count,
+               s->steer, s->steer_count, s->accel, s->decel, s->axes[0], s->axes[1], s->buttons,
+               (unsigned long long)s->js_events, (unsigned long long)s->tx_frames, (unsigned long long)s->rx_frames,
+               s->speed * 0.01, s->steer_angle * 1.5, s->steer_echo, s->health.voltage, s->health.started, s->health.controls_allowed);
+    } else {
+        printf("%10llu %6llu %5.0fu %7.1fu %8u %6d %6d %6d %6d %6d %07x %6llu %8llu %8llu %7.2f %6.1f %6d %6u %4u\n",
+               (unsigned long long)s->executed, (unsigned long long)s->missed, s->late_ns / 1e3, s->build_ns / 1e3,
+               s->count, s->steer, s->steer_count, s->accel, s->decel, s->axes[0], s->buttons,
+               (unsigned long long)s->js_events, (unsigned long long)s->tx_frames, (unsigned long long)s->rx_frames,
+               s->speed * 0.01, s->steer_angle * 1.5, s->steer_echo, s->health.voltage, s->health.controls_allowed);
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+    const char *name = TELEMETRY_NAME;
+    const TelemetryBlock *block;
+    TelemetryState state;
+    struct timespec wake;
+    uint64_t last = UINT64_MAX;
+    long count = 0, rate = DEFAULT_RATE;
+    uint8_t csv = 0;
+    int opt;
+
+    while((opt = getopt(argc, argv, "n:r:c:C")) != -1) {
+        switch(opt) {
+            case 'n': name = optarg; break;
+            case 'r': rate = atol(optarg); break;
+            case 'c': count = atol(optarg); break;
+            case 'C': csv = 1; break;
+            default:
+                printf("%s [-n <name>] [-r <Hz>] [-c <count>] [-C]\n"
+                       " -n\t Name of the shared memory\t(default: " TELEMETRY_NAME ")\n"
+                       " -r\t Prints per second\n"
+                       " -c\t Stop after this many prints\t(default: until driveCar stops)\n"
+                       " -C\t Print CSV\n", argv[0]);
+                return 2;
+        }
+    }
+    if(rate < 1)
+        rate = DEFAULT_RATE;
+
+    block = telemetry_attach(name);
+    if(block == NULL) {
+        terminalColor(31);
+        printf("No telemetry %s, is driveCar running?\n", name);
+        terminalColor(0);
+        return 1;
+    }
+
+    signal(SIGINT, signal_handler);
+    print_header(csv);
+
+    clock_gettime(CLOCK_MONOTONIC, &wake);
+    for(long n = 0; running && (count == 0 || n < count); n++) {
+        /* The segment of a stopped driveCar stays mapped, but its process is gone. */
+        if(block->magic != TELEMETRY_MAGIC || (kill(block->pid, 0) < 0 && errno == ESRCH))
+            break;
+
+        if(telemetry_read(block, &state) == 0 && state.timestamp_ns != last) {
+            last = state.timestamp_ns;
+            print_state(&state, csv);
+        }
+
+        wake.tv_nsec += 1000000000L / rate;
+        while(wake.tv_nsec >= 1000000000L) {
+            wake.tv_nsec -= 1000000000L;
+            wake.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+    }
+
+    telemetry_detach(block);
+    return 0;
+}
@@ -1,169 +1,189 @@
+#include <stdio.h>
+
 #include "toyotaRav4.h"
+#include "toyotaRav4Dbc.h"
 
-uint16_t create_checksum(CANFrame *frame) {
-    uint16_t checksum = (frame->ID >> 8) + (frame->ID & 0xFF) + frame->length;
+#define terminalColor(color) printf("\033[%dm", color)
 
-    for(uint8_t i = 0; i < frame->length - 1; i++)
-        checksum += frame->data[i];
+uint16_t create_checksum(CANFrame *frame) {
+    uint16_t checksum = checksum_toyota(frame);
 
     frame->data[frame->length - 1] = checksum;
     return checksum;
 }
 
-int sendStaticVideo(CANFrame frames[], uint16_t count) {
-    const uint16_t addr_vid[] = {
-        0x340, 0x341, 0x342, 0x343, 0x344, 0x345,
-        0x363, 0x364, 0x365, 0x370, 0x371, 0x372,
-        0x373, 0x374, 0x375, 0x380, 0x381, 0x382,
-        0x383
-    };
-
-    const uint8_t length_vid = ARRAY_LENGTH(addr_vid);
-
-    CANFrame static_vid = {0x000, {0x00, 0x03, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00}, 1, 8, 10};
-    uint16_t cks;
-    uint8_t add_length = 0;
-
-    if(count % 10 == 0) {
-        static_vid.data[0] = (count / 10) & 0xFF;
-        cks = create_checksum(&static_vid);
-        for(uint8_t i = 0 ; i < length_vid; i++) {
-            frames[i] = static_vid;
-            frames[i].data[7] = cks + (addr_vid[i] >> 8) + (addr_vid[i] & 0xFF);
-            frames[i].ID = addr_vid[i];
-            add_length++;
-        }
-    }
-
-    return add_length;
+void setupToyotaRav4Checksums(ChecksumIdSet *ids) {
+    checksum_ids_clear(ids);
+    for(unsigned int i = 0; i < ARRAY_LENGTH(TOYOTA_RAV4_DBC_CHECKSUM_IDS); i++)
+        checksum_ids_add(ids, TOYOTA_RAV4_DBC_CHECKSUM_IDS[i]);
 }
 
-int sendStaticCam(CANFrame frames[], uint16_t count) {
-    CANFrame static_cam[] = {
-        {0x367, {0x06, 0x00},                                       0, 2, 40},
-        {0x414, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x17, 0x00},   0, 8, 100},
-        {0x489, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},   0, 8, 100},
-        {0x48A, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},   0, 8, 100},
-        {0x48B, {0x66, 0x06, 0x08, 0x0A, 0x02, 0x00, 0x00, 0x00},   0, 8, 100},
-        {0x4D3, {0x1C, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00},   0, 8, 100},
-        {0x130, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38},         1, 7, 100},
-        {0x240, {0x00, 0x00, 0x10, 0x01, 0x00, 0x10, 0x01, 0x00},   1, 8, 5},
-        {0x241, {0x00, 0x00, 0x10, 0x01, 0x00, 0x10, 0x01, 0x00},   1, 8, 5},
-        {0x244, {0x00, 0x00, 0x10, 0x01, 0x00, 0x10, 0x01, 0x00},   1, 8, 5},
-        {0x245, {0x00, 0x00, 0x10, 0x01, 0x00, 0x10, 0x01, 0x00},   1, 8, 5},
-        {0x248, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01},   1, 8, 5},
-        {0x466, {0x20, 0x20, 0xAD},                                 1, 3, 100}
-    };
-
-    const uint8_t length_cam = ARRAY_LENGTH(static_cam);
-    uint8_t add_length = 0;
+static Schedule schedule_vid;
+static Schedule schedule_cam;
+static Schedule schedule_dsu;
+
+static const ProfileCommand *cmd_steer;
+static const ProfileCommand *cmd_accel;
+static const ProfileCommand *cmd_ui;
+static const ProfileCommand *cmd_fcw;
+
+/* The data of a command is packed by the generated DBC code, which only fits the message it was generated for. */
+static int checkCommand(const VehicleProfile *vp, const ProfileCommand *c, uint16_t ID, uint8_t length) {
+    if(c->ID == ID && c->length == length)
+        return 0;
+
+    terminalColor(31);
+    printf("Profile %s: command %s is 0x%03X with %u bytes, the DBC packs 0x%03X with %u bytes\n",
+           vp->name, c->name, c->ID, c->length, ID, length);
+    terminalColor(0);
+    return -1;
+}
 
-    for(uint8_t i = 0; i < length_cam; i++) {
-        if(count % static_cam[i].freq == 0) {
-            if(static_cam[i].freq == 5)
-                static_cam[i].data[0] = (((count / 5) % 7) + 1) << 5;
-            else if(static_cam[i].ID == 0x489 || static_cam[i].ID == 0x48A)
-                static_cam[i].data[7] = ((static_cam[i].ID & 0x002) << 6) + ((count / 100) % 0xF) + 1;
+int setupToyotaRav4(const VehicleProfile *vp) {
+    cmd_steer = profile_command(vp, "steer");
+    cmd_accel = profile_command(vp, "accel");
+    cmd_ui    = profile_command(vp, "ui");
+    cmd_fcw   = profile_command(vp, "fcw");
+
+    if(cmd_steer == NULL || cmd_accel == NULL || cmd_ui == NULL || cmd_fcw == NULL) {
+        terminalColor(31);
+        printf("Profile %s misses a steer, accel, ui or fcw command\n", vp->name);
+        terminalColor(0);
+        return -1;
+    }
 
-            frames[i] = static_cam[i];
-            add_length++;
-        }
+    if(checkCommand(vp, cmd_steer, STEERING_LKA_ID, STEERING_LKA_LENGTH) < 0 ||
+       checkCommand(vp, cmd_accel, ACC_CONTROL_ID, ACC_CONTROL_LENGTH) < 0 ||
+       checkCommand(vp, cmd_ui, LKAS_HUD_ID, LKAS_HUD_LENGTH) < 0 ||
+       checkCommand(vp, cmd_fcw, ACC_HUD_ID, ACC_HUD_LENGTH) < 0)
+        return -1;
+
+    if(profile_compile_group(vp, "video", &schedule_vid) < 0 ||
+       profile_compile_group(vp, "cam", &schedule_cam) < 0 ||
+       profile_compile_group(vp, "dsu", &schedule_dsu) < 0) {
+        closeToyotaRav4();
+        return -1;
     }
 
-    return add_length;
+    return 0;
 }
 
-int sendStaticDsu(CANFrame frames[], uint16_t count) {
-    CANFrame static_dsu[] = {
-        {0x141, {0x00, 0x00, 0x00, 0x46},                           1, 4, 2},
-        {0x128, {0xF4, 0x01, 0x90, 0x83, 0x00, 0x37},               1, 6, 3},
-        {0x283, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8C},         0, 7, 3},
-        {0x2E6, {0xFF, 0xF8, 0x00, 0x08, 0x7F, 0xE0, 0x00, 0x4E},   0, 8, 3},
-        {0x2E7, {0xA8, 0x9C, 0x31, 0x9C, 0x00, 0x00, 0x00, 0x02},   0, 8, 3},
-        {0x344, {0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x50},   0, 8, 5},
-        {0x160, {0x00, 0x00, 0x08, 0x12, 0x01, 0x31, 0x9C, 0x51},   1, 8, 7},
-        {0x161, {0x00, 0x1E, 0x00, 0x00, 0x00, 0x80, 0x07},         1, 7, 7},
-        {0x33E, {0x0F, 0xFF, 0x26, 0x40, 0x00, 0x1F, 0x00},         0, 7, 20},
-        {0x365, {0x00, 0x00, 0x00, 0x80, 0x03, 0x00, 0x08},         0, 7, 20},
-        {0x366, {0x00, 0x00, 0x4D, 0x82, 0x40, 0x02, 0x00},         0, 7, 20},
-        {0x4CB, {0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},   0, 8, 100},
-        {0x470, {0x00, 0x00, 0x02, 0x7A},                           1, 4, 100}
-    };
+void closeToyotaRav4(void) {
+    schedule_free(&schedule_vid);
+    schedule_free(&schedule_cam);
+    schedule_free(&schedule_dsu);
+}
 
-    const uint8_t length_dsu = ARRAY_LENGTH(static_dsu);
-    uint8_t add_length = 0;
+void readToyotaRav4State(const CANCache *cache, ToyotaRav4State *state) {
+    STEER_ANGLE_SENSOR_t angle;
+    STEERING_LKA_t lka;
+    SPEED_t speed;
+    CANRxFrame rx;
 
-    for(uint8_t i = 0; i < length_dsu; i++) {
-        if(count % static_dsu[i].freq == 0) {
-            frames[i] = static_dsu[i];
-            add_length++;
-        }
+    if(cancache_read(cache, cmd_steer->bus, SPEED_ID, &rx) > 0) {
+        SPEED_unpack(rx.frame.data, &speed);
+        state->speed = speed.SPEED;
+        state->speed_ns = rx.timestamp_ns;
+    }
+    if(cancache_read(cache, cmd_steer->bus, STEER_ANGLE_SENSOR_ID, &rx) > 0) {
+        STEER_ANGLE_SENSOR_unpack(rx.frame.data, &angle);
+        state->steer_angle = angle.STEER_ANGLE;
+        state->steer_angle_ns = rx.timestamp_ns;
+    }
+    if(cancache_read(cache, cmd_steer->bus | CAN_BUS_RETURNED, cmd_steer->ID, &rx) > 0) {
+        STEERING_LKA_unpack(rx.frame.data, &lka);
+        state->steer_echo = lka.STEER_TORQUE_CMD;
+        state->steer_echo_ns = rx.timestamp_ns;
     }
+}
+
+int sendStaticVideo(FrameArena *a, uint32_t count) {
+    return schedule_emit(&schedule_vid, a, count);
+}
+
+int sendStaticCam(FrameArena *a, uint32_t count) {
+    return schedule_emit(&schedule_cam, a, count);
+}
 
-    return add_length;
+int sendStaticDsu(FrameArena *a, uint32_t count) {
+    return schedule_emit(&schedule_dsu, a, count);
 }
 
-int sendSteerCommand(CANFrame frames[], uint16_t count, uint16_t torque) {
-    uint8_t cnt = ((count & 0x3F) << 1) | 0x80;
-    if(torque)
-        cnt |= 1;
+/* Write the checksum of a command message in its last byte. */
+static void command_checksum(const ProfileCommand *cmd, uint8_t data[]) {
+    if(cmd->length > 0)
+        data[cmd->length - 1] = checksum_toyota_data(cmd->ID, data, cmd->length);
+}
 
+int sendSteerCommand(FrameArena *a, uint32_t count, uint16_t torque) {
     /** *************************************
      * Hud:                                 *
      * 0x00 - Regular                       *
      * 0x40 - Actively Steering (beep)      *
      * 0x80 - Actively Steering (no beep)   *
      ************************************* **/
-    CANFrame frame;
-    frame.ID = 0x2E4;
-    frame.length = 5;
-    frame.data[0] = cnt;
-    frame.data[1] = torque >> 8;
-    frame.data[2] = torque & 0xFF;
-    frame.data[3] = 0x00;  // Hud
-    create_checksum(&frame);
-    frames[0] = frame;
-    frames[0].bus = 0;
+    STEERING_LKA_t msg = {
+        .STEER_REQUEST = (torque != 0),
+        .COUNTER = (count / cmd_steer->period) & 0x3F,     // Once per message, at any tick rate
+        .SET_ME_1 = 1,
+        .STEER_TORQUE_CMD = torque,
+        .LKA_STATE = 0x00   // Hud
+    };
+    uint8_t *data;
+
+    if(count % cmd_steer->period != 0)
+        return 0;
+
+    data = arena_add(a, cmd_steer->ID, cmd_steer->bus, cmd_steer->length);
+    if(data == NULL)
+        return 0;
+    STEERING_LKA_pack(data, &msg);
+    command_checksum(cmd_steer, data);
 
     return 1;
 }
 
-int sendAccelCommand(CANFrame frames[], uint16_t count, uint16_t acceleration, uint8_t cancel) {
-    if(count % 3 == 0 || cancel) {
-        frames[0].ID = 0x343;
-        frames[0].length = 8;
-        frames[0].data[0] = acceleration >> 8;
-        frames[0].data[1] = acceleration & 0xFF;
-        frames[0].data[2] = 0x63;
-        frames[0].data[3] = 0xC0 + cancel;
-        frames[0].data[4] = 0x00;
-        frames[0].data[5] = 0x00;
-        frames[0].data[6] = 0x00;
-        create_checksum(&frames[0]);
-        frames[0].bus = 0;
+int sendAccelCommand(FrameArena *a, uint32_t count, uint16_t acceleration, uint8_t cancel) {
+    ACC_CONTROL_t msg = {
+        .ACCEL_CMD = acceleration,
+        .SET_ME_X63 = 0x63,
+        .RELEASE_STANDSTILL = 1,
+        .SET_ME_1 = 1,
+        .CANCEL_REQ = cancel
+    };
+    uint8_t *data;
+
+    if(count % cmd_accel->period == 0 || cancel) {
+        data = arena_add(a, cmd_accel->ID, cmd_accel->bus, cmd_accel->length);
+        if(data == NULL)
+            return 0;
+        ACC_CONTROL_pack(data, &msg);
+        command_checksum(cmd_accel, data);
         return 1;
     }
 
     return 0;
 }
 
-int sendUiCommand(CANFrame frames[], uint16_t count, uint8_t status) {
-    uint8_t sound_1 = status & 0x01;
-    uint8_t sound_2 = (status & 0x02) << 3;
-    uint8_t steer   = (status & 0x04) >> 2;
-
-    if(count % 100 == 0) {
-        frames[0].ID = 0x412;
-        frames[0].length = 8;
-        frames[0].data[0] = 0x54;
-        frames[0].data[1] = 0x04 + steer + sound_2;
-        frames[0].data[2] = 0x0C;
-        frames[0].data[3] = 0x00;
-        frames[0].data[4] = sound_1;
-        frames[0].data[5] = 0x2C;
-        frames[0].data[6] = 0x38;
-        frames[0].data[7] = 0x02;
-        frames[0].bus = 0;
+int sendUiCommand(FrameArena *a, uint32_t count, uint8_t status) {
+    LKAS_HUD_t msg = {
+        .SET_ME_X54 = 0x54,
+        .LKAS_STATUS = (status & 0x04) >> 2,
+        .SET_ME_1 = 1,
+        .REPEATED_BEEPS = (status & 0x02) >> 1,
+        .SET_ME_X0C = 0x0C,
+        .LDA_ALERT = status & 0x01,
+        .SET_ME_X2C = 0x2C,
+        .SET_ME_X38 = 0x38,
+        .SET_ME_X02 = 0x02
+    };
+    uint8_t *data;
+
+    if(count % cmd_ui->period == 0) {
+        data = arena_add(a, cmd_ui->ID, cmd_ui->bus, cmd_ui->length);
+        if(data == NULL)
+            return 0;
+        LKAS_HUD_pack(data, &msg);
 
         return 1;
     }
@@ -171,23 +191,23 @@ int sendUiCommand(CANFrame frames[], uint16_t count, uint8_t status) {
     return 0;
 }
 
-int sendFcwCommand(CANFrame frames[], uint16_t count, uint8_t fcw) {
-    if(count % 100 == 0) {
-        frames[0].ID = 0x411;
-        frames[0].length = 8;
-        frames[0].data[0] = fcw << 4;
-        frames[0].data[1] = 0x20;
-        frames[0].data[2] = 0x00;
-        frames[0].data[3] = 0x00;
-        frames[0].data[4] = 0x10;
-        frames[0].data[5] = 0x00;
-        frames[0].data[6] = 0x80;
-        frames[0].data[7] = 0x00;
-        frames[0].bus = 0;
+int sendFcwCommand(FrameArena *a, uint32_t count, uint8_t fcw) {
+    ACC_HUD_t msg = {
+        .FCW = fcw,
+        .SET_ME_X20 = 0x20,
+        .SET_ME_X10 = 0x10,
+        .SET_ME_X80 = 0x80
+    };
+    uint8_t *data;
+
+    if(count % cmd_fcw->period == 0) {
+        data = arena_add(a, cmd_fcw->ID, cmd_fcw->bus, cmd_fcw->length);
+        if(data == NULL)
+            return 0;
+        ACC_HUD_pack(data, &msg);
 
         return 1;
     }
 
     return 0;
 }
-
@@ -10,69 +10,113 @@
 #ifndef TOYOTA_RAV4
 #define TOYOTA_RAV4
     #include <stdint.h>
-    #include "panda.h"
+    #include "canFrame.h"
+    #include "frameArena.h"
+    #include "schedule.h"
+    #include "profile.h"
+    #include "checksum.h"
+    #include "canCache.h"
 
     #define ARRAY_LENGTH(arr)  (sizeof(arr) / sizeof((arr)[0]))
+
+    /**
+     * \brief Defines the state of the car, from the newest received frames. The values are raw DBC values.
+     */
+    typedef struct {
+        uint16_t speed;             //!< SPEED, in 0.01 km/h.
+        int16_t steer_angle;        //!< STEER_ANGLE, in 1.5 degrees.
+        int16_t steer_echo;         //!< STEER_TORQUE_CMD of the last steering command the CAN device confirmed sending.
+        uint64_t speed_ns;          //!< The time the speed was received, 0 if never.
+        uint64_t steer_angle_ns;    //!< The time the steering angle was received, 0 if never.
+        uint64_t steer_echo_ns;     //!< The time the steering command was sent, 0 if never.
+    } ToyotaRav4State;
+
     /**
+     * \fn int setupToyotaRav4(const VehicleProfile *vp)
+     * \brief Compile the send schedules of the static messages, look up the command messages of the profile and check
+     * them against the messages of the DBC.
+     * Must be called before sending any message. The profile must stay loaded while messages are sent.
+     * \param vp The vehicle profile to send.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void closeToyotaRav4(void)
+     * \brief Free the send schedules of the static messages.
+     *
      * \fn uint16_t create_checksum(CANFrame *frame)
      * \brief Calculate the checksum of the CAN frame.
      * \param frame The frame to calculate the checksum for.
      * \return The calculated checksum.
      *
-     * \fn int sendStaticVideo(CANFrame frames[], uint16_t count)
+     * \fn void setupToyotaRav4Checksums(ChecksumIdSet *ids)
+     * \brief Get the IDs of the messages with a checksum, to verify the received frames.
+     * \param ids The set to fill in.
+     *
+     * \fn void readToyotaRav4State(const CANCache *cache, ToyotaRav4State *state)
+     * \brief Read the speed, the steering angle and the echo of the steering command from the receive cache, without waiting
+     * for the receive path. They are read on the bus the steering command is sent on. A value that was never received is
+     * left as it is.
+     * \param cache The cache the receive path fills.
+     * \param state The state of the car.
+     *
+     * \fn int sendStaticVideo(FrameArena *a, uint32_t count)
      * \brief Send the static messages to replace the video from the camera.
-     * \param frames The array to add the messages to.
-     * \param count The 100Hz counter of the program.
-     * \return Number of messages added.
+     * \param a The arena to add the messages to.
+     * \param count The tick counter of the program.
+     * \return Number of messages added, 0 if they did not fit.
      *
-     * \fn int sendStaticCam(CANFrame frames[], uint16_t count)
+     * \fn int sendStaticCam(FrameArena *a, uint32_t count)
      * \brief Send the static messages to replace the camera.
-     * \param frames The array to add the messages to.
-     * \param count The 100Hz counter of the program.
-     * \return Number of messages added.
+     * \param a The arena to add the messages to.
+     * \param count The tick counter of the program.
+     * \return Number of messages added, 0 if they did not fit.
      *
-     * \fn int sendStaticDsu(CANFrame frames[], uint16_t count)
+     * \fn int sendStaticDsu(FrameArena *a, uint32_t count)
      * \brief Send the static messages to replace the DSU.
-     * \param frames The array to add the messages to.
-     * \param count The 100Hz counter of the program.
-     * \return Number of messages added.
+     * \param a The arena to add the messages to.
+     * \param count The tick counter of the program.
+     * \return Number of messages added, 0 if they did not fit.
      *
-     * \fn int sendSteerCommand(CANFrame frames[], uint16_t count, uint16_t torque)
+     * \fn int sendSteerCommand(FrameArena *a, uint32_t count, uint16_t torque)
      * \brief Send the message to control the steering wheel.
-     * \param frames The array to add the messages to.
-     * \param count The 100Hz counter of the program.
+     * \param a The arena to add the messages to.
+     * \param count The tick counter of the program.
      * \param torque The amount of torque to add to the steering wheel.
-     * \return Number of messages added.
+     * \return Number of messages added, 0 if they did not fit.
      *
-     * \fn int sendAccelCommand(CANFrame frames[], uint16_t count, uint16_t acceleration, uint8_t cancel)
+     * \fn int sendAccelCommand(FrameArena *a, uint32_t count, uint16_t acceleration, uint8_t cancel)
      * \brief Send the message to control the acceleration and braking of the car.
-     * \param frames The array to add the messages to.
-     * \param count The 100Hz counter of the program.
+     * \param a The arena to add the messages to.
+     * \param count The tick counter of the program.
      * \param acceleration The force to accelerate or decelerate with. (Negative is decelerate)
      * \param cancel Bit to cancel the controls and turn of cruise control.
-     * \return Number of messages added.
+     * \return Number of messages added, 0 if they did not fit.
      *
-     * \fn int sendUiCommand(CANFrame frames[], uint16_t count, uint8_t status)
+     * \fn int sendUiCommand(FrameArena *a, uint32_t count, uint8_t status)
      * \brief Send the messages to control the heads up display.
-     * \param frames The array to add the messages to.
-     * \param count The 100Hz counter of the program.
+     * \param a The arena to add the messages to.
+     * \param count The tick counter of the program.
      * \param status The status of the heads up display.
-     * \return Number of messages added.
+     * \return Number of messages added, 0 if they did not fit.
      *
-     * \fn int sendFcwCommand(CANFrame frames[], uint16_t count, uint8_t fcw)
+     * \fn int sendFcwCommand(FrameArena *a, uint32_t count, uint8_t fcw)
      * \brief Send the message to enable or disable Forward Collision Warning.
-     * \param frames The array to add the messages to.
-     * \param count The 100Hz counter of the program.
+     * \param a The arena to add the messages to.
+     * \param count The tick counter of the program.
      * \param fcw Enable/Disable the Forward Collision Warning.
-     * \return Number of messages added.
+     * \return Number of messages added, 0 if they did not fit.
      */
 
+    int setupToyotaRav4(const VehicleProfile *vp);
+    void closeToyotaRav4(void);
     uint16_t create_checksum(CANFrame *frame);
-    int sendStaticVideo(CANFrame frames[], uint16_t count);
-    int sendStaticCam(CANFrame frames[], uint16_t count);
-    int sendStaticDsu(CANFrame frames[], uint16_t count);
-    int sendSteerCommand(CANFrame frames[], uint16_t count, uint16_t torque);
-    int sendAccelCommand(CANFrame frames[], uint16_t count, uint16_t acceleration, uint8_t cancel);
-    int sendUiCommand(CANFrame frames[], uint16_t count, uint8_t status);
-    int sendFcwCommand(CANFrame frames[], uint16_t count, uint8_t fcw);
+    void setupToyotaRav4Checksums(ChecksumIdSet *ids);
+    void readToyotaRav4State(const CANCache *cache, ToyotaRav4State *state);
+    int sendStaticVideo(FrameArena *a, uint32_t count);
+    int sendStaticCam(FrameArena *a, uint32_t count);
+    int sendStaticDsu(FrameArena *a, uint32_t count);
+    int sendSteerCommand(FrameArena *a, uint32_t count, uint16_t torque);
+    int sendAccelCommand(FrameArena *a, uint32_t count, uint16_t acceleration, uint8_t cancel);
+    int sendUiCommand(FrameArena *a, uint32_t count, uint8_t status);
+    int sendFcwCommand(FrameArena *a, uint32_t count, uint8_t fcw);
 #endif
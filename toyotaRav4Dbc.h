@@ -0,0 +1,364 @@
+/**
+ * \file
+ * \brief Signal pack and unpack functions, generated by tools/dbcgen from dbc/toyotaRav4.dbc. Do not edit.
+ */
+
+#ifndef TOYOTA_RAV4_DBC
+#define TOYOTA_RAV4_DBC
+    #include <stdint.h>
+
+    /*
+     * STEER_ANGLE_SENSOR
+     */
+    #define STEER_ANGLE_SENSOR_ID         0x025
+    #define STEER_ANGLE_SENSOR_LENGTH     8
+
+    typedef struct {
+        int16_t   STEER_ANGLE;             //!< 3|12@0- (1.5,0) [-1500|1500]
+        int16_t   STEER_RATE;              //!< 35|12@0- (1,0) [-2000|2000]
+        int8_t    STEER_FRACTION;          //!< 39|4@0- (0.1,0) [-0.7|0.7]
+    } STEER_ANGLE_SENSOR_t;
+
+    static inline void STEER_ANGLE_SENSOR_pack(uint8_t data[8], const STEER_ANGLE_SENSOR_t *m) {
+        data[0] = (uint8_t)(((((uint16_t)m->STEER_ANGLE >> 8) & 0xF) << 0));
+        data[1] = (uint8_t)(((((uint16_t)m->STEER_ANGLE >> 0) & 0xFF) << 0));
+        data[2] = (uint8_t)(0);
+        data[3] = (uint8_t)(0);
+        data[4] = (uint8_t)(((((uint16_t)m->STEER_RATE >> 8) & 0xF) << 0)
+                           | ((((uint8_t)m->STEER_FRACTION >> 0) & 0xF) << 4));
+        data[5] = (uint8_t)(((((uint16_t)m->STEER_RATE >> 0) & 0xFF) << 0));
+        data[6] = (uint8_t)(0);
+        data[7] = (uint8_t)(0);
+    }
+
+    static inline void STEER_ANGLE_SENSOR_unpack(const uint8_t data[8], STEER_ANGLE_SENSOR_t *m) {
+        m->STEER_ANGLE = (int16_t)((int32_t)((((uint32_t)((data[1] >> 0) & 0xFF) << 0) | ((uint32_t)((data[0] >> 0) & 0xF) << 8)) << 20) >> 20);
+        m->STEER_RATE = (int16_t)((int32_t)((((uint32_t)((data[5] >> 0) & 0xFF) << 0) | ((uint32_t)((data[4] >> 0) & 0xF) << 8)) << 20) >> 20);
+        m->STEER_FRACTION = (int8_t)((int32_t)((((uint32_t)((data[4] >> 4) & 0xF) << 0)) << 28) >> 28);
+    }
+
+    static inline double STEER_ANGLE_SENSOR_STEER_ANGLE_toPhys(int16_t raw) {
+        return raw * 1.5 + 0;
+    }
+
+    static inline int16_t STEER_ANGLE_SENSOR_STEER_ANGLE_fromPhys(double phys) {
+        double raw = (phys - 0) / 1.5;
+        return (int16_t)(raw < 0 ? raw - 0.5 : raw + 0.5);
+    }
+
+    static inline double STEER_ANGLE_SENSOR_STEER_FRACTION_toPhys(int8_t raw) {
+        return raw * 0.1 + 0;
+    }
+
+    static inline int8_t STEER_ANGLE_SENSOR_STEER_FRACTION_fromPhys(double phys) {
+        double raw = (phys - 0) / 0.1;
+        return (int8_t)(raw < 0 ? raw - 0.5 : raw + 0.5);
+    }
+
+    /*
+     * WHEEL_SPEEDS
+     */
+    #define WHEEL_SPEEDS_ID         0x0AA
+    #define WHEEL_SPEEDS_LENGTH     8
+
+    typedef struct {
+        uint16_t  WHEEL_SPEED_FR;          //!< 7|16@0+ (0.01,-67.67) [0|250]
+        uint16_t  WHEEL_SPEED_FL;          //!< 23|16@0+ (0.01,-67.67) [0|250]
+        uint16_t  WHEEL_SPEED_RR;          //!< 39|16@0+ (0.01,-67.67) [0|250]
+        uint16_t  WHEEL_SPEED_RL;          //!< 55|16@0+ (0.01,-67.67) [0|250]
+    } WHEEL_SPEEDS_t;
+
+    static inline void WHEEL_SPEEDS_pack(uint8_t data[8], const WHEEL_SPEEDS_t *m) {
+        data[0] = (uint8_t)(((((uint16_t)m->WHEEL_SPEED_FR >> 8) & 0xFF) << 0));
+        data[1] = (uint8_t)(((((uint16_t)m->WHEEL_SPEED_FR >> 0) & 0xFF) << 0));
+        data[2] = (uint8_t)(((((uint16_t)m->WHEEL_SPEED_FL >> 8) & 0xFF) << 0));
+        data[3] = (uint8_t)(((((uint16_t)m->WHEEL_SPEED_FL >> 0) & 0xFF) << 0));
+        data[4] = (uint8_t)(((((uint16_t)m->WHEEL_SPEED_RR >> 8) & 0xFF) << 0));
+        data[5] = (uint8_t)(((((uint16_t)m->WHEEL_SPEED_RR >> 0) & 0xFF) << 0));
+        data[6] = (uint8_t)(((((uint16_t)m->WHEEL_SPEED_RL >> 8) & 0xFF) << 0));
+        data[7] = (uint8_t)(((((uint16_t)m->WHEEL_SPEED_RL >> 0) & 0xFF) << 0));
+    }
+
+    static inline void WHEEL_SPEEDS_unpack(const uint8_t data[8], WHEEL_SPEEDS_t *m) {
+        m->WHEEL_SPEED_FR = (uint16_t)(((uint32_t)((data[1] >> 0) & 0xFF) << 0) | ((uint32_t)((data[0] >> 0) & 0xFF) << 8));
+        m->WHEEL_SPEED_FL = (uint16_t)(((uint32_t)((data[3] >> 0) & 0xFF) << 0) | ((uint32_t)((data[2] >> 0) & 0xFF) << 8));
+        m->WHEEL_SPEED_RR = (uint16_t)(((uint32_t)((data[5] >> 0) & 0xFF) << 0) | ((uint32_t)((data[4] >> 0) & 0xFF) << 8));
+        m->WHEEL_SPEED_RL = (uint16_t)(((uint32_t)((data[7] >> 0) & 0xFF) << 0) | ((uint32_t)((data[6] >> 0) & 0xFF) << 8));
+    }
+
+    static inline double WHEEL_SPEEDS_WHEEL_SPEED_FR_toPhys(uint16_t raw) {
+        return raw * 0.01 + -67.67;
+    }
+
+    static inline uint16_t WHEEL_SPEEDS_WHEEL_SPEED_FR_fromPhys(double phys) {
+        double raw = (phys - -67.67) / 0.01;
+        return (uint16_t)(raw < 0 ? raw - 0.5 : raw + 0.5);
+    }
+
+    static inline double WHEEL_SPEEDS_WHEEL_SPEED_FL_toPhys(uint16_t raw) {
+        return raw * 0.01 + -67.67;
+    }
+
+    static inline uint16_t WHEEL_SPEEDS_WHEEL_SPEED_FL_fromPhys(double phys) {
+        double raw = (phys - -67.67) / 0.01;
+        return (uint16_t)(raw < 0 ? raw - 0.5 : raw + 0.5);
+    }
+
+    static inline double WHEEL_SPEEDS_WHEEL_SPEED_RR_toPhys(uint16_t raw) {
+        return raw * 0.01 + -67.67;
+    }
+
+    static inline uint16_t WHEEL_SPEEDS_WHEEL_SPEED_RR_fromPhys(double phys) {
+        double raw = (phys - -67.67) / 0.01;
+        return (uint16_t)(raw < 0 ? raw - 0.5 : raw + 0.5);
+    }
+
+    static inline double WHEEL_SPEEDS_WHEEL_SPEED_RL_toPhys(uint16_t raw) {
+        return raw * 0.01 + -67.67;
+    }
+
+    static inline uint16_t WHEEL_SPEEDS_WHEEL_SPEED_RL_fromPhys(double phys) {
+        double raw = (phys - -67.67) / 0.01;
+        return (uint16_t)(raw < 0 ? raw - 0.5 : raw + 0.5);
+    }
+
+    /*
+     * SPEED
+     */
+    #define SPEED_ID         0x0B4
+    #define SPEED_LENGTH     8
+
+    typedef struct {
+        uint8_t   ENCODER;                 //!< 39|8@0+ (1,0) [0|255]
+        uint16_t  SPEED;                   //!< 47|16@0+ (0.01,0) [0|250]
+        uint8_t   CHECKSUM;                //!< 63|8@0+ (1,0) [0|255]
+    } SPEED_t;
+
+    static inline void SPEED_pack(uint8_t data[8], const SPEED_t *m) {
+        data[0] = (uint8_t)(0);
+        data[1] = (uint8_t)(0);
+        data[2] = (uint8_t)(0);
+        data[3] = (uint8_t)(0);
+        data[4] = (uint8_t)(((((uint8_t)m->ENCODER >> 0) & 0xFF) << 0));
+        data[5] = (uint8_t)(((((uint16_t)m->SPEED >> 8) & 0xFF) << 0));
+        data[6] = (uint8_t)(((((uint16_t)m->SPEED >> 0) & 0xFF) << 0));
+        data[7] = (uint8_t)(((((uint8_t)m->CHECKSUM >> 0) & 0xFF) << 0));
+    }
+
+    static inline void SPEED_unpack(const uint8_t data[8], SPEED_t *m) {
+        m->ENCODER = (uint8_t)(((uint32_t)((data[4] >> 0) & 0xFF) << 0));
+        m->SPEED = (uint16_t)(((uint32_t)((data[6] >> 0) & 0xFF) << 0) | ((uint32_t)((data[5] >> 0) & 0xFF) << 8));
+        m->CHECKSUM = (uint8_t)(((uint32_t)((data[7] >> 0) & 0xFF) << 0));
+    }
+
+    static inline double SPEED_SPEED_toPhys(uint16_t raw) {
+        return raw * 0.01 + 0;
+    }
+
+    static inline uint16_t SPEED_SPEED_fromPhys(double phys) {
+        double raw = (phys - 0) / 0.01;
+        return (uint16_t)(raw < 0 ? raw - 0.5 : raw + 0.5);
+    }
+
+    /*
+     * PCM_CRUISE
+     */
+    #define PCM_CRUISE_ID         0x1D2
+    #define PCM_CRUISE_LENGTH     8
+
+    typedef struct {
+        uint8_t   GAS_RELEASED;            //!< 4|1@0+ (1,0) [0|1]
+        uint8_t   CRUISE_ACTIVE;           //!< 5|1@0+ (1,0) [0|1]
+        int16_t   ACCEL_NET;               //!< 23|16@0- (0.001,0) [-20|20]
+        uint8_t   CRUISE_STATE;            //!< 55|4@0+ (1,0) [0|15]
+        uint8_t   CHECKSUM;                //!< 63|8@0+ (1,0) [0|255]
+    } PCM_CRUISE_t;
+
+    static inline void PCM_CRUISE_pack(uint8_t data[8], const PCM_CRUISE_t *m) {
+        data[0] = (uint8_t)(((((uint8_t)m->GAS_RELEASED >> 0) & 0x1) << 4)
+                           | ((((uint8_t)m->CRUISE_ACTIVE >> 0) & 0x1) << 5));
+        data[1] = (uint8_t)(0);
+        data[2] = (uint8_t)(((((uint16_t)m->ACCEL_NET >> 8) & 0xFF) << 0));
+        data[3] = (uint8_t)(((((uint16_t)m->ACCEL_NET >> 0) & 0xFF) << 0));
+        data[4] = (uint8_t)(0);
+        data[5] = (uint8_t)(0);
+        data[6] = (uint8_t)(((((uint8_t)m->CRUISE_STATE >> 0) & 0xF) << 4));
+        data[7] = (uint8_t)(((((uint8_t)m->CHECKSUM >> 0) & 0xFF) << 0));
+    }
+
+    static inline void PCM_CRUISE_unpack(const uint8_t data[8], PCM_CRUISE_t *m) {
+        m->GAS_RELEASED = (uint8_t)(((uint32_t)((data[0] >> 4) & 0x1) << 0));
+        m->CRUISE_ACTIVE = (uint8_t)(((uint32_t)((data[0] >> 5) & 0x1) << 0));
+        m->ACCEL_NET = (int16_t)((int32_t)((((uint32_t)((data[3] >> 0) & 0xFF) << 0) | ((uint32_t)((data[2] >> 0) & 0xFF) << 8)) << 16) >> 16);
+        m->CRUISE_STATE = (uint8_t)(((uint32_t)((data[6] >> 4) & 0xF) << 0));
+        m->CHECKSUM = (uint8_t)(((uint32_t)((data[7] >> 0) & 0xFF) << 0));
+    }
+
+    static inline double PCM_CRUISE_ACCEL_NET_toPhys(int16_t raw) {
+        return raw * 0.001 + 0;
+    }
+
+    static inline int16_t PCM_CRUISE_ACCEL_NET_fromPhys(double phys) {
+        double raw = (phys - 0) / 0.001;
+        return (int16_t)(raw < 0 ? raw - 0.5 : raw + 0.5);
+    }
+
+    /*
+     * STEERING_LKA
+     */
+    #define STEERING_LKA_ID         0x2E4
+    #define STEERING_LKA_LENGTH     5
+
+    typedef struct {
+        uint8_t   STEER_REQUEST;           //!< 0|1@0+ (1,0) [0|1]
+        uint8_t   COUNTER;                 //!< 6|6@0+ (1,0) [0|63]
+        uint8_t   SET_ME_1;                //!< 7|1@0+ (1,0) [1|1]
+        int16_t   STEER_TORQUE_CMD;        //!< 15|16@0- (1,0) [-1500|1500]
+        uint8_t   LKA_STATE;               //!< 31|8@0+ (1,0) [0|255]
+        uint8_t   CHECKSUM;                //!< 39|8@0+ (1,0) [0|255]
+    } STEERING_LKA_t;
+
+    static inline void STEERING_LKA_pack(uint8_t data[8], const STEERING_LKA_t *m) {
+        data[0] = (uint8_t)(((((uint8_t)m->STEER_REQUEST >> 0) & 0x1) << 0)
+                           | ((((uint8_t)m->COUNTER >> 0) & 0x3F) << 1)
+                           | ((((uint8_t)m->SET_ME_1 >> 0) & 0x1) << 7));
+        data[1] = (uint8_t)(((((uint16_t)m->STEER_TORQUE_CMD >> 8) & 0xFF) << 0));
+        data[2] = (uint8_t)(((((uint16_t)m->STEER_TORQUE_CMD >> 0) & 0xFF) << 0));
+        data[3] = (uint8_t)(((((uint8_t)m->LKA_STATE >> 0) & 0xFF) << 0));
+        data[4] = (uint8_t)(((((uint8_t)m->CHECKSUM >> 0) & 0xFF) << 0));
+    }
+
+    static inline void STEERING_LKA_unpack(const uint8_t data[8], STEERING_LKA_t *m) {
+        m->STEER_REQUEST = (uint8_t)(((uint32_t)((data[0] >> 0) & 0x1) << 0));
+        m->COUNTER = (uint8_t)(((uint32_t)((data[0] >> 1) & 0x3F) << 0));
+        m->SET_ME_1 = (uint8_t)(((uint32_t)((data[0] >> 7) & 0x1) << 0));
+        m->STEER_TORQUE_CMD = (int16_t)((int32_t)((((uint32_t)((data[2] >> 0) & 0xFF) << 0) | ((uint32_t)((data[1] >> 0) & 0xFF) << 8)) << 16) >> 16);
+        m->LKA_STATE = (uint8_t)(((uint32_t)((data[3] >> 0) & 0xFF) << 0));
+        m->CHECKSUM = (uint8_t)(((uint32_t)((data[4] >> 0) & 0xFF) << 0));
+    }
+
+    /*
+     * ACC_CONTROL
+     */
+    #define ACC_CONTROL_ID         0x343
+    #define ACC_CONTROL_LENGTH     8
+
+    typedef struct {
+        int16_t   ACCEL_CMD;               //!< 7|16@0- (0.001,0) [-20|20]
+        uint8_t   SET_ME_X63;              //!< 23|8@0+ (1,0) [0|255]
+        uint8_t   RELEASE_STANDSTILL;      //!< 31|1@0+ (1,0) [0|1]
+        uint8_t   SET_ME_1;                //!< 30|1@0+ (1,0) [0|1]
+        uint8_t   CANCEL_REQ;              //!< 24|1@0+ (1,0) [0|1]
+        uint8_t   CHECKSUM;                //!< 63|8@0+ (1,0) [0|255]
+    } ACC_CONTROL_t;
+
+    static inline void ACC_CONTROL_pack(uint8_t data[8], const ACC_CONTROL_t *m) {
+        data[0] = (uint8_t)(((((uint16_t)m->ACCEL_CMD >> 8) & 0xFF) << 0));
+        data[1] = (uint8_t)(((((uint16_t)m->ACCEL_CMD >> 0) & 0xFF) << 0));
+        data[2] = (uint8_t)(((((uint8_t)m->SET_ME_X63 >> 0) & 0xFF) << 0));
+        data[3] = (uint8_t)(((((uint8_t)m->RELEASE_STANDSTILL >> 0) & 0x1) << 7)
+                           | ((((uint8_t)m->SET_ME_1 >> 0) & 0x1) << 6)
+                           | ((((uint8_t)m->CANCEL_REQ >> 0) & 0x1) << 0));
+        data[4] = (uint8_t)(0);
+        data[5] = (uint8_t)(0);
+        data[6] = (uint8_t)(0);
+        data[7] = (uint8_t)(((((uint8_t)m->CHECKSUM >> 0) & 0xFF) << 0));
+    }
+
+    static inline void ACC_CONTROL_unpack(const uint8_t data[8], ACC_CONTROL_t *m) {
+        m->ACCEL_CMD = (int16_t)((int32_t)((((uint32_t)((data[1] >> 0) & 0xFF) << 0) | ((uint32_t)((data[0] >> 0) & 0xFF) << 8)) << 16) >> 16);
+        m->SET_ME_X63 = (uint8_t)(((uint32_t)((data[2] >> 0) & 0xFF) << 0));
+        m->RELEASE_STANDSTILL = (uint8_t)(((uint32_t)((data[3] >> 7) & 0x1) << 0));
+        m->SET_ME_1 = (uint8_t)(((uint32_t)((data[3] >> 6) & 0x1) << 0));
+        m->CANCEL_REQ = (uint8_t)(((uint32_t)((data[3] >> 0) & 0x1) << 0));
+        m->CHECKSUM = (uint8_t)(((uint32_t)((data[7] >> 0) & 0xFF) << 0));
+    }
+
+    static inline double ACC_CONTROL_ACCEL_CMD_toPhys(int16_t raw) {
+        return raw * 0.001 + 0;
+    }
+
+    static inline int16_t ACC_CONTROL_ACCEL_CMD_fromPhys(double phys) {
+        double raw = (phys - 0) / 0.001;
+        return (int16_t)(raw < 0 ? raw - 0.5 : raw + 0.5);
+    }
+
+    /*
+     * ACC_HUD
+     */
+    #define ACC_HUD_ID         0x411
+    #define ACC_HUD_LENGTH     8
+
+    typedef struct {
+        uint8_t   FCW;                     //!< 4|1@0+ (1,0) [0|1]
+        uint8_t   SET_ME_X20;              //!< 15|8@0+ (1,0) [0|255]
+        uint8_t   SET_ME_X10;              //!< 39|8@0+ (1,0) [0|255]
+        uint8_t   SET_ME_X80;              //!< 55|8@0+ (1,0) [0|255]
+    } ACC_HUD_t;
+
+    static inline void ACC_HUD_pack(uint8_t data[8], const ACC_HUD_t *m) {
+        data[0] = (uint8_t)(((((uint8_t)m->FCW >> 0) & 0x1) << 4));
+        data[1] = (uint8_t)(((((uint8_t)m->SET_ME_X20 >> 0) & 0xFF) << 0));
+        data[2] = (uint8_t)(0);
+        data[3] = (uint8_t)(0);
+        data[4] = (uint8_t)(((((uint8_t)m->SET_ME_X10 >> 0) & 0xFF) << 0));
+        data[5] = (uint8_t)(0);
+        data[6] = (uint8_t)(((((uint8_t)m->SET_ME_X80 >> 0) & 0xFF) << 0));
+        data[7] = (uint8_t)(0);
+    }
+
+    static inline void ACC_HUD_unpack(const uint8_t data[8], ACC_HUD_t *m) {
+        m->FCW = (uint8_t)(((uint32_t)((data[0] >> 4) & 0x1) << 0));
+        m->SET_ME_X20 = (uint8_t)(((uint32_t)((data[1] >> 0) & 0xFF) << 0));
+        m->SET_ME_X10 = (uint8_t)(((uint32_t)((data[4] >> 0) & 0xFF) << 0));
+        m->SET_ME_X80 = (uint8_t)(((uint32_t)((data[6] >> 0) & 0xFF) << 0));
+    }
+
+    /*
+     * LKAS_HUD
+     */
+    #define LKAS_HUD_ID         0x412
+    #define LKAS_HUD_LENGTH     8
+
+    typedef struct {
+        uint8_t   SET_ME_X54;              //!< 7|8@0+ (1,0) [0|255]
+        uint8_t   LKAS_STATUS;             //!< 8|1@0+ (1,0) [0|1]
+        uint8_t   SET_ME_1;                //!< 10|1@0+ (1,0) [0|1]
+        uint8_t   REPEATED_BEEPS;          //!< 12|1@0+ (1,0) [0|1]
+        uint8_t   SET_ME_X0C;              //!< 23|8@0+ (1,0) [0|255]
+        uint8_t   LDA_ALERT;               //!< 32|1@0+ (1,0) [0|1]
+        uint8_t   SET_ME_X2C;              //!< 47|8@0+ (1,0) [0|255]
+        uint8_t   SET_ME_X38;              //!< 55|8@0+ (1,0) [0|255]
+        uint8_t   SET_ME_X02;              //!< 63|8@0+ (1,0) [0|255]
+    } LKAS_HUD_t;
+
+    static inline void LKAS_HUD_pack(uint8_t data[8], const LKAS_HUD_t *m) {
+        data[0] = (uint8_t)(((((uint8_t)m->SET_ME_X54 >> 0) & 0xFF) << 0));
+        data[1] = (uint8_t)(((((uint8_t)m->LKAS_STATUS >> 0) & 0x1) << 0)
+                           | ((((uint8_t)m->SET_ME_1 >> 0) & 0x1) << 2)
+                           | ((((uint8_t)m->REPEATED_BEEPS >> 0) & 0x1) << 4));
+        data[2] = (uint8_t)(((((uint8_t)m->SET_ME_X0C >> 0) & 0xFF) << 0));
+        data[3] = (uint8_t)(0);
+        data[4] = (uint8_t)(((((uint8_t)m->LDA_ALERT >> 0) & 0x1) << 0));
+        data[5] = (uint8_t)(((((uint8_t)m->SET_ME_X2C >> 0) & 0xFF) << 0));
+        data[6] = (uint8_t)(((((uint8_t)m->SET_ME_X38 >> 0) & 0xFF) << 0));
+        data[7] = (uint8_t)(((((uint8_t)m->SET_ME_X02 >> 0) & 0xFF) << 0));
+    }
+
+    static inline void LKAS_HUD_unpack(const uint8_t data[8], LKAS_HUD_t *m) {
+        m->SET_ME_X54 = (uint8_t)(((uint32_t)((data[0] >> 0) & 0xFF) << 0));
+        m->LKAS_STATUS = (uint8_t)(((uint32_t)((data[1] >> 0) & 0x1) << 0));
+        m->SET_ME_1 = (uint8_t)(((uint32_t)((data[1] >> 2) & 0x1) << 0));
+        m->REPEATED_BEEPS = (uint8_t)(((uint32_t)((data[1] >> 4) & 0x1) << 0));
+        m->SET_ME_X0C = (uint8_t)(((uint32_t)((data[2] >> 0) & 0xFF) << 0));
+        m->LDA_ALERT = (uint8_t)(((uint32_t)((data[4] >> 0) & 0x1) << 0));
+        m->SET_ME_X2C = (uint8_t)(((uint32_t)((data[5] >> 0) & 0xFF) << 0));
+        m->SET_ME_X38 = (uint8_t)(((uint32_t)((data[6] >> 0) & 0xFF) << 0));
+        m->SET_ME_X02 = (uint8_t)(((uint32_t)((data[7] >> 0) & 0xFF) << 0));
+    }
+
+    /*
+     * The messages with a checksum in the last byte.
+     */
+    static const uint16_t TOYOTA_RAV4_DBC_CHECKSUM_IDS[] = {0x0B4, 0x1D2, 0x2E4, 0x343};
+#endif
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "transport.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+static const TransportOps *backends[] = {
+    &transport_panda,
+    &transport_pandas,
+    &transport_socketcan,
+    &transport_loopback
+};
+
+int transport_open(Transport *t, const char *description) {
+    const char *args = strchr(description, ':');
+    size_t length = (args != NULL) ? (size_t)(args - description) : strlen(description);
+    int ret;
+
+    memset(t, 0, sizeof(Transport));
+
+    for(unsigned int i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+        if(strlen(backends[i]->name) != length || strncmp(backends[i]->name, description, length) != 0)
+            continue;
+
+        t->ops = backends[i];
+        ret = t->ops->open(t, (args != NULL) ? args + 1 : "");
+        if(ret < 0)
+            t->ops = NULL;
+        return ret;
+    }
+
+    terminalColor(31);
+    printf("Unknown transport %s\n", description);
+    terminalColor(0);
+    return -1;
+}
+
+void transport_close(Transport *t) {
+    if(t->ops == NULL)
+        return;
+
+    if(t->rx_ring != NULL && t->ops->rx_stop != NULL)
+        t->ops->rx_stop(t);
+    t->ops->close(t);
+    t->ops = NULL;
+    t->backend = NULL;
+}
+
+int transport_add_to_reactor(Transport *t, Reactor *r) {
+    if(t->ops->add_to_reactor == NULL)
+        return 0;
+
+    return t->ops->add_to_reactor(t, r);
+}
+
+int transport_send(Transport *t, CANFrame frames[], int length) {
+    return t->ops->send(t, frames, length);
+}
+
+int transport_send_arena(Transport *t, FrameArena *a) {
+    CANFrame frames[ARENA_MAX_FRAMES];
+    int length = a->length;
+
+    if(t->ops->send_arena != NULL)
+        return t->ops->send_arena(t, a);
+
+    for(int i = 0; i < length; i++)
+        arena_get(a, i, &frames[i]);
+    arena_reset(a);
+
+    return t->ops->send(t, frames, length);
+}
+
+int transport_rx_start(Transport *t, CANRing *ring, CANCache *cache) {
+    t->rx_ring = ring;
+    t->rx_cache = cache;
+
+    if(t->ops->rx_start == NULL)
+        return 0;
+
+    return t->ops->rx_start(t);
+}
+
+void transport_rx_verify(Transport *t, const ChecksumIdSet *ids) {
+    t->rx_checksum = ids;
+}
+
+int transport_get_health(Transport *t, Health *h) {
+    if(t->ops->get_health == NULL)
+        return -1;
+
+    return t->ops->get_health(t, h);
+}
+
+int transport_health_submit(Transport *t, PandaHealthCallback done, void *ctx) {
+    if(t->ops->health_submit == NULL)
+        return -1;
+
+    return t->ops->health_submit(t, done, ctx);
+}
+
+void transport_print_stats(Transport *t) {
+    TransportStats *st = &t->stats;
+
+    if(t->ops->print_stats != NULL) {
+        t->ops->print_stats(t);
+        return;
+    }
+
+    printf("%s TX sent: %llu  Dropped: %llu  Send avg/max: %lld/%lld us\n", t->ops->name,
+           (unsigned long long)st->tx_frames, (unsigned long long)st->tx_dropped,
+           (long long)(st->sends ? st->sum_send_ns / (int64_t)st->sends / 1000 : 0),
+           (long long)(st->max_send_ns / 1000));
+    printf("%s RX frames: %llu  Errors: %llu  Checksum errors: %llu\n", t->ops->name,
+           (unsigned long long)st->rx_frames, (unsigned long long)st->rx_errors,
+           (unsigned long long)st->checksum_errors);
+}
+
+void transport_rx_publish(Transport *t, CANRxFrame *rx) {
+    rx->flags = 0;
+    if(t->rx_checksum != NULL && checksum_ids_has(t->rx_checksum, rx->frame.ID) &&
+       checksum_toyota_verify(&rx->frame, 1, sizeof(CANRingSlot), NULL) != 0) {
+        rx->flags |= CAN_RX_CHECKSUM_ERROR;
+        t->stats.checksum_errors++;
+    }
+
+    if(t->rx_cache != NULL)
+        cancache_update(t->rx_cache, rx);
+    canring_publish(t->rx_ring);
+    t->stats.rx_frames++;
+}
@@ -0,0 +1,174 @@
+/**
+ * \file transport.h
+ * \date 16 October 2026
+ * \brief File containing the device independent CAN transport.
+ *
+ * This file contains the function declarations for sending and receiving CAN frames without knowing the device, as well as the
+ * definition of the Transport struct. A transport is opened from a description:
+ * \code
+ * panda                        The Panda over USB (default)
+ * pandas[:<serial>[@<cpu>],...] Several Pandas, each with its own I/O thread (default all connected Pandas), see pandaPool.h
+ * socketcan:<if>[,<if>...]     Linux SocketCAN, bus n is the n-th interface (for example socketcan:vcan0)
+ * loopback                     In-process, every sent frame is received back with CAN_BUS_RETURNED set
+ * \endcode
+ * All backends write the received frames straight into the same ring and cache, so the rest of the program does not change.
+ */
+
+#ifndef TRANSPORT
+#define TRANSPORT
+    #include <stdint.h>
+    #include "canFrame.h"
+    #include "frameArena.h"
+    #include "canRing.h"
+    #include "canCache.h"
+    #include "checksum.h"
+    #include "reactor.h"
+    #include "panda.h"
+    #include "latency.h"
+
+    typedef struct Transport Transport;
+
+    /**
+     * \brief Defines the functions of a transport backend. A function the backend does not support is NULL.
+     */
+    typedef struct {
+        const char *name;                                               //!< The name used in the description.
+        int (*open)(Transport *t, const char *args);                    //!< Open the device, args is the text after the ':'.
+        void (*close)(Transport *t);                                    //!< Close the device and free the backend.
+        int (*add_to_reactor)(Transport *t, Reactor *r);                //!< Handle the events of the device in an event loop.
+        int (*send)(Transport *t, CANFrame frames[], int length);       //!< Send frames.
+        int (*send_arena)(Transport *t, FrameArena *a);                 //!< Send the frames of an arena, NULL to unpack them for send.
+        int (*rx_start)(Transport *t);                                  //!< Start receiving into the ring of the transport.
+        void (*rx_stop)(Transport *t);                                  //!< Stop receiving.
+        int (*get_health)(Transport *t, Health *h);                     //!< Get the health of the device.
+        int (*health_submit)(Transport *t, PandaHealthCallback done, void *ctx);   //!< Start reading the health, without waiting.
+        void (*print_stats)(Transport *t);                              //!< Print the statistics of the backend.
+    } TransportOps;
+
+    /**
+     * \brief Contains the statistics of the backends without statistics of their own.
+     */
+    typedef struct {
+        uint64_t tx_frames;         //!< The number of frames sent.
+        uint64_t tx_dropped;        //!< The number of frames that could not be sent.
+        uint64_t rx_frames;         //!< The number of frames put in the ring.
+        uint64_t rx_errors;         //!< The number of failed receives.
+        uint64_t checksum_errors;   //!< The number of verified frames with a wrong checksum.
+        int64_t max_send_ns;        //!< The longest time a send took.
+        int64_t sum_send_ns;        //!< The sum of all send times, to calculate the mean.
+        uint64_t sends;             //!< The number of sends.
+    } TransportStats;
+
+    /**
+     * \brief Defines an opened transport.
+     */
+    struct Transport {
+        const TransportOps *ops;            //!< The backend.
+        void *backend;                      //!< The state of the backend.
+        CANRing *rx_ring;                   //!< The ring the received frames are written to, NULL before transport_rx_start().
+        CANCache *rx_cache;                 //!< The cache of the newest frame per ID, NULL if not used.
+        const ChecksumIdSet *rx_checksum;   //!< The IDs of which the checksum is verified, NULL if not used.
+        TransportStats stats;               //!< The statistics, if the backend does not keep its own.
+    };
+
+    extern const TransportOps transport_panda;
+    extern const TransportOps transport_pandas;
+    extern const TransportOps transport_socketcan;
+    extern const TransportOps transport_loopback;
+
+    /**
+     * \fn int transport_open(Transport *t, const char *description)
+     * \brief Open a transport.
+     * \param t Pointer to Transport struct.
+     * \param description The backend and its arguments, see above.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void transport_close(Transport *t)
+     * \brief Stop receiving and close the transport.
+     * \param t Pointer to Transport struct.
+     *
+     * \fn int transport_add_to_reactor(Transport *t, Reactor *r)
+     * \brief Handle the events of the transport in an event loop.
+     * \param t Pointer to Transport struct.
+     * \param r The event loop.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int transport_send(Transport *t, CANFrame frames[], int length)
+     * \brief Send frames, without waiting for them to be on the bus.
+     * \param t Pointer to Transport struct.
+     * \param frames The frames to send.
+     * \param length The number of frames.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int transport_send_arena(Transport *t, FrameArena *a)
+     * \brief Send the frames of an arena, without waiting for them to be on the bus. The arena is empty afterwards.
+     * The Panda sends the buffer of the arena as it is, the other backends get the frames unpacked.
+     * \param t Pointer to Transport struct.
+     * \param a The arena with the frames.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn int transport_rx_start(Transport *t, CANRing *ring, CANCache *cache)
+     * \brief Start receiving CAN frames in the background.
+     * \param t Pointer to Transport struct.
+     * \param ring The ring to write the received frames to.
+     * \param cache The cache to update with every received frame, NULL if not used.
+     * \return 0: Success
+     * \return <0: Fail
+     *
+     * \fn void transport_rx_verify(Transport *t, const ChecksumIdSet *ids)
+     * \brief Verify the Toyota checksum of the received frames with these IDs. Must be called before transport_rx_start().
+     * \param t Pointer to Transport struct.
+     * \param ids The IDs to verify, NULL to not verify.
+     *
+     * \fn int transport_get_health(Transport *t, Health *h)
+     * \brief Get the health of the device.
+     * \param t Pointer to Transport struct.
+     * \param h Pointer to Health struct.
+     * \return 0: Success
+     * \return <0: Fail or not supported
+     *
+     * \fn int transport_health_submit(Transport *t, PandaHealthCallback done, void *ctx)
+     * \brief Start reading the health of the device, without waiting. done is called when the read completes, from the
+     * thread handling the events of the device: the event loop, or an I/O thread of the pandas backend.
+     * \param t Pointer to Transport struct.
+     * \param done Called with the health.
+     * \param ctx Passed to done.
+     * \return 0: Success
+     * \return <0: Fail, not supported, or LIBUSB_ERROR_BUSY if the previous read is still in flight
+     *
+     * \fn void transport_print_stats(Transport *t)
+     * \brief Print the statistics of the transport.
+     * \param t Pointer to Transport struct.
+     *
+     * \fn void transport_rx_publish(Transport *t, CANRxFrame *rx)
+     * \brief Used by the backends: verify, cache and publish a frame that was claimed from the ring with canring_claim().
+     * \param t Pointer to Transport struct.
+     * \param rx The claimed frame, with all fields set.
+     *
+     * \fn int transport_loopback_inject(Transport *t, const CANFrame frames[], int length)
+     * \brief Make frames appear on the bus of a loopback transport, as if the car sent them.
+     * \param t Pointer to Transport struct, opened as loopback.
+     * \param frames The frames to receive.
+     * \param length The number of frames.
+     * \return 0: Success
+     * \return <0: Fail
+     */
+
+    int transport_open(Transport *t, const char *description);
+    void transport_close(Transport *t);
+    int transport_add_to_reactor(Transport *t, Reactor *r);
+    int transport_send(Transport *t, CANFrame frames[], int length);
+    int transport_send_arena(Transport *t, FrameArena *a);
+    int transport_rx_start(Transport *t, CANRing *ring, CANCache *cache);
+    void transport_rx_verify(Transport *t, const ChecksumIdSet *ids);
+    int transport_get_health(Transport *t, Health *h);
+    int transport_health_submit(Transport *t, PandaHealthCallback done, void *ctx);
+    void transport_print_stats(Transport *t);
+
+    void transport_rx_publish(Transport *t, CANRxFrame *rx);
+    int transport_loopback_inject(Transport *t, const CANFrame frames[], int length);
+#endif
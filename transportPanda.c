@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "transport.h"
+#include "panda.h"
+#include "pandaPool.h"
+
+#define TRANSPORT_PANDA_MODE 0x1336     //!< The safety mode the Panda is set up with when none is given.
+
+static int panda_transport_open(Transport *t, const char *args) {
+    Panda *p = calloc(1, sizeof(Panda));
+    int mode = TRANSPORT_PANDA_MODE;
+    int ret;
+
+    if(p == NULL)
+        return -1;
+    if(args[0] != '\0')
+        mode = strtol(args, NULL, 0);
+
+    ret = panda_setup(p, mode);
+    if(ret < 0) {
+        if(p->handle != 0)
+            panda_close(p);
+        else if(p->ctx != NULL)
+            libusb_exit(p->ctx);
+        free(p);
+        return ret;
+    }
+
+    t->backend = p;
+    return 0;
+}
+
+static void panda_transport_close(Transport *t) {
+    Panda *p = t->backend;
+
+    if(p->handle != 0)
+        panda_close(p);
+    free(p);
+}
+
+static int panda_transport_add_to_reactor(Transport *t, Reactor *r) {
+    return panda_add_to_reactor(t->backend, r);
+}
+
+static int panda_transport_send(Transport *t, CANFrame frames[], int length) {
+    return panda_can_send_many(t->backend, frames, length);
+}
+
+static int panda_transport_send_arena(Transport *t, FrameArena *a) {
+    return panda_can_send_arena(t->backend, a);
+}
+
+static int panda_transport_rx_start(Transport *t) {
+    panda_rx_verify(t->backend, t->rx_checksum);
+    return panda_rx_start(t->backend, t->rx_ring, t->rx_cache);
+}
+
+static void panda_transport_rx_stop(Transport *t) {
+    panda_rx_stop(t->backend);
+}
+
+static int panda_transport_get_health(Transport *t, Health *h) {
+    return panda_get_health(t->backend, h);
+}
+
+static int panda_transport_health_submit(Transport *t, PandaHealthCallback done, void *ctx) {
+    return panda_get_health_async(t->backend, done, ctx);
+}
+
+static void panda_transport_print_stats(Transport *t) {
+    panda_print_tx_stats(t->backend);
+    panda_print_rx_stats(t->backend);
+}
+
+/**
+ * \brief Defines the state of the pandas backend.
+ */
+typedef struct {
+    PandaPool pool;         //!< The Pandas.
+    Reactor *reactor;       //!< The event loop handling the received frames, NULL if none.
+} PandasBackend;
+
+/* pandas[:<serial>[@<cpu>][,<serial>[@<cpu>]...]] */
+static int pandas_transport_open(Transport *t, const char *args) {
+    PandasBackend *b = calloc(1, sizeof(PandasBackend));
+    char serials[PANDA_POOL_MAX_DEVICES][PANDA_SERIAL_LENGTH];
+    const char *names[PANDA_POOL_MAX_DEVICES];
+    int cpus[PANDA_POOL_MAX_DEVICES];
+    int pinned = 0;
+    int n = 0;
+    size_t length;
+    char *at;
+    int ret;
+
+    if(b == NULL)
+        return -1;
+
+    while(*args != '\0') {
+        length = strcspn(args, ",");
+        if(n == PANDA_POOL_MAX_DEVICES || length == 0 || length >= PANDA_SERIAL_LENGTH) {
+            free(b);
+            return -1;
+        }
+
+        memcpy(serials[n], args, length);
+        serials[n][length] = '\0';
+        cpus[n] = -1;
+        at = strchr(serials[n], '@');
+        if(at != NULL) {
+            *at = '\0';
+            cpus[n] = atoi(at + 1);
+            pinned = 1;
+        }
+        names[n] = serials[n];
+        n++;
+
+        args += length;
+        if(*args == ',')
+            args++;
+    }
+
+    ret = pandapool_open(&b->pool, (n > 0) ? names : NULL, pinned ? cpus : NULL, n, TRANSPORT_PANDA_MODE);
+    if(ret < 0) {
+        free(b);
+        return ret;
+    }
+
+    t->backend = b;
+    return 0;
+}
+
+static void pandas_transport_close(Transport *t) {
+    PandasBackend *b = t->backend;
+
+    if(b->reactor != NULL)
+        reactor_remove(b->reactor, b->pool.event_fd);
+    pandapool_close(&b->pool);
+    free(b);
+}
+
+/* Move the frames of the I/O threads into the ring of the transport. */
+static void pandas_transport_receive(int fd, uint32_t events, void *ctx) {
+    Transport *t = ctx;
+    PandasBackend *b = t->backend;
+    CANRxFrame frame;
+    CANRxFrame *rx;
+    uint64_t value;
+
+    if(read(fd, &value, sizeof(value)) < 0)
+        return;
+    if(t->rx_ring == NULL)
+        return;
+
+    while(pandapool_receive(&b->pool, &frame)) {
+        rx = canring_claim(t->rx_ring);
+        *rx = frame;
+        transport_rx_publish(t, rx);
+    }
+}
+
+static int pandas_transport_add_to_reactor(Transport *t, Reactor *r) {
+    PandasBackend *b = t->backend;
+    int ret;
+
+    ret = reactor_add(r, b->pool.event_fd, EPOLLIN, pandas_transport_receive, t);
+    if(ret < 0)
+        return ret;
+    b->reactor = r;
+
+    return 0;
+}
+
+static int pandas_transport_send(Transport *t, CANFrame frames[], int length) {
+    PandasBackend *b = t->backend;
+
+    return pandapool_send(&b->pool, frames, length);
+}
+
+static int pandas_transport_rx_start(Transport *t) {
+    PandasBackend *b = t->backend;
+
+    return pandapool_rx_start(&b->pool);
+}
+
+static int pandas_transport_get_health(Transport *t, Health *h) {
+    PandasBackend *b = t->backend;
+
+    return pandapool_get_health(&b->pool, 0, h);
+}
+
+static int pandas_transport_health_submit(Transport *t, PandaHealthCallback done, void *ctx) {
+    PandasBackend *b = t->backend;
+
+    return pandapool_get_health_async(&b->pool, 0, done, ctx);
+}
+
+static void pandas_transport_print_stats(Transport *t) {
+    PandasBackend *b = t->backend;
+
+    pandapool_print_stats(&b->pool);
+    printf("Pool checksum errors: %llu\n", (unsigned long long)t->stats.checksum_errors);
+}
+
+const TransportOps transport_panda = {
+    .name = "panda",
+    .open = panda_transport_open,
+    .close = panda_transport_close,
+    .add_to_reactor = panda_transport_add_to_reactor,
+    .send = panda_transport_send,
+    .send_arena = panda_transport_send_arena,
+    .rx_start = panda_transport_rx_start,
+    .rx_stop = panda_transport_rx_stop,
+    .get_health = panda_transport_get_health,
+    .health_submit = panda_transport_health_submit,
+    .print_stats = panda_transport_print_stats
+};
+
+const TransportOps transport_pandas = {
+    .name = "pandas",
+    .open = pandas_transport_open,
+    .close = pandas_transport_close,
+    .add_to_reactor = pandas_transport_add_to_reactor,
+    .send = pandas_transport_send,
+    .rx_start = pandas_transport_rx_start,
+    .get_health = pandas_transport_get_health,
+    .health_submit = pandas_transport_health_submit,
+    .print_stats = pandas_transport_print_stats
+};
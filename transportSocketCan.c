@@ -0,0 +1,275 @@
+#define _GNU_SOURCE     // recvmmsg() and sendmmsg()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+
+#include "transport.h"
+
+#define terminalColor(color) printf("\033[%dm", color)
+
+#define SOCKETCAN_MAX_BUSSES    4       //!< The maximum number of interfaces.
+#define SOCKETCAN_BATCH         64      //!< The number of frames per recvmmsg() and sendmmsg().
+
+/**
+ * \brief Defines one interface, bus n of the transport.
+ */
+typedef struct {
+    Transport *t;                                   //!< The transport the interface belongs to.
+    int fd;                                         //!< The raw CAN socket.
+    uint8_t bus;                                    //!< The bus number of the interface.
+    char name[IFNAMSIZ];                            //!< The name of the interface.
+} SocketCanBus;
+
+/**
+ * \brief Defines the state of the SocketCAN backend.
+ */
+typedef struct {
+    SocketCanBus busses[SOCKETCAN_MAX_BUSSES];      //!< The interfaces.
+    uint8_t nrBusses;                               //!< The number of interfaces.
+    Reactor *reactor;                               //!< The event loop handling the sockets, NULL if none.
+    struct can_frame tx[SOCKETCAN_BATCH];           //!< The frames of one sendmmsg().
+    struct mmsghdr tx_msgs[SOCKETCAN_BATCH];        //!< The messages of one sendmmsg().
+    struct iovec tx_iov[SOCKETCAN_BATCH];           //!< The buffers of one sendmmsg().
+    struct can_frame rx[SOCKETCAN_BATCH];           //!< The frames of one recvmmsg().
+    struct mmsghdr rx_msgs[SOCKETCAN_BATCH];        //!< The messages of one recvmmsg().
+    struct iovec rx_iov[SOCKETCAN_BATCH];           //!< The buffers of one recvmmsg().
+} SocketCan;
+
+static uint64_t socketcan_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static int socketcan_bind(SocketCanBus *b) {
+    struct sockaddr_can addr;
+    unsigned int index = if_nametoindex(b->name);
+
+    if(index == 0)
+        return -1;
+
+    b->fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if(b->fd < 0)
+        return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = index;
+
+    return bind(b->fd, (struct sockaddr*)&addr, sizeof(addr));
+}
+
+static void socketcan_close(Transport *t) {
+    SocketCan *s = t->backend;
+
+    for(int i = 0; i < s->nrBusses; i++) {
+        if(s->reactor != NULL)
+            reactor_remove(s->reactor, s->busses[i].fd);
+        if(s->busses[i].fd >= 0)
+            close(s->busses[i].fd);
+    }
+    free(s);
+}
+
+static int socketcan_open(Transport *t, const char *args) {
+    SocketCan *s = calloc(1, sizeof(SocketCan));
+    const char *name = args;
+    size_t length;
+
+    if(s == NULL)
+        return -1;
+    t->backend = s;
+
+    while(*name != '\0') {
+        length = strcspn(name, ",");
+        if(s->nrBusses == SOCKETCAN_MAX_BUSSES || length == 0 || length >= IFNAMSIZ)
+            goto error;
+
+        SocketCanBus *b = &s->busses[s->nrBusses++];
+        b->t = t;
+        b->bus = s->nrBusses - 1;
+        memcpy(b->name, name, length);
+        b->fd = -1;
+        if(socketcan_bind(b) < 0) {
+            terminalColor(31);
+            printf("Could not open CAN interface %s\n", b->name);
+            terminalColor(0);
+            goto error;
+        }
+
+        name += length;
+        if(*name == ',')
+            name++;
+    }
+    if(s->nrBusses == 0)
+        goto error;
+
+    for(int i = 0; i < SOCKETCAN_BATCH; i++) {
+        s->tx_iov[i].iov_base = &s->tx[i];
+        s->tx_iov[i].iov_len = sizeof(struct can_frame);
+        s->rx_iov[i].iov_base = &s->rx[i];
+        s->rx_iov[i].iov_len = sizeof(struct can_frame);
+    }
+
+    terminalColor(32);
+    printf("SocketCAN connected (%s)\n", args);
+    terminalColor(0);
+    return 0;
+
+    error:
+    socketcan_close(t);
+    t->backend = NULL;
+    return -1;
+}
+
+static void socketcan_receive(int fd, uint32_t events, void *ctx) {
+    SocketCanBus *b = ctx;
+    Transport *t = b->t;
+    SocketCan *s = t->backend;
+    uint64_t timestamp;
+    CANRxFrame *rx;
+    int n;
+
+    do {
+        for(int i = 0; i < SOCKETCAN_BATCH; i++) {
+            memset(&s->rx_msgs[i].msg_hdr, 0, sizeof(struct msghdr));
+            s->rx_msgs[i].msg_hdr.msg_iov = &s->rx_iov[i];
+            s->rx_msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        n = recvmmsg(fd, s->rx_msgs, SOCKETCAN_BATCH, MSG_DONTWAIT, NULL);
+        if(n < 0) {
+            if(errno != EAGAIN && errno != EINTR)
+                t->stats.rx_errors++;
+            return;
+        }
+        if(t->rx_ring == NULL)
+            continue;
+
+        timestamp = socketcan_now();
+        for(int i = 0; i < n; i++) {
+            struct can_frame *f = &s->rx[i];
+
+            /* Like the Panda, extended, remote and error frames are not supported. */
+            if(f->can_id & (CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_ERR_FLAG) || f->can_dlc > 8) {
+                t->rx_ring->dropped++;
+                continue;
+            }
+
+            rx = canring_claim(t->rx_ring);
+            rx->frame.ID = f->can_id & CAN_SFF_MASK;
+            rx->frame.length = f->can_dlc;
+            rx->frame.bus = b->bus;
+            rx->frame.freq = 0;
+            memcpy(rx->frame.data, f->data, 8);
+            rx->device_time = 0;
+            rx->timestamp_ns = timestamp;
+            transport_rx_publish(t, rx);
+        }
+    } while(n == SOCKETCAN_BATCH);
+}
+
+static int socketcan_add_to_reactor(Transport *t, Reactor *r) {
+    SocketCan *s = t->backend;
+    int ret;
+
+    for(int i = 0; i < s->nrBusses; i++) {
+        ret = reactor_add(r, s->busses[i].fd, EPOLLIN, socketcan_receive, &s->busses[i]);
+        if(ret < 0)
+            return ret;
+    }
+    s->reactor = r;
+
+    return 0;
+}
+
+/* Send the frames of one bus, batched. */
+static int socketcan_flush(Transport *t, SocketCanBus *b, int n) {
+    SocketCan *s = t->backend;
+    int sent = 0;
+    int ret;
+
+    for(int i = 0; i < n; i++) {
+        memset(&s->tx_msgs[i].msg_hdr, 0, sizeof(struct msghdr));
+        s->tx_msgs[i].msg_hdr.msg_iov = &s->tx_iov[i];
+        s->tx_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while(sent < n) {
+        ret = sendmmsg(b->fd, s->tx_msgs + sent, n - sent, MSG_DONTWAIT);
+        if(ret <= 0)
+            break;
+        sent += ret;
+    }
+
+    t->stats.tx_frames += sent;
+    t->stats.tx_dropped += n - sent;
+
+    return (sent == n) ? 0 : -1;
+}
+
+static int socketcan_send(Transport *t, CANFrame frames[], int length) {
+    SocketCan *s = t->backend;
+    uint64_t start = socketcan_now();
+    int64_t duration;
+    int ret = 0;
+    int n;
+
+    /* One batch per bus, in the order the frames were given. */
+    for(int bus = 0; bus < s->nrBusses; bus++) {
+        n = 0;
+        for(int i = 0; i < length; i++) {
+            if(frames[i].bus != bus)
+                continue;
+
+            memset(&s->tx[n], 0, sizeof(struct can_frame));
+            s->tx[n].can_id = frames[i].ID;
+            s->tx[n].can_dlc = frames[i].length;
+            memcpy(s->tx[n].data, frames[i].data, 8);
+
+            if(++n == SOCKETCAN_BATCH) {
+                ret |= socketcan_flush(t, &s->busses[bus], n);
+                n = 0;
+            }
+        }
+        if(n > 0)
+            ret |= socketcan_flush(t, &s->busses[bus], n);
+    }
+
+    for(int i = 0; i < length; i++) {
+        if(frames[i].bus >= s->nrBusses) {
+            t->stats.tx_dropped++;
+            ret = -1;
+        }
+    }
+
+    duration = socketcan_now() - start;
+    latency_record(LATENCY_SUBMIT, duration);
+    if(latency_origin() != 0)
+        latency_record(LATENCY_TOTAL, start + duration - latency_origin());
+    t->stats.sends++;
+    t->stats.sum_send_ns += duration;
+    if(duration > t->stats.max_send_ns)
+        t->stats.max_send_ns = duration;
+
+    return ret;
+}
+
+const TransportOps transport_socketcan = {
+    .name = "socketcan",
+    .open = socketcan_open,
+    .close = socketcan_close,
+    .add_to_reactor = socketcan_add_to_reactor,
+    .send = socketcan_send
+};